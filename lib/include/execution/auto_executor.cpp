@@ -0,0 +1,403 @@
+#include "execution/auto_executor.hpp"
+
+#include "config.hpp"
+#include "execution/executor_builder.hpp"
+#include "model/model_fmu.hpp"
+#include "utils/time.hpp"
+#include "utils/timer.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace ssp4sim::graph
+{
+
+    double AutoExecutor::Trial::throughput() const
+    {
+        if (steps == 0)
+        {
+            return 0.0;
+        }
+        if (walltime_ns == 0)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        return static_cast<double>(steps) / utils::time::ns_to_s(walltime_ns);
+    }
+
+    double AutoExecutor::Trial::mean_residual() const
+    {
+        return steps == 0 ? 0.0 : residual / static_cast<double>(steps);
+    }
+
+    AutoExecutor::AutoExecutor(std::vector<Invocable *> nodes) : ExecutionBase(std::move(nodes))
+    {
+        this->name = "AutoExecutor";
+
+        steps = static_cast<std::size_t>(std::max(1, utils::Config::getOr("simulation.executor.auto.steps", 20)));
+        warmup = static_cast<std::size_t>(std::max(0, utils::Config::getOr("simulation.executor.auto.warmup", 2)));
+        residual_tolerance = utils::Config::getOr("simulation.executor.auto.residual_tolerance", utils::Config::getOr("simulation.tolerance", 1e-4));
+        residual_slack = utils::Config::getOr("simulation.executor.auto.residual_slack", 0.5);
+        cache_file = utils::Config::getOr("simulation.executor.auto.cache", std::string("./result/executor_tuning.json"));
+
+        nlohmann::json candidates;
+        if (auto configured = utils::Config::resolvePath("simulation.executor.auto.candidates"))
+        {
+            candidates = *configured;
+        }
+        else
+        {
+            auto hardware = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+            candidates = nlohmann::json::array({
+                {{"method", "jacobi"}, {"jacobi", {{"parallel", false}}}},
+                {{"method", "jacobi"}, {"jacobi", {{"parallel", true}, {"method", 1}}}},
+                {{"method", "jacobi"}, {"jacobi", {{"parallel", true}, {"method", 3}}}},
+                {{"method", "seidel"}, {"seidel", {{"parallel", false}, {"speculate", false}}}},
+                {{"method", "seidel"}, {"seidel", {{"parallel", true}, {"speculate", false}}}},
+            });
+
+            // Thread counts for the executors with their own workers
+            std::vector<int> workers{2, hardware / 2, hardware};
+            std::sort(workers.begin(), workers.end());
+            workers.erase(std::unique(workers.begin(), workers.end()), workers.end());
+            for (auto w : workers)
+            {
+                if (w < 2)
+                {
+                    continue;
+                }
+                candidates.push_back({{"method", "jacobi"}, {"jacobi", {{"parallel", true}, {"method", 2}}}, {"thread_pool_workers", w}});
+                candidates.push_back({{"method", "jacobi"}, {"jacobi", {{"parallel", true}, {"method", 4}}}, {"thread_pool_workers", w}});
+            }
+        }
+
+        for (auto &candidate : candidates)
+        {
+            // A patch without a method would inherit "auto"
+            if (!candidate.is_object() || candidate.value("method", std::string("auto")) == "auto")
+            {
+                throw std::runtime_error(Logger::format("[AutoExecutor] Every candidate needs a method other than auto, got {}", candidate.dump()));
+            }
+            trials.push_back({candidate});
+        }
+        if (trials.empty())
+        {
+            throw std::runtime_error("[AutoExecutor] No candidates to tune");
+        }
+        decision = trials.size();
+
+        // The key covers the system, the candidates and the machine
+        std::string material;
+        auto ssp = utils::Config::getOr("simulation.ssp", std::string(""));
+        if (!ssp.empty())
+        {
+            std::ifstream in(ssp, std::ios::binary);
+            std::ostringstream content;
+            content << in.rdbuf();
+            material += content.str();
+        }
+        material += utils::Config::getOr("simulation.ssd", std::string("")) + ";";
+        for (auto node : this->nodes)
+        {
+            material += node->name + ";";
+        }
+        material += candidates.dump() + ";" + std::to_string(std::thread::hardware_concurrency());
+        key = Logger::format("{:016x}", hash(material));
+
+        if (load_cache())
+        {
+            log(info)("[{}] Using the cached executor {}", __func__, trials[decision].config.dump());
+        }
+    }
+
+    std::string AutoExecutor::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "AutoExecutor { key: " << key << ", steps: " << steps << ", warmup: " << warmup << "\n";
+        for (std::size_t i = 0; i < trials.size(); i++)
+        {
+            auto &trial = trials[i];
+            oss << (i == decision ? " * " : "   ") << trial.config.dump()
+                << ", steps/s " << trial.throughput()
+                << ", residual " << trial.mean_residual() << "\n";
+        }
+        oss << "}\n";
+        return oss.str();
+    }
+
+    std::size_t AutoExecutor::chosen() const
+    {
+        return decision;
+    }
+
+    uint64_t AutoExecutor::hash(const std::string &data, uint64_t seed)
+    {
+        auto result = seed;
+        for (auto c : data)
+        {
+            result ^= static_cast<unsigned char>(c);
+            result *= 1099511628211ull;
+        }
+        return result;
+    }
+
+    std::size_t AutoExecutor::select(const std::vector<Trial> &trials, double residual_tolerance, double residual_slack)
+    {
+        auto lowest = std::numeric_limits<double>::infinity();
+        for (auto &trial : trials)
+        {
+            if (trial.steps > 0)
+            {
+                lowest = std::min(lowest, trial.mean_residual());
+            }
+        }
+
+        auto limit = std::max(residual_tolerance, (1.0 + residual_slack) * lowest);
+        std::size_t best = 0;
+        double best_throughput = -1.0;
+        for (std::size_t i = 0; i < trials.size(); i++)
+        {
+            auto &trial = trials[i];
+            if (trial.steps > 0 && trial.mean_residual() <= limit && trial.throughput() > best_throughput)
+            {
+                best = i;
+                best_throughput = trial.throughput();
+            }
+        }
+        return best;
+    }
+
+    double AutoExecutor::coupling_residual(const std::vector<Invocable *> &nodes, uint64_t time)
+    {
+        double result = 0.0;
+        for (auto node : nodes)
+        {
+            result = std::max(result, node->coupling_residual(time));
+        }
+        return result;
+    }
+
+    bool AutoExecutor::can_snapshot() const
+    {
+        return std::all_of(nodes.begin(), nodes.end(), [](Invocable *node)
+                           {
+                               auto model = dynamic_cast<FmuModel *>(node);
+                               return model != nullptr && !model->fmu->is_model_exchange() && model->fmu->get_model()->can_save_state(); });
+    }
+
+    std::unique_ptr<ExecutionBase> AutoExecutor::build_candidate(const nlohmann::json &patch)
+    {
+        auto result = ExecutorBuilder().build(nodes, patch);
+
+        // Snapshot trials are repeated, they are not recorded
+        result->set_recorder(snapshots && decision == trials.size() ? nullptr : recorder);
+        return result;
+    }
+
+    void AutoExecutor::measured_step(Trial &trial, const StepData &step, std::size_t trial_step)
+    {
+        auto timer = utils::time::Timer();
+        executor->invoke(step);
+        auto elapsed = timer.stop();
+
+        if (trial_step < warmup)
+        {
+            return;
+        }
+
+        trial.steps += 1;
+        trial.walltime_ns += elapsed;
+        trial.residual += coupling_residual(nodes, step.end_time);
+    }
+
+    void AutoExecutor::tune_from_snapshots(const StepData &step_data)
+    {
+        auto h = step_data.end_time - step_data.start_time;
+
+        // Fmus must not be stepped past the stop time
+        auto total = warmup + steps;
+        auto stop_time = utils::time::s_to_ns(utils::Config::getOr("simulation.stop_time", 0.0));
+        if (stop_time > step_data.start_time)
+        {
+            total = std::min<std::size_t>(total, (stop_time - step_data.start_time) / h);
+        }
+
+        for (auto &trial : trials)
+        {
+            for (auto node : nodes)
+            {
+                if (!node->save_state())
+                {
+                    throw std::runtime_error(Logger::format("[AutoExecutor] Failed to save the state of {}", node->name));
+                }
+            }
+
+            executor = build_candidate(trial.config);
+            auto t = step_data.start_time;
+            for (std::size_t k = 0; k < total; k++, t += h)
+            {
+                measured_step(trial, StepData(t, t + h, h), k);
+            }
+            executor.reset();
+
+            for (auto node : nodes)
+            {
+                if (!node->restore_state())
+                {
+                    throw std::runtime_error(Logger::format("[AutoExecutor] Failed to restore the state of {}", node->name));
+                }
+            }
+        }
+
+        if (recorder)
+        {
+            recorder->discard_new_data();
+        }
+        decide();
+    }
+
+    void AutoExecutor::decide()
+    {
+        decision = select(trials, residual_tolerance, residual_slack);
+        log(info)("[{}] {}", __func__, to_string());
+        store_cache();
+    }
+
+    bool AutoExecutor::load_cache()
+    {
+        if (cache_file.empty())
+        {
+            return false;
+        }
+
+        std::ifstream in(cache_file);
+        if (!in)
+        {
+            return false;
+        }
+
+        auto cache = nlohmann::json::parse(in, nullptr, false);
+        if (!cache.is_object() || !cache.contains(key))
+        {
+            return false;
+        }
+
+        auto &entry = cache[key];
+        for (std::size_t i = 0; i < trials.size(); i++)
+        {
+            if (entry.contains("config") && entry["config"] == trials[i].config)
+            {
+                decision = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void AutoExecutor::store_cache() const
+    {
+        if (cache_file.empty())
+        {
+            return;
+        }
+
+        nlohmann::json cache = nlohmann::json::object();
+        {
+            std::ifstream in(cache_file);
+            if (in)
+            {
+                auto existing = nlohmann::json::parse(in, nullptr, false);
+                if (existing.is_object())
+                {
+                    cache = std::move(existing);
+                }
+            }
+        }
+
+        auto &trial = trials[decision];
+        cache[key] = {{"config", trial.config},
+                      {"throughput", trial.throughput()},
+                      {"residual", trial.mean_residual()}};
+
+        auto path = std::filesystem::path(cache_file);
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path());
+        }
+
+        std::ofstream out(cache_file, std::ios::out);
+        out << cache.dump(4) << '\n';
+        if (!out)
+        {
+            log(warning)("[{}] Failed to write the tuning cache {}", __func__, cache_file);
+        }
+    }
+
+    void AutoExecutor::log_metrics()
+    {
+        log(info)("[{}] {}", __func__, to_string());
+        if (executor)
+        {
+            executor->log_metrics();
+        }
+    }
+
+    void AutoExecutor::use_slack()
+    {
+        if (executor)
+        {
+            executor->use_slack();
+            return;
+        }
+        ExecutionBase::use_slack();
+    }
+
+    uint64_t AutoExecutor::invoke(StepData step_data)
+    {
+        if (decision == trials.size() && !started)
+        {
+            started = true;
+            snapshots = can_snapshot();
+            log(info)("[{}] Tuning {} candidates {}", __func__, trials.size(), snapshots ? "from fmu snapshots" : "on the first steps");
+            if (snapshots)
+            {
+                tune_from_snapshots(step_data);
+            }
+        }
+
+        if (decision < trials.size())
+        {
+            if (!executor)
+            {
+                executor = build_candidate(trials[decision].config);
+            }
+            return executor->invoke(step_data);
+        }
+
+        // Live tuning, the trials are steps of the simulation
+        if (!executor)
+        {
+            executor = build_candidate(trials[current].config);
+        }
+        measured_step(trials[current], step_data, trial_step);
+
+        trial_step += 1;
+        if (trial_step == warmup + steps)
+        {
+            executor.reset();
+            trial_step = 0;
+            current += 1;
+            if (current == trials.size())
+            {
+                decide();
+            }
+        }
+        return step_data.end_time;
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "execution/executor.hpp"
+
+#include "cutecpp/log.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+    /**
+     * @brief Executor that benchmarks candidate executors on the live system and keeps the best
+     *
+     * Every candidate is a patch of the "simulation.executor" config that is applied while the
+     * ExecutorBuilder builds it, such as {"jacobi": {"parallel": true, "method": 2}, "thread_pool_workers": 4}.
+     * A candidate runs warmup + steps macro steps, its throughput and mean coupling residual are
+     * measured. The residual of a step is the largest difference between the real inputs a model
+     * used and the connected outputs at the end of the step, relative to 1 + |output|, see
+     * Invocable::coupling_residual.
+     *
+     * When every node can save its state the candidates run the first steps from the same fmu
+     * snapshot, which is restored after each trial. Otherwise the trials are the first steps of
+     * the simulation, one candidate after the other.
+     *
+     * The fastest candidate whose residual is at most max(residual_tolerance, (1 + residual_slack) * lowest residual)
+     * is kept and the decision is written to a tuning cache keyed by a hash of the ssp, the nodes
+     * and the candidates. A later run with the same key uses the cached decision directly.
+     *
+     * Selected with "simulation.executor.method": "auto" and configured through "simulation.executor.auto":
+     *  - candidates: list of config patches (default serial and parallel jacobi and seidel variants)
+     *  - steps: measured macro steps per candidate (default 20)
+     *  - warmup: unmeasured macro steps before (default 2)
+     *  - residual_tolerance: residual that is always accepted (default simulation.tolerance or 1e-4)
+     *  - residual_slack: accepted share above the lowest residual (default 0.5)
+     *  - cache: tuning cache file, empty disables the cache (default "./result/executor_tuning.json")
+     *
+     * Candidates must complete the step in invoke, the lookahead executor is not supported.
+     */
+    class AutoExecutor final : public ExecutionBase
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.AutoExecutor", LogLevel::info);
+
+        struct Trial
+        {
+            nlohmann::json config;
+
+            uint64_t steps = 0;
+            uint64_t walltime_ns = 0;
+            double residual = 0.0;
+
+            // Measured macro steps per second
+            double throughput() const;
+
+            double mean_residual() const;
+        };
+
+        std::vector<Trial> trials;
+
+        std::size_t steps = 20;
+        std::size_t warmup = 2;
+        double residual_tolerance = 1e-4;
+        double residual_slack = 0.5;
+        std::string cache_file;
+
+        // Key of the system in the tuning cache
+        std::string key;
+
+        AutoExecutor(std::vector<Invocable *> nodes);
+
+        std::string to_string() const;
+
+        // Index of the chosen trial, trials.size() while tuning
+        std::size_t chosen() const;
+
+        void log_metrics() override;
+
+        void use_slack() override;
+
+        uint64_t invoke(StepData step_data) override final;
+
+        // Index of the fastest trial within the accepted residual
+        static std::size_t select(const std::vector<Trial> &trials, double residual_tolerance, double residual_slack);
+
+        // Largest coupling residual of the nodes at time
+        static double coupling_residual(const std::vector<Invocable *> &nodes, uint64_t time);
+
+        // FNV-1a
+        static uint64_t hash(const std::string &data, uint64_t seed = 14695981039346656037ull);
+
+    private:
+        std::unique_ptr<ExecutionBase> executor;
+        std::size_t decision = 0;
+        bool started = false;
+        bool snapshots = false;
+
+        // Trial and step of the live tuning
+        std::size_t current = 0;
+        std::size_t trial_step = 0;
+
+        std::unique_ptr<ExecutionBase> build_candidate(const nlohmann::json &patch);
+
+        // Run one macro step on the current executor and measure it for trial
+        void measured_step(Trial &trial, const StepData &step, std::size_t trial_step);
+
+        // All trials from the same snapshot at the first step
+        void tune_from_snapshots(const StepData &step_data);
+
+        // Every node is a co-simulation fmu that can save its state
+        bool can_snapshot() const;
+
+        void decide();
+
+        bool load_cache();
+
+        void store_cache() const;
+    };
+}
@@ -0,0 +1,173 @@
+#include "execution/coupling_solver.hpp"
+
+#include "utils/linalg.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace ssp4sim::graph
+{
+
+    CouplingSolver::CouplingSolver(std::size_t size) : size(size)
+    {
+    }
+
+    // NewtonSolver ----------------------------
+
+    NewtonSolver::NewtonSolver(std::size_t size, JacobianFunction jacobian_function)
+        : CouplingSolver(size), jacobian_function(std::move(jacobian_function)),
+          jacobian(size * size), pivots(size), delta(size)
+    {
+    }
+
+    void NewtonSolver::start_step()
+    {
+        has_previous = false;
+    }
+
+    bool NewtonSolver::factorize()
+    {
+        std::fill(jacobian.begin(), jacobian.end(), 0.0);
+        jacobian_function(jacobian);
+        jacobian_evaluations += 1;
+
+        for (std::size_t i = 0; i < size; i++)
+        {
+            jacobian[i * size + i] -= 1.0;
+        }
+        factorized = utils::linalg::lu_factor(jacobian, pivots, size);
+        return factorized;
+    }
+
+    void NewtonSolver::update(std::vector<double> &u, const std::vector<double> &g)
+    {
+        double norm = 0.0;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            delta[i] = u[i] - g[i];
+            norm += delta[i] * delta[i];
+        }
+        norm = std::sqrt(norm);
+
+        bool slow = has_previous && norm > reuse_rate * previous_norm;
+        previous_norm = norm;
+        has_previous = true;
+
+        if ((!factorized || slow) && !factorize())
+        {
+            log(warning)("[{}] Singular coupling jacobian, falling back to a fixed point iteration", __func__);
+            u = g;
+            return;
+        }
+
+        utils::linalg::lu_solve(jacobian, pivots, size, delta);
+        for (std::size_t i = 0; i < size; i++)
+        {
+            u[i] += delta[i];
+        }
+    }
+
+    // IqnIlsSolver ----------------------------
+
+    IqnIlsSolver::IqnIlsSolver(std::size_t size)
+        : CouplingSolver(size), previous_r(size), previous_g(size), r(size)
+    {
+    }
+
+    void IqnIlsSolver::start_step()
+    {
+        has_previous = false;
+        step += 1;
+
+        while (!column_step.empty() && step - column_step.back() > static_cast<uint64_t>(reuse_steps))
+        {
+            v.pop_back();
+            w.pop_back();
+            column_step.pop_back();
+        }
+    }
+
+    void IqnIlsSolver::update(std::vector<double> &u, const std::vector<double> &g)
+    {
+        for (std::size_t i = 0; i < size; i++)
+        {
+            r[i] = g[i] - u[i];
+        }
+
+        if (has_previous)
+        {
+            auto &dv = v.emplace_front(size);
+            auto &dw = w.emplace_front(size);
+            for (std::size_t i = 0; i < size; i++)
+            {
+                dv[i] = r[i] - previous_r[i];
+                dw[i] = g[i] - previous_g[i];
+            }
+            column_step.push_front(step);
+
+            if (v.size() > max_columns)
+            {
+                v.pop_back();
+                w.pop_back();
+                column_step.pop_back();
+            }
+        }
+        previous_r = r;
+        previous_g = g;
+        has_previous = true;
+
+        if (v.empty())
+        {
+            for (std::size_t i = 0; i < size; i++)
+            {
+                u[i] += initial_factor * r[i];
+            }
+            return;
+        }
+
+        auto n = v.size();
+        std::vector<double> a(size * n);
+        std::vector<double> b(size);
+        for (std::size_t j = 0; j < n; j++)
+        {
+            std::copy(v[j].begin(), v[j].end(), a.begin() + j * size);
+        }
+        for (std::size_t i = 0; i < size; i++)
+        {
+            b[i] = -r[i];
+        }
+
+        std::vector<double> alpha;
+        utils::linalg::least_squares(a, size, n, b, alpha);
+
+        u = g;
+        for (std::size_t j = 0; j < n; j++)
+        {
+            if (alpha[j] == 0.0)
+            {
+                continue;
+            }
+            for (std::size_t i = 0; i < size; i++)
+            {
+                u[i] += alpha[j] * w[j][i];
+            }
+        }
+    }
+
+    std::unique_ptr<CouplingSolver> make_coupling_solver(const std::string &method,
+                                                         std::size_t size,
+                                                         JacobianFunction jacobian_function)
+    {
+        if (method == "newton")
+        {
+            return std::make_unique<NewtonSolver>(size, std::move(jacobian_function));
+        }
+        else if (method == "iqn_ils")
+        {
+            return std::make_unique<IqnIlsSolver>(size);
+        }
+        throw std::runtime_error(Logger::format("[CouplingSolver] Unknown coupling solver '{}'", method));
+    }
+}
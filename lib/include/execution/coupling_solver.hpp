@@ -0,0 +1,119 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+
+    // dG/du at the last evaluated iterate, row major size x size
+    using JacobianFunction = std::function<void(std::vector<double> &jacobian)>;
+
+    /**
+     * @brief Solver for the coupling of an algebraic loop
+     * The loop is treated as the fixed point problem u = G(u), u are the loop inputs and
+     * G steps the loop with u and evaluates the inputs it produces.
+     * update() computes the next iterate from u and G(u) to drive G(u) - u to zero
+     */
+    class CouplingSolver
+    {
+    public:
+        std::size_t size = 0;
+
+        CouplingSolver(std::size_t size);
+
+        virtual ~CouplingSolver() = default;
+
+        // Called before the first iteration of each step
+        virtual void start_step() {}
+
+        // u <- next iterate, g = G(u)
+        virtual void update(std::vector<double> &u, const std::vector<double> &g) = 0;
+
+        virtual std::string name() const = 0;
+    };
+
+    /**
+     * @brief Newton iteration on G(u) - u = 0
+     * Solves (dG/du - I) du = u - G(u). The jacobian is reused between iterations and steps
+     * until the residual decreases by less than reuse_rate in an iteration
+     */
+    class NewtonSolver final : public CouplingSolver
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.NewtonSolver", LogLevel::info);
+
+        JacobianFunction jacobian_function;
+        double reuse_rate = 0.5;
+
+        uint64_t jacobian_evaluations = 0;
+
+        NewtonSolver(std::size_t size, JacobianFunction jacobian_function);
+
+        void start_step() override;
+
+        void update(std::vector<double> &u, const std::vector<double> &g) override;
+
+        std::string name() const override { return "newton"; }
+
+    private:
+        std::vector<double> jacobian;
+        std::vector<std::size_t> pivots;
+        std::vector<double> delta;
+
+        bool factorized = false;
+        bool has_previous = false;
+        double previous_norm = 0.0;
+
+        bool factorize();
+    };
+
+    /**
+     * @brief Interface quasi-Newton with an inverse jacobian from a least squares fit (IQN-ILS)
+     * The differences of the residuals and of G from previous iterations form the secant
+     * information, the next iterate is u = G(u) + W a where a minimizes |V a + r|.
+     * Columns from the last reuse_steps steps are kept, without any columns the iterate
+     * is relaxed with initial_factor
+     */
+    class IqnIlsSolver final : public CouplingSolver
+    {
+    public:
+        double initial_factor = 0.5;
+        int reuse_steps = 8;
+        std::size_t max_columns = 20;
+
+        IqnIlsSolver(std::size_t size);
+
+        void start_step() override;
+
+        void update(std::vector<double> &u, const std::vector<double> &g) override;
+
+        std::size_t columns() const { return v.size(); }
+
+        std::string name() const override { return "iqn_ils"; }
+
+    private:
+        // Newest first
+        std::deque<std::vector<double>> v; // residual differences
+        std::deque<std::vector<double>> w; // G differences
+        std::deque<uint64_t> column_step;
+
+        std::vector<double> previous_r;
+        std::vector<double> previous_g;
+        std::vector<double> r;
+        bool has_previous = false;
+        uint64_t step = 0;
+    };
+
+    // "newton" or "iqn_ils"
+    std::unique_ptr<CouplingSolver> make_coupling_solver(const std::string &method,
+                                                         std::size_t size,
+                                                         JacobianFunction jacobian_function);
+}
@@ -2,6 +2,8 @@
 
 #include "config.hpp"
 
+#include "utils/task_scheduler.hpp"
+
 #include <cstddef>
 #include <utility>
 
@@ -20,6 +22,7 @@ namespace ssp4sim::graph
         auto recording_enabled = utils::Config::getOr("simulation.recording.wait_for", false);
         wait_for_recorder = recording_enabled && utils::Config::getOr("simulation.recording.wait_for", false);
         sub_step = utils::time::s_to_ns(utils::Config::getOr("simulation.executor.sub_step", utils::Config::getDouble("simulation.timestep")));
+        parallel_init = utils::Config::getOr("simulation.executor.parallel_init", false);
     }
 
     void ExecutionBase::set_recorder(signal::DataRecorder *dr)
@@ -29,18 +32,63 @@ namespace ssp4sim::graph
 
     void ExecutionBase::wait_for_result_collection()
     {
-        if (wait_for_recorder && recorder)
+        if (recorder)
         {
-            recorder->wait_until_done();
+            recorder->update();
+            if (wait_for_recorder)
+            {
+                recorder->wait_until_done();
+            }
         }
     }
 
-    void ExecutionBase::init()
+    void ExecutionBase::use_slack()
+    {
+        if (recorder)
+        {
+            recorder->flush();
+        }
+    }
+
+    void ExecutionBase::enter_init()
+    {
+        auto enter = [this](std::size_t i)
+        { nodes[i]->enter_init(); };
+
+        if (parallel_init)
+        {
+            utils::TaskScheduler::instance().parallel_for(nodes.size(), enter);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < nodes.size(); i++)
+            {
+                enter(i);
+            }
+        }
+    }
+
+    void ExecutionBase::exit_init()
     {
-        for (auto &model : this->nodes)
+        auto leave = [this](std::size_t i)
+        { nodes[i]->exit_init(); };
+
+        if (parallel_init)
+        {
+            utils::TaskScheduler::instance().parallel_for(nodes.size(), leave);
+        }
+        else
         {
-            model->enter_init();
+            for (std::size_t i = 0; i < nodes.size(); i++)
+            {
+                leave(i);
+            }
         }
+    }
+
+    void ExecutionBase::init()
+    {
+        enter_init();
 
         log(warning)("[{}] TODO: Implement direct feedthrough", __func__);
 
@@ -48,10 +96,7 @@ namespace ssp4sim::graph
         // Doing direct feedthrough for all variables will overwrite inputs with outputs that are unset
         // It should only be done for the relevant algebraic loops. Nothing else!
 
-        for (auto &model : this->nodes)
-        {
-            model->exit_init();
-        }
+        exit_init();
     }
 
 }
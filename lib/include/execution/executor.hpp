@@ -24,14 +24,29 @@ namespace ssp4sim::graph
 
         uint64_t sub_step = 0;
 
+        // Enter and exit initialization of the nodes as tasks on the shared scheduler
+        bool parallel_init = false;
+
         ExecutionBase(std::vector<Invocable *> nodes);
 
         void set_recorder(signal::DataRecorder *dr);
 
         void wait_for_result_collection();
 
+        // enter_init and exit_init of the executor, with the direct feedthrough step in between
         void init() override;
 
+        // Enter or exit initialization of all nodes
+        void enter_init() override;
+
+        void exit_init() override;
+
+        // Called when the simulation has completed, executors with runtime metrics log them here
+        virtual void log_metrics() {}
+
+        // Background work in the slack before a real-time deadline, writes the recorded data by default
+        virtual void use_slack();
+
         std::string to_string() const
         {
             return this->name + ":\n{}\n";
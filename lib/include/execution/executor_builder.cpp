@@ -2,15 +2,21 @@
 #include "config.hpp"
 #include "execution/executor_builder.hpp"
 
-#include "execution/custom_executors.hpp"
+#include "execution/auto_executor.hpp"
+#include "execution/grouped_executor.hpp"
+#include "execution/lookahead_executor.hpp"
+#include "execution/scc_executor.hpp"
 
-#include "execution/jacobi/jacobi_parallel_fut.hpp"
+#include "execution/jacobi/jacobi_parallel_balanced.hpp"
+#include "execution/jacobi/jacobi_parallel_pinned.hpp"
 #include "execution/jacobi/jacobi_parallel_spin.hpp"
+#include "execution/jacobi/jacobi_parallel_tasks.hpp"
 #include "execution/jacobi/jacobi_parallel_tbb.hpp"
 #include "execution/jacobi/jacobi_serial.hpp"
 
 #include "execution/seidel/seidel_serial.hpp"
 #include "execution/seidel/seidel_parallel.hpp"
+#include "execution/seidel/seidel_speculative.hpp"
 
 #include <memory>
 #include <stdexcept>
@@ -48,8 +54,18 @@ namespace ssp4sim::graph
                 }
                 else if (parallel_method == 3)
                 {
-                    log(info)("[{}] Executor: JacobiParallelFutures", __func__);
-                    return std::make_unique<JacobiParallelFutures>(nodes, workers);
+                    log(info)("[{}] Executor: JacobiParallelTasks", __func__);
+                    return std::make_unique<JacobiParallelTasks>(nodes);
+                }
+                else if (parallel_method == 4)
+                {
+                    log(info)("[{}] Executor: JacobiParallelBalanced", __func__);
+                    return std::make_unique<JacobiParallelBalanced>(nodes, workers);
+                }
+                else if (parallel_method == 5)
+                {
+                    log(info)("[{}] Executor: JacobiParallelPinned", __func__);
+                    return std::make_unique<JacobiParallelPinned>(nodes);
                 }
                 else
                 {
@@ -64,7 +80,12 @@ namespace ssp4sim::graph
         }
         else if (executor_method == "seidel")
         {
-            if (utils::Config::getOr("simulation.executor.seidel.parallel", false))
+            if (utils::Config::getOr("simulation.executor.seidel.speculate", false))
+            {
+                log(info)("[{}] Executor: SpeculativeSeidel", __func__);
+                return std::make_unique<SpeculativeSeidel>(nodes);
+            }
+            else if (utils::Config::getOr("simulation.executor.seidel.parallel", false))
             {
                 log(info)("[{}] Executor: ParallelSeidel", __func__);
                 return std::make_unique<ParallelSeidel>(nodes);
@@ -75,18 +96,66 @@ namespace ssp4sim::graph
                 return std::make_unique<SerialSeidel>(nodes);
             }
         }
-        else if (executor_method == "custom_delay")
+        else if (executor_method == "scc")
+        {
+            log(info)("[{}] Executor: SccExecutor", __func__);
+            return std::make_unique<SccExecutor>(nodes);
+        }
+        else if (executor_method == "iterative")
+        {
+            log(info)("[{}] Executor: SccExecutor with aitken relaxation", __func__);
+            return std::make_unique<SccExecutor>(nodes, "aitken");
+        }
+        else if (executor_method == "lookahead")
         {
-            log(info)("[{}] Executor: DelayExecutor", __func__);
-            return std::make_unique<DelayExecutor>(nodes);
+            log(info)("[{}] Executor: LookaheadExecutor", __func__);
+            return std::make_unique<LookaheadExecutor>(nodes);
         }
-        else if (executor_method == "custom_delay_partial")
+        else if (executor_method == "grouped")
         {
-            log(info)("[{}] Executor: DelayExecutorPartial", __func__);
-            return std::make_unique<DelayExecutorPartial>(nodes);
+            log(info)("[{}] Executor: GroupedExecutor", __func__);
+            return std::make_unique<GroupedExecutor>(nodes);
+        }
+        else if (executor_method == "auto")
+        {
+            log(info)("[{}] Executor: AutoExecutor", __func__);
+            return std::make_unique<AutoExecutor>(nodes);
         }
 
         throw std::runtime_error("Unknown executor method");
     }
 
+    std::unique_ptr<ExecutionBase> ExecutorBuilder::build(std::vector<Invocable *> nodes, const nlohmann::json &patch)
+    {
+        auto &simulation = utils::Config::data_["simulation"];
+        auto existed = simulation.contains("executor");
+        auto original = existed ? simulation["executor"] : nlohmann::json::object();
+
+        auto restore = [&]()
+        {
+            if (existed)
+            {
+                simulation["executor"] = original;
+            }
+            else
+            {
+                simulation.erase("executor");
+            }
+        };
+
+        simulation["executor"].merge_patch(patch);
+        std::unique_ptr<ExecutionBase> result;
+        try
+        {
+            result = build(std::move(nodes));
+        }
+        catch (...)
+        {
+            restore();
+            throw;
+        }
+        restore();
+        return result;
+    }
+
 }
@@ -6,6 +6,8 @@
 
 #include "cutecpp/log.hpp"
 
+#include <nlohmann/json.hpp>
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -23,6 +25,10 @@ namespace ssp4sim::graph
         std::string to_string() const override;
 
         std::unique_ptr<ExecutionBase> build(std::vector<Invocable *> nodes);
+
+        // Build with patch merged into "simulation.executor", the config is restored afterwards.
+        // The global config is modified meanwhile, never call it while other threads read the config
+        std::unique_ptr<ExecutionBase> build(std::vector<Invocable *> nodes, const nlohmann::json &patch);
     };
 
 }
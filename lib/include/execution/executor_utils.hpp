@@ -4,16 +4,32 @@
 
 #include "invocable.hpp"
 
+#include "model/model_fmu.hpp"
+
+#include <algorithm>
+
 namespace ssp4sim::graph
 {
 
     // continuous input will allow the substep to sample new data during the substep
     inline void invoke_sub_step(Invocable *node, const StepData &step_data, bool continuous_input = false)
     {
+        if (!continuous_input && node->delay == 0 && node->step_size == 0 && step_data.input_time <= node->current_time)
+        {
+            // Held inputs, one input round trip for the whole step. Quiescent models skip steps instead
+            auto model = dynamic_cast<FmuModel *>(node);
+            if (model != nullptr && model->collapse_sub_steps && !model->activity.enabled)
+            {
+                model->step_held(StepData(node->current_time, step_data.end_time, step_data.timestep, step_data.input_time, step_data.end_time),
+                                 step_data.timestep);
+                return;
+            }
+        }
+
         while (node->current_time < step_data.end_time)
         {
             auto substep_start = node->current_time;
-            auto substep_end = node->current_time + step_data.timestep;
+            auto substep_end = std::min(node->current_time + step_data.timestep, step_data.end_time);
 
             auto output_time = substep_end;
             if (node->delay == 0)
@@ -0,0 +1,205 @@
+#include "execution/grouped_executor.hpp"
+
+#include "executor_utils.hpp"
+
+#include "config.hpp"
+
+#include "utils/task_scheduler.hpp"
+#include "utils/time.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace ssp4sim::graph
+{
+
+    GroupedExecutor::GroupedExecutor(std::vector<Invocable *> nodes) : ExecutionBase(std::move(nodes))
+    {
+        this->name = "GroupedExecutor";
+
+        auto timestep = utils::time::s_to_ns(utils::Config::getDouble("simulation.timestep"));
+        parallel = utils::Config::getOr("simulation.executor.grouped.parallel", false);
+
+        std::map<std::string, Invocable *> by_name;
+        for (auto &node : this->nodes)
+        {
+            by_name[node->name] = node;
+        }
+
+        auto config = utils::Config::resolvePath("simulation.executor.grouped.groups");
+        if (config == nullptr || !config->is_array())
+        {
+            throw std::runtime_error("[GroupedExecutor] simulation.executor.grouped.groups must be a list of groups");
+        }
+
+        for (auto &g : *config)
+        {
+            Group group;
+            group.name = g.value("name", Logger::format("group{}", groups.size()));
+
+            auto order = g.value("order", std::string("seidel"));
+            if (order == "seidel")
+            {
+                group.order = Order::seidel;
+            }
+            else if (order == "jacobi")
+            {
+                group.order = Order::jacobi;
+            }
+            else
+            {
+                throw std::runtime_error(Logger::format("[GroupedExecutor] Unknown order '{}' in group {}", order, group.name));
+            }
+
+            group.offset = utils::time::s_to_ns(g.value("offset", 0.0));
+            group.window = g.contains("window") ? utils::time::s_to_ns(g["window"].get<double>()) : timestep;
+
+            for (auto &node_name : g.at("nodes").get<std::vector<std::string>>())
+            {
+                auto it = by_name.find(node_name);
+                if (it == by_name.end())
+                {
+                    throw std::runtime_error(Logger::format("[GroupedExecutor] Node {} in group {} not found", node_name, group.name));
+                }
+                if (it->second == nullptr)
+                {
+                    throw std::runtime_error(Logger::format("[GroupedExecutor] Node {} is listed in more than one group", node_name));
+                }
+                group.nodes.push_back(it->second);
+                it->second = nullptr;
+            }
+
+            groups.push_back(std::move(group));
+        }
+
+        Group rest;
+        rest.name = "ungrouped";
+        rest.order = Order::jacobi;
+        rest.window = timestep;
+        for (auto &node : this->nodes)
+        {
+            if (by_name[node->name] != nullptr)
+            {
+                log(warning)("[{}] {} is not part of any group, it is invoked in the ungrouped jacobi group", __func__, node->name);
+                rest.nodes.push_back(node);
+            }
+        }
+        if (!rest.nodes.empty())
+        {
+            groups.push_back(std::move(rest));
+        }
+
+        window = timestep;
+        for (auto &group : groups)
+        {
+            if (group.window == 0 || timestep % group.window != 0)
+            {
+                throw std::runtime_error(Logger::format("[GroupedExecutor] The window of group {} must divide the timestep", group.name));
+            }
+            window = std::min(window, group.window);
+        }
+        for (auto &group : groups)
+        {
+            if (group.window % window != 0)
+            {
+                throw std::runtime_error(Logger::format("[GroupedExecutor] The window of group {} must be a multiple of the smallest window", group.name));
+            }
+        }
+
+        ready.reserve(groups.size());
+        log(info)("[{}] {}", __func__, to_string());
+    }
+
+    std::string GroupedExecutor::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "GroupedExecutor { parallel: " << parallel << ", sub_step: " << sub_step << "\n";
+        for (auto &group : groups)
+        {
+            oss << "  " << group.name
+                << " (" << (group.order == Order::seidel ? "seidel" : "jacobi")
+                << ", offset " << group.offset
+                << ", window " << group.window << "):";
+            for (auto &node : group.nodes)
+            {
+                oss << " " << node->name;
+            }
+            oss << "\n";
+        }
+        oss << "}\n";
+        return oss.str();
+    }
+
+    void GroupedExecutor::invoke_group(Group &group, uint64_t window_start, uint64_t window_end)
+    {
+        auto start = window_start + group.offset;
+        auto end = window_end + group.offset;
+
+        for (auto &node : group.nodes)
+        {
+            if (group.order == Order::seidel)
+            {
+                // Sample the previous nodes of the group during the window
+                invoke_sub_step(node, StepData(start, end, sub_step, end, end), true);
+            }
+            else
+            {
+                invoke_sub_step(node, StepData(start, end, sub_step, start, end));
+            }
+        }
+    }
+
+    uint64_t GroupedExecutor::invoke(StepData step_data)
+    {
+        IF_LOG({
+            log(debug)("[{}] {} stepdata: {}", __func__, name, step_data.to_string());
+        });
+
+        // Steps that are not a multiple of the window (adaptive stepping) run every group once
+        bool whole_step = (step_data.end_time - step_data.start_time) % window != 0;
+        auto loop_window = whole_step ? step_data.end_time - step_data.start_time : window;
+
+        for (auto window_end = step_data.start_time + loop_window; window_end <= step_data.end_time; window_end += loop_window)
+        {
+            ready.clear();
+            for (auto &group : groups)
+            {
+                if (whole_step || (window_end - step_data.start_time) % group.window == 0)
+                {
+                    ready.push_back(&group);
+                }
+            }
+
+            auto run = [&](Group *group)
+            {
+                auto window_start = whole_step ? step_data.start_time : window_end - group->window;
+                invoke_group(*group, window_start, window_end);
+            };
+
+            if (parallel && ready.size() > 1)
+            {
+                auto body = [&](std::size_t i)
+                { run(ready[i]); };
+
+                // Rethrows the first exception thrown by a group
+                utils::TaskScheduler::instance().parallel_for(ready.size(), body);
+            }
+            else
+            {
+                for (auto group : ready)
+                {
+                    run(group);
+                }
+            }
+        }
+
+        wait_for_result_collection();
+
+        return step_data.end_time;
+    }
+}
@@ -52,6 +52,46 @@ namespace ssp4sim::graph
         exit_init();
     }
 
+    bool Invocable::save_state()
+    {
+        return false;
+    }
+
+    bool Invocable::restore_state()
+    {
+        return false;
+    }
+
+    bool Invocable::save_snapshot(std::vector<std::byte> &)
+    {
+        return false;
+    }
+
+    bool Invocable::load_snapshot(const std::vector<std::byte> &)
+    {
+        return false;
+    }
+
+    std::size_t Invocable::input_values() const
+    {
+        return 0;
+    }
+
+    bool Invocable::fetch_input_values(uint64_t, double *)
+    {
+        return true;
+    }
+
+    uint64_t Invocable::step_with_inputs(StepData step_data, const double *)
+    {
+        return invoke(step_data);
+    }
+
+    double Invocable::coupling_residual(uint64_t) const
+    {
+        return 0.0;
+    }
+
     std::string Invocable::to_string() const
     {
         return "Invocable:\n{}\n";
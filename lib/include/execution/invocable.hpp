@@ -4,8 +4,10 @@
 
 #include "utils/node.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 // Rename to execution
 namespace ssp4sim::graph
@@ -56,6 +58,9 @@ namespace ssp4sim::graph
         TemporalType temporal_type = TemporalType::Algebraic;
         uint64_t delay = 0;
 
+        // Communication step of the node, 0 follows the macro step
+        uint64_t step_size = 0;
+
         uint64_t current_time = 0;
 
         virtual void enter_init();
@@ -66,6 +71,38 @@ namespace ssp4sim::graph
 
         virtual uint64_t invoke(StepData data) = 0;
 
+        // Rollback for iterating executors, nodes that can not save their state return false
+        virtual bool save_state();
+
+        // Returns to the last saved state, the next invoke repeats the step
+        virtual bool restore_state();
+
+        /**
+         * Snapshot of the state owned by the caller, it can be loaded into another instance of
+         * the node such as a replica of the system. Nodes without snapshots return false
+         */
+        virtual bool save_snapshot(std::vector<std::byte> &snapshot);
+
+        // Continue from a snapshot at its time, the outputs are posted
+        virtual bool load_snapshot(const std::vector<std::byte> &snapshot);
+
+        /**
+         * Real inputs as values, for executors that solve for the inputs of a loop or step on
+         * predicted inputs. Nodes without real inputs have none
+         */
+        virtual std::size_t input_values() const;
+
+        // Fetch the inputs valid at input_time from the producers and copy the real ones to values.
+        // Returns false if the other inputs differ from the ones of the last step_with_inputs
+        virtual bool fetch_input_values(uint64_t input_time, double *values);
+
+        // invoke with values as the real inputs and the other inputs as last fetched or held
+        virtual uint64_t step_with_inputs(StepData step_data, const double *values);
+
+        // Largest |used - source| / (1 + |source|) of the real inputs of the last step against
+        // the connected outputs valid at time, 0 for nodes that do not know their inputs
+        virtual double coupling_residual(uint64_t time) const;
+
         std::string to_string() const override;
     };
 }
@@ -0,0 +1,294 @@
+#include "execution/jacobi/jacobi_parallel_balanced.hpp"
+
+#include "config.hpp"
+
+#include "utils/time.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace ssp4sim::graph
+{
+
+    JacobiParallelBalanced::JacobiParallelBalanced(std::vector<Invocable *> nodes, int threads)
+        : ExecutionBase(std::move(nodes))
+    {
+        this->name = "JacobiParallelBalanced";
+
+        smoothing = utils::Config::getOr("simulation.executor.jacobi.balanced.smoothing", 0.2);
+        drift = utils::Config::getOr("simulation.executor.jacobi.balanced.drift", 0.25);
+        check_interval = static_cast<uint64_t>(utils::Config::getOr("simulation.executor.jacobi.balanced.check_interval", 16));
+
+        if (threads < 1 || check_interval == 0)
+        {
+            throw std::runtime_error("[JacobiParallelBalanced] workers and check_interval must be at least 1");
+        }
+
+        auto n = this->nodes.size();
+        auto workers = std::min(static_cast<std::size_t>(threads), std::max<std::size_t>(n, 1));
+
+        // Equal costs until the first step has been measured
+        costs.assign(n, 1.0);
+        step_costs.assign(n, 0);
+        assigned_costs = costs;
+        assignment = assign(costs, workers, {});
+
+        buckets.resize(workers);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            buckets[assignment[i]].push_back(this->nodes[i]);
+        }
+
+        // The calling thread runs bucket 0
+        for (std::size_t b = 1; b < workers; b++)
+        {
+            this->threads.emplace_back([this, b]()
+                                       { worker(b); });
+        }
+
+        log(info)("[{}] JacobiParallelBalanced, workers {}", __func__, workers);
+    }
+
+    JacobiParallelBalanced::~JacobiParallelBalanced()
+    {
+        terminate.store(true, std::memory_order_release);
+        generation.fetch_add(1, std::memory_order_acq_rel);
+        generation.notify_all();
+
+        for (auto &thread : threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+    }
+
+    std::string JacobiParallelBalanced::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "JacobiParallelBalanced { workers: " << buckets.size() << ", rebalances: " << rebalances << "\n";
+        for (std::size_t b = 0; b < buckets.size(); b++)
+        {
+            double load = 0.0;
+            oss << "  Worker " << b << ":";
+            for (auto node : buckets[b])
+            {
+                oss << " " << node->name;
+                load += costs[node->id];
+            }
+            oss << " (" << utils::time::ns_to_s(static_cast<uint64_t>(load)) << "s)\n";
+        }
+        oss << "}\n";
+        return oss.str();
+    }
+
+    std::vector<std::size_t> JacobiParallelBalanced::assign(const std::vector<double> &costs,
+                                                            std::size_t workers,
+                                                            const std::vector<std::size_t> &previous)
+    {
+        auto n = costs.size();
+        std::vector<std::size_t> result(n, 0);
+        if (workers <= 1 || n == 0)
+        {
+            return result;
+        }
+
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+                         { return costs[a] > costs[b]; });
+
+        auto share = std::accumulate(costs.begin(), costs.end(), 0.0) / static_cast<double>(workers);
+
+        std::vector<double> load(workers, 0.0);
+        std::vector<bool> pinned(workers, false);
+        std::vector<bool> placed(n, false);
+
+        // Heavy nodes first, on their previous worker if no other heavy node has taken it
+        std::size_t heavy = 0;
+        for (auto i : order)
+        {
+            if (costs[i] < share || heavy + 1 >= workers)
+            {
+                break;
+            }
+            heavy += 1;
+
+            std::size_t worker = workers;
+            if (i < previous.size() && previous[i] < workers && !pinned[previous[i]])
+            {
+                worker = previous[i];
+            }
+            else
+            {
+                for (std::size_t w = 0; w < workers; w++)
+                {
+                    if (!pinned[w])
+                    {
+                        worker = w;
+                        break;
+                    }
+                }
+            }
+
+            pinned[worker] = true;
+            load[worker] += costs[i];
+            result[i] = worker;
+            placed[i] = true;
+        }
+
+        // Remaining nodes on the least loaded worker without a heavy node
+        for (auto i : order)
+        {
+            if (placed[i])
+            {
+                continue;
+            }
+
+            std::size_t best = workers;
+            for (std::size_t w = 0; w < workers; w++)
+            {
+                if (!pinned[w] && (best == workers || load[w] < load[best]))
+                {
+                    best = w;
+                }
+            }
+            load[best] += costs[i];
+            result[i] = best;
+        }
+        return result;
+    }
+
+    void JacobiParallelBalanced::run_bucket(std::size_t bucket)
+    {
+        for (auto node : buckets[bucket])
+        {
+            auto start = std::chrono::steady_clock::now();
+            try
+            {
+                node->invoke(step);
+            }
+            catch (...)
+            {
+                std::scoped_lock lock(exception_mutex);
+                if (!exception)
+                {
+                    exception = std::current_exception();
+                }
+            }
+            step_costs[node->id] = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    void JacobiParallelBalanced::worker(std::size_t bucket)
+    {
+        uint64_t seen = 0;
+        while (true)
+        {
+            generation.wait(seen, std::memory_order_acquire);
+            seen = generation.load(std::memory_order_acquire);
+            if (terminate.load(std::memory_order_acquire))
+            {
+                return;
+            }
+
+            run_bucket(bucket);
+
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                remaining.notify_one();
+            }
+        }
+    }
+
+    void JacobiParallelBalanced::update_costs()
+    {
+        for (std::size_t i = 0; i < costs.size(); i++)
+        {
+            auto measured = static_cast<double>(step_costs[i]);
+            costs[i] = steps == 1 ? measured : smoothing * measured + (1.0 - smoothing) * costs[i];
+        }
+    }
+
+    void JacobiParallelBalanced::rebalance()
+    {
+        bool drifted = steps == 1;
+        for (std::size_t i = 0; i < costs.size() && !drifted; i++)
+        {
+            auto reference = std::max(assigned_costs[i], 1.0);
+            drifted = std::abs(costs[i] - assigned_costs[i]) > drift * reference;
+        }
+        if (!drifted)
+        {
+            return;
+        }
+
+        auto next = assign(costs, buckets.size(), assignment);
+        assigned_costs = costs;
+        if (next == assignment)
+        {
+            return;
+        }
+
+        assignment = std::move(next);
+        for (auto &bucket : buckets)
+        {
+            bucket.clear();
+        }
+        for (std::size_t i = 0; i < nodes.size(); i++)
+        {
+            buckets[assignment[i]].push_back(nodes[i]);
+        }
+        rebalances += 1;
+
+        IF_LOG({
+            log(debug)("[{}] {}", __func__, to_string());
+        });
+    }
+
+    uint64_t JacobiParallelBalanced::invoke(StepData step_data)
+    {
+        IF_LOG({
+            log(debug)("[{}] stepdata: {}", __func__, step_data.to_string());
+        });
+
+        step = StepData(step_data.start_time, step_data.end_time, step_data.timestep);
+        step.timestep = sub_step;
+
+        if (!threads.empty())
+        {
+            remaining.store(threads.size(), std::memory_order_release);
+            generation.fetch_add(1, std::memory_order_acq_rel);
+            generation.notify_all();
+        }
+
+        run_bucket(0);
+
+        for (auto left = remaining.load(std::memory_order_acquire); left != 0; left = remaining.load(std::memory_order_acquire))
+        {
+            remaining.wait(left, std::memory_order_acquire);
+        }
+
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+
+        steps += 1;
+        update_costs();
+        if (steps == 1 || steps % check_interval == 0)
+        {
+            rebalance();
+        }
+
+        wait_for_result_collection();
+
+        return step_data.end_time;
+    }
+}
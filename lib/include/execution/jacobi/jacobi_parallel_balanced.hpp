@@ -0,0 +1,93 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include "execution/jacobi/jacobi_base.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+    /**
+     * @brief Parallel Jacobi with a cost model driven static assignment of nodes to workers
+     *
+     * The step cost of each node is tracked as an exponential moving average. Nodes are assigned
+     * to workers longest-processing-time-first, heavy nodes, that alone fill the ideal share of a
+     * worker, get a worker of their own and keep it between assignments. The assignment is redone
+     * when the average of a node drifts from the value it was assigned with.
+     * The calling thread runs the first bucket, the other buckets run on persistent workers.
+     *
+     * Configured through "simulation.executor.jacobi.balanced":
+     *  - smoothing: weight of the latest step in the moving average (default 0.2)
+     *  - drift: relative change of a node cost that triggers a new assignment (default 0.25)
+     *  - check_interval: steps between drift checks (default 16)
+     */
+    class JacobiParallelBalanced final : public ExecutionBase
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.JacobiParallelBalanced", LogLevel::info);
+
+        double smoothing = 0.2;
+        double drift = 0.25;
+        uint64_t check_interval = 16;
+
+        // Moving average step cost of each node in ns
+        std::vector<double> costs;
+
+        // Worker of each node and the nodes of each worker
+        std::vector<std::size_t> assignment;
+        std::vector<std::vector<Invocable *>> buckets;
+
+        uint64_t rebalances = 0;
+
+        JacobiParallelBalanced(std::vector<Invocable *> nodes, int threads);
+
+        ~JacobiParallelBalanced() override;
+
+        std::string to_string() const override;
+
+        /**
+         * Longest-processing-time-first assignment of costs to workers. Nodes whose cost
+         * is at least the ideal share of a worker keep their previous worker when it is free.
+         * Returns the worker of each node
+         */
+        static std::vector<std::size_t> assign(const std::vector<double> &costs,
+                                               std::size_t workers,
+                                               const std::vector<std::size_t> &previous);
+
+        // hot path
+        uint64_t invoke(StepData step_data) override final;
+
+    private:
+        std::vector<std::thread> threads;
+
+        // Costs the current assignment was made with
+        std::vector<double> assigned_costs;
+        // Cost of the last step of each node, written by the worker running it
+        std::vector<uint64_t> step_costs;
+
+        StepData step;
+        std::atomic<uint64_t> generation{0};
+        std::atomic<std::size_t> remaining{0};
+        std::atomic<bool> terminate{false};
+        uint64_t steps = 0;
+
+        std::exception_ptr exception;
+        std::mutex exception_mutex;
+
+        void worker(std::size_t bucket);
+
+        void run_bucket(std::size_t bucket);
+
+        void update_costs();
+
+        void rebalance();
+    };
+}
@@ -0,0 +1,236 @@
+#include "execution/jacobi/jacobi_parallel_pinned.hpp"
+
+#include "config.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ssp4sim::graph
+{
+    namespace
+    {
+        bool set_affinity(std::thread &thread, const std::vector<int> &cpus)
+        {
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (auto cpu : cpus)
+            {
+                CPU_SET(cpu, &set);
+            }
+            return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+            (void)thread;
+            (void)cpus;
+            return false;
+#endif
+        }
+    }
+
+    JacobiParallelPinned::JacobiParallelPinned(std::vector<Invocable *> nodes) : ExecutionBase(std::move(nodes))
+    {
+        this->name = "JacobiParallelPinned";
+
+        std::map<std::string, Invocable *> by_name;
+        for (auto &node : this->nodes)
+        {
+            by_name[node->name] = node;
+        }
+
+        auto config = utils::Config::resolvePath("simulation.executor.jacobi.pinned.workers");
+        if (config != nullptr)
+        {
+            if (!config->is_array())
+            {
+                throw std::runtime_error("[JacobiParallelPinned] simulation.executor.jacobi.pinned.workers must be a list of workers");
+            }
+
+            for (auto &w : *config)
+            {
+                Worker worker;
+                worker.cpus = w.value("cpus", std::vector<int>{});
+                for (auto &node_name : w.at("nodes").get<std::vector<std::string>>())
+                {
+                    auto it = by_name.find(node_name);
+                    if (it == by_name.end() || it->second == nullptr)
+                    {
+                        throw std::runtime_error(Logger::format("[JacobiParallelPinned] Node {} is unknown or listed in more than one worker", node_name));
+                    }
+                    worker.nodes.push_back(it->second);
+                    it->second = nullptr;
+                }
+                workers.push_back(std::move(worker));
+            }
+        }
+
+        std::vector<int> cpus;
+        if (auto cpu_config = utils::Config::resolvePath("simulation.executor.jacobi.pinned.cpus"))
+        {
+            cpus = cpu_config->get<std::vector<int>>();
+        }
+
+        std::size_t next_cpu = 0;
+        for (auto &node : this->nodes)
+        {
+            if (by_name[node->name] == nullptr)
+            {
+                continue;
+            }
+
+            Worker worker;
+            worker.nodes.push_back(node);
+            if (!cpus.empty())
+            {
+                worker.cpus.push_back(cpus[next_cpu++ % cpus.size()]);
+            }
+            workers.push_back(std::move(worker));
+        }
+
+        utils::SpinPolicy policy;
+        policy.spins = static_cast<uint32_t>(utils::Config::getOr("simulation.executor.jacobi.pinned.spin", 4000));
+
+        start_barrier = std::make_unique<utils::SpinBarrier>(workers.size() + 1, policy);
+        end_barrier = std::make_unique<utils::SpinBarrier>(workers.size() + 1, policy);
+
+        threads.reserve(workers.size());
+        for (std::size_t i = 0; i < workers.size(); i++)
+        {
+            threads.emplace_back([this, i]()
+                                 { worker(i); });
+
+            if (!workers[i].cpus.empty() && !set_affinity(threads.back(), workers[i].cpus))
+            {
+                log(warning)("[{}] Unable to pin worker {} to its cpu set", __func__, i);
+            }
+        }
+
+        log(info)("[{}] {}", __func__, to_string());
+    }
+
+    JacobiParallelPinned::~JacobiParallelPinned()
+    {
+        terminate.store(true, std::memory_order_release);
+        start_barrier->arrive_and_wait();
+
+        for (auto &thread : threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+    }
+
+    std::string JacobiParallelPinned::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "JacobiParallelPinned { workers: " << workers.size() << "\n";
+        for (std::size_t i = 0; i < workers.size(); i++)
+        {
+            oss << "  Worker " << i << " cpus [";
+            for (std::size_t c = 0; c < workers[i].cpus.size(); c++)
+            {
+                oss << (c == 0 ? "" : ", ") << workers[i].cpus[c];
+            }
+            oss << "]:";
+            for (auto node : workers[i].nodes)
+            {
+                oss << " " << node->name;
+            }
+            oss << "\n";
+        }
+        oss << "}\n";
+        return oss.str();
+    }
+
+    void JacobiParallelPinned::worker(std::size_t index)
+    {
+        while (true)
+        {
+            start_barrier->arrive_and_wait();
+            if (terminate.load(std::memory_order_acquire))
+            {
+                return;
+            }
+
+            for (auto node : workers[index].nodes)
+            {
+                try
+                {
+                    switch (phase)
+                    {
+                    case Phase::enter_init:
+                        node->enter_init();
+                        break;
+                    case Phase::exit_init:
+                        node->exit_init();
+                        break;
+                    case Phase::step:
+                        node->invoke(step);
+                        break;
+                    }
+                }
+                catch (...)
+                {
+                    std::scoped_lock lock(exception_mutex);
+                    if (!exception)
+                    {
+                        exception = std::current_exception();
+                    }
+                }
+            }
+
+            end_barrier->arrive_and_wait();
+        }
+    }
+
+    void JacobiParallelPinned::run(Phase next)
+    {
+        phase = next;
+
+        start_barrier->arrive_and_wait();
+        end_barrier->arrive_and_wait();
+
+        if (exception)
+        {
+            auto e = exception;
+            exception = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    void JacobiParallelPinned::enter_init()
+    {
+        run(Phase::enter_init);
+    }
+
+    void JacobiParallelPinned::exit_init()
+    {
+        run(Phase::exit_init);
+    }
+
+    uint64_t JacobiParallelPinned::invoke(StepData step_data)
+    {
+        IF_LOG({
+            log(debug)("[{}] stepdata: {}", __func__, step_data.to_string());
+        });
+
+        step = StepData(step_data.start_time, step_data.end_time, step_data.timestep);
+        step.timestep = sub_step;
+
+        run(Phase::step);
+
+        wait_for_result_collection();
+
+        return step_data.end_time;
+    }
+}
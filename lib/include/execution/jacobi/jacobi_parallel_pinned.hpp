@@ -0,0 +1,88 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include "execution/jacobi/jacobi_base.hpp"
+
+#include "utils/spin_wait.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+    /**
+     * @brief Parallel Jacobi on long-lived workers that each own a fixed set of nodes
+     *
+     * A node is always invoked, initialized included, by the same thread so that the
+     * private state of the fmu stays in the caches of one core and thread-local state in
+     * the fmu stays valid. Workers are optionally pinned to a cpu set. Each step passes a
+     * start and an end barrier that spin, yield and then park.
+     *
+     * Configured through "simulation.executor.jacobi.pinned":
+     *  - workers: list of { "nodes": [...], "cpus": [...] }, nodes sharing a worker
+     *  - cpus: cpus handed out round robin to the remaining nodes, each gets a worker of its own
+     *  - spin: barrier spin iterations before yielding (default 4000)
+     */
+    class JacobiParallelPinned final : public ExecutionBase
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.JacobiParallelPinned", LogLevel::info);
+
+        struct Worker
+        {
+            std::vector<Invocable *> nodes;
+            std::vector<int> cpus;
+        };
+
+        std::vector<Worker> workers;
+
+        JacobiParallelPinned(std::vector<Invocable *> nodes);
+
+        ~JacobiParallelPinned() override;
+
+        std::string to_string() const override;
+
+        // Enter and exit initialization on the owning workers, sequenced by ExecutionBase::init
+        void enter_init() override;
+
+        void exit_init() override;
+
+        // hot path
+        uint64_t invoke(StepData step_data) override final;
+
+    private:
+        std::vector<std::thread> threads;
+
+        // Participants are the workers and the calling thread
+        std::unique_ptr<utils::SpinBarrier> start_barrier;
+        std::unique_ptr<utils::SpinBarrier> end_barrier;
+
+        enum class Phase
+        {
+            enter_init,
+            exit_init,
+            step
+        };
+
+        // Written by the calling thread before the start barrier
+        Phase phase = Phase::step;
+        StepData step;
+        std::atomic<bool> terminate{false};
+
+        std::exception_ptr exception;
+        std::mutex exception_mutex;
+
+        void worker(std::size_t index);
+
+        // Run a phase for every node on its worker and wait for completion
+        void run(Phase next);
+    };
+}
@@ -1,12 +1,24 @@
 #include "execution/jacobi/jacobi_parallel_spin.hpp"
 
+#include "config.hpp"
+
 #include "executor_utils.hpp"
 
 namespace ssp4sim::graph
 {
+    namespace
+    {
+        utils::SpinPolicy spin_policy()
+        {
+            utils::SpinPolicy policy;
+            policy.spins = static_cast<uint32_t>(utils::Config::getOr("simulation.executor.jacobi.spin.spins", 4000));
+            policy.yields = static_cast<uint32_t>(utils::Config::getOr("simulation.executor.jacobi.spin.yields", 16));
+            return policy;
+        }
+    }
 
     JacobiParallelSpin::JacobiParallelSpin(std::vector<Invocable *> nodes, int threads)
-        : ExecutionBase(nodes), pool(threads)
+        : ExecutionBase(nodes), pool(threads, nodes.size(), spin_policy())
     {
         log(info)("[{}] JacobiParallelSpin", __func__);
     }
@@ -18,35 +30,19 @@ namespace ssp4sim::graph
         });
 
         auto step = StepData(step_data.start_time, step_data.end_time, step_data.timestep);
+        step.timestep = sub_step;
 
-        pool.ready(static_cast<int>(nodes.size()));
+        pool.ready(nodes.size());
 
         for (auto &node : nodes)
         {
-            auto ti = utils::task_info{node, step};
-            pool.enqueue(ti);
+            pool.enqueue(utils::task_info{node, step});
         }
 
-        IF_LOG({
-            log(info)("[{}] Spinning until all threads are done", __func__);
-        });
-
-        bool all_done = false;
-        while (!all_done)
-        {
-            all_done = true;
-            for (auto &done : pool.dones)
-            {
-                if (!done)
-                {
-                    all_done = false;
-                    break;
-                }
-            }
-        }
+        pool.wait();
 
         IF_LOG({
-            log(info)("[{}] All threads completed", __func__);
+            log(debug)("[{}] All tasks completed", __func__);
         });
 
         wait_for_result_collection();
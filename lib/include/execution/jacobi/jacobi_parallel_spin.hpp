@@ -11,6 +11,16 @@
 
 namespace ssp4sim::graph
 {
+    /**
+     * @brief Parallel Jacobi on a spinning thread pool
+     *
+     * Dispatch and completion of a step go through ThreadPool2, waiting threads spin
+     * before they park. Lowest dispatch latency when the steps of the models are short.
+     *
+     * Configured through "simulation.executor.jacobi.spin":
+     *  - spins: pause iterations before yielding (default 4000)
+     *  - yields: yields before parking (default 16)
+     */
     class JacobiParallelSpin final : public ExecutionBase
     {
     public:
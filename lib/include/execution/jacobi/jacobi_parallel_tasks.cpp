@@ -0,0 +1,32 @@
+#include "execution/jacobi/jacobi_parallel_tasks.hpp"
+
+#include "executor_utils.hpp"
+
+namespace ssp4sim::graph
+{
+    JacobiParallelTasks::JacobiParallelTasks(std::vector<Invocable *> nodes)
+        : ExecutionBase(nodes), scheduler(utils::TaskScheduler::instance())
+    {
+        log(info)("[{}] JacobiParallelTasks, workers {}", __func__, scheduler.size());
+    }
+
+    uint64_t JacobiParallelTasks::invoke(StepData step_data)
+    {
+        IF_LOG({
+            log(debug)("[{}] stepdata: {}", __func__, step_data.to_string());
+        });
+
+        auto step = StepData(step_data.start_time, step_data.end_time, step_data.timestep);
+        step.timestep = sub_step;
+
+        auto body = [&](std::size_t i)
+        { nodes[i]->invoke(step); };
+
+        // Rethrows the first exception thrown by a node
+        scheduler.parallel_for(nodes.size(), body);
+
+        wait_for_result_collection();
+
+        return step_data.end_time;
+    }
+}
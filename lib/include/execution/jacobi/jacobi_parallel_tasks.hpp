@@ -0,0 +1,31 @@
+#pragma once
+
+#include "execution/jacobi/jacobi_base.hpp"
+
+#include "utils/task_scheduler.hpp"
+
+#include "cutecpp/log.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+    /**
+     * @brief Parallel Jacobi on the shared work-stealing scheduler
+     * One task per node, the calling thread runs the first node and helps with the rest.
+     */
+    class JacobiParallelTasks final : public ExecutionBase
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.JacobiParallelTasks", LogLevel::info);
+
+        JacobiParallelTasks(std::vector<Invocable *> nodes);
+
+        uint64_t invoke(StepData step_data) override final;
+
+    private:
+        utils::TaskScheduler &scheduler;
+    };
+}
@@ -0,0 +1,310 @@
+#include "execution/lookahead_executor.hpp"
+
+#include "config.hpp"
+
+#include "model/model_fmu.hpp"
+
+#include "utils/time.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace ssp4sim::graph
+{
+
+    LookaheadExecutor::LookaheadExecutor(std::vector<Invocable *> nodes) : ExecutionBase(std::move(nodes))
+    {
+        this->name = "LookaheadExecutor";
+
+        max_lead = static_cast<uint64_t>(utils::Config::getOr("simulation.executor.lookahead.max_lead", 32));
+        if (max_lead == 0)
+        {
+            throw std::runtime_error("[LookaheadExecutor] max_lead must be at least 1");
+        }
+
+        // A node posts to its storages every step it leads, the areas of the oldest step must
+        // survive until the consumers and the recorder have read them
+        auto macro_step = utils::time::s_to_ns(utils::Config::getDouble("simulation.timestep"));
+        auto capacity = std::numeric_limits<std::size_t>::max();
+        for (auto node : this->nodes)
+        {
+            if (auto model = dynamic_cast<FmuModel *>(node))
+            {
+                uint64_t posts = 1;
+                if (model->step_size != 0 && model->step_size < macro_step)
+                {
+                    posts = (macro_step + model->step_size - 1) / model->step_size;
+                }
+                auto areas = std::min(model->input_area->areas, model->output_area->areas);
+                capacity = std::min(capacity, static_cast<std::size_t>(areas / posts));
+            }
+        }
+
+        if (capacity != std::numeric_limits<std::size_t>::max())
+        {
+            if (capacity < 2)
+            {
+                throw std::runtime_error(Logger::format("[LookaheadExecutor] Storages hold {} macro steps, at least 2 are required", capacity));
+            }
+            if (max_lead > capacity - 1)
+            {
+                log(warning)("[{}] max_lead {} exceeds the storage capacity, limited to {}", __func__, max_lead, capacity - 1);
+                max_lead = capacity - 1;
+            }
+        }
+
+        auto n = this->nodes.size();
+        producers.resize(n);
+        consumers.resize(n);
+
+        std::unordered_map<signal::SignalStorage *, std::size_t> producer_of;
+        for (auto node : this->nodes)
+        {
+            if (auto model = dynamic_cast<FmuModel *>(node))
+            {
+                producer_of[model->output_area.get()] = node->id;
+            }
+        }
+
+        for (auto node : this->nodes)
+        {
+            std::unordered_map<std::size_t, uint64_t> delays;
+            for (auto parent : node->parents)
+            {
+                auto producer = static_cast<Invocable *>(parent)->id;
+                if (producer != node->id)
+                {
+                    // Connections without delay information are treated as direct
+                    delays[producer] = 0;
+                }
+            }
+
+            if (auto model = dynamic_cast<FmuModel *>(node))
+            {
+                std::unordered_map<std::size_t, uint64_t> smallest;
+                for (auto &connection : model->connections)
+                {
+                    auto it = producer_of.find(connection.source_storage);
+                    if (it == producer_of.end() || it->second == node->id)
+                    {
+                        continue;
+                    }
+                    auto [entry, inserted] = smallest.try_emplace(it->second, connection.delay);
+                    if (!inserted)
+                    {
+                        entry->second = std::min(entry->second, connection.delay);
+                    }
+                }
+                for (auto &[producer, delay] : smallest)
+                {
+                    delays[producer] = delay;
+                }
+            }
+
+            for (auto &[producer, delay] : delays)
+            {
+                producers[node->id].push_back({producer, delay});
+                consumers[producer].push_back(node->id);
+            }
+        }
+
+        progress = std::make_unique<std::atomic<uint64_t>[]>(n);
+
+        log(info)("[{}] {}", __func__, to_string());
+    }
+
+    LookaheadExecutor::~LookaheadExecutor()
+    {
+        stop.store(true, std::memory_order_release);
+        notify();
+        for (auto &worker : workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+    }
+
+    std::string LookaheadExecutor::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "LookaheadExecutor { nodes: " << nodes.size() << ", max_lead: " << max_lead << "\n";
+        for (auto node : nodes)
+        {
+            oss << "  " << node->name << " <-";
+            for (auto &dependency : producers[node->id])
+            {
+                oss << " " << nodes[dependency.node]->name << " (" << utils::time::ns_to_s(dependency.delay) << "s)";
+            }
+            oss << "\n";
+        }
+        oss << "}\n";
+        return oss.str();
+    }
+
+    uint64_t LookaheadExecutor::progress_of(std::size_t node) const
+    {
+        return progress[node].load(std::memory_order_acquire);
+    }
+
+    void LookaheadExecutor::notify()
+    {
+        epoch.fetch_add(1, std::memory_order_acq_rel);
+        epoch.notify_all();
+    }
+
+    bool LookaheadExecutor::ready(std::size_t node, uint64_t t) const
+    {
+        auto end = t + timestep;
+        if (end > limit.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        for (auto &dependency : producers[node])
+        {
+            // Inputs are sampled at t - delay
+            if (progress[dependency.node].load(std::memory_order_acquire) + dependency.delay < t)
+            {
+                return false;
+            }
+        }
+
+        for (auto consumer : consumers[node])
+        {
+            if (end > progress[consumer].load(std::memory_order_acquire) + max_lead * timestep)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void LookaheadExecutor::worker(std::size_t node)
+    {
+        auto invocable = nodes[node];
+        while (true)
+        {
+            auto observed = epoch.load(std::memory_order_acquire);
+            if (stop.load(std::memory_order_acquire))
+            {
+                return;
+            }
+
+            auto t = progress[node].load(std::memory_order_relaxed);
+            if (!ready(node, t))
+            {
+                epoch.wait(observed, std::memory_order_acquire);
+                continue;
+            }
+
+            try
+            {
+                invocable->invoke(StepData(t, t + timestep, timestep));
+            }
+            catch (...)
+            {
+                {
+                    std::scoped_lock lock(exception_mutex);
+                    if (!exception)
+                    {
+                        exception = std::current_exception();
+                    }
+                }
+                failed.store(true, std::memory_order_release);
+                stop.store(true, std::memory_order_release);
+                notify();
+                return;
+            }
+
+            progress[node].store(t + timestep, std::memory_order_release);
+            notify();
+
+            // Nodes run ahead of invoke, drain the storages before the leading steps wrap them
+            if (recorder)
+            {
+                recorder->update();
+            }
+        }
+    }
+
+    void LookaheadExecutor::start(const StepData &step_data)
+    {
+        timestep = step_data.end_time - step_data.start_time;
+        stop_time = utils::time::s_to_ns(utils::Config::getOr("simulation.stop_time", 0.0));
+        if (stop_time == 0)
+        {
+            stop_time = std::numeric_limits<uint64_t>::max() / 2;
+        }
+
+        for (std::size_t i = 0; i < nodes.size(); i++)
+        {
+            progress[i].store(step_data.start_time, std::memory_order_relaxed);
+        }
+
+        workers.reserve(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); i++)
+        {
+            workers.emplace_back([this, i]()
+                                 { worker(i); });
+        }
+    }
+
+    uint64_t LookaheadExecutor::invoke(StepData step_data)
+    {
+        IF_LOG({
+            log(debug)("[{}] stepdata: {}", __func__, step_data.to_string());
+        });
+
+        if (workers.empty())
+        {
+            start(step_data);
+        }
+        else if (step_data.end_time - step_data.start_time != timestep)
+        {
+            throw std::runtime_error("[LookaheadExecutor] Requires a fixed macro step");
+        }
+
+        // Nodes may run max_lead steps ahead of the graph but never past the stop time
+        auto ahead = std::max(step_data.end_time, std::min(step_data.end_time + max_lead * timestep, stop_time));
+        if (ahead > limit.load(std::memory_order_relaxed))
+        {
+            limit.store(ahead, std::memory_order_release);
+            notify();
+        }
+
+        while (true)
+        {
+            auto observed = epoch.load(std::memory_order_acquire);
+            if (failed.load(std::memory_order_acquire))
+            {
+                std::scoped_lock lock(exception_mutex);
+                std::rethrow_exception(exception);
+            }
+
+            bool done = true;
+            for (std::size_t i = 0; i < nodes.size(); i++)
+            {
+                if (progress[i].load(std::memory_order_acquire) < step_data.end_time)
+                {
+                    done = false;
+                    break;
+                }
+            }
+            if (done)
+            {
+                break;
+            }
+            epoch.wait(observed, std::memory_order_acquire);
+        }
+
+        wait_for_result_collection();
+
+        return step_data.end_time;
+    }
+}
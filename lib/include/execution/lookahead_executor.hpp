@@ -0,0 +1,96 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include "ssp4sim_definitions.hpp"
+
+#include "executor.hpp"
+#include "invocable.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+
+    /**
+     * @brief Conservative parallel executor without step barriers
+     *
+     * Every node runs on its own thread with jacobi semantics and advances as soon as the
+     * inputs of its next step are final. A step [t, t + h] reads its inputs at t - delay, so it is
+     * safe once every producer has completed up to t - delay, where delay is the smallest
+     * information_delay over the connections from that producer. Nodes with delayed inputs can
+     * run ahead of their producers by the delay.
+     *
+     * Producers may lead their slowest consumer by at most max_lead steps, this keeps the samples
+     * a consumer needs in the output buffers. invoke only waits until all nodes have reached the
+     * end of the step, nodes may already be computing the following steps.
+     *
+     * Configured through "simulation.executor.lookahead":
+     *  - max_lead: steps a node may be ahead of the graph and of its consumers (default 32),
+     *    limited to what the smallest model storage holds
+     *
+     * Requires a fixed macro step, the step controller is not supported.
+     */
+    class LookaheadExecutor final : public ExecutionBase
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.LookaheadExecutor", LogLevel::info);
+
+        struct Dependency
+        {
+            std::size_t node;
+            uint64_t delay;
+        };
+
+        // Producers of each node with the smallest delay of their connections
+        std::vector<std::vector<Dependency>> producers;
+        std::vector<std::vector<std::size_t>> consumers;
+
+        uint64_t max_lead = 32;
+
+        LookaheadExecutor(std::vector<Invocable *> nodes);
+
+        ~LookaheadExecutor() override;
+
+        std::string to_string() const override;
+
+        // Time each node has completed
+        uint64_t progress_of(std::size_t node) const;
+
+        // hot path
+        uint64_t invoke(StepData step_data) override final;
+
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> progress;
+
+        // Bumped on every change of progress or limit, waiting threads sleep on it
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<uint64_t> limit{0};
+        std::atomic<bool> stop{false};
+        std::atomic<bool> failed{false};
+
+        std::exception_ptr exception;
+        std::mutex exception_mutex;
+
+        std::vector<std::thread> workers;
+        uint64_t timestep = 0;
+        uint64_t stop_time = 0;
+
+        void start(const StepData &step_data);
+
+        void worker(std::size_t node);
+
+        // The step [t, t + timestep] of node has final inputs and room in the buffers of its consumers
+        bool ready(std::size_t node, uint64_t t) const;
+
+        void notify();
+    };
+}
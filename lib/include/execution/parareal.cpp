@@ -0,0 +1,187 @@
+#include "execution/parareal.hpp"
+
+#include "graph/graph.hpp"
+#include "utils/task_scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace ssp4sim::graph
+{
+    Parareal::Parareal(std::size_t replicas, Propagator coarse, Propagator fine)
+        : replicas(replicas), coarse(std::move(coarse)), fine(std::move(fine))
+    {
+        if (replicas == 0)
+        {
+            throw std::runtime_error("[Parareal] At least one replica is required");
+        }
+    }
+
+    std::vector<uint64_t> Parareal::split(uint64_t start, uint64_t end, std::size_t windows)
+    {
+        if (windows == 0 || end <= start)
+        {
+            throw std::runtime_error("[Parareal] At least one window over a non empty horizon is required");
+        }
+
+        auto length = (end - start + windows - 1) / windows;
+        std::vector<uint64_t> result{start};
+        while (result.back() < end)
+        {
+            result.push_back(std::min(result.back() + length, end));
+        }
+        return result;
+    }
+
+    double Parareal::change(const State &previous, const State &next)
+    {
+        if (previous.values.size() != next.values.size())
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+
+        double result = 0.0;
+        for (std::size_t i = 0; i < next.values.size(); i++)
+        {
+            result = std::max(result, std::abs(next.values[i] - previous.values[i]) / (1.0 + std::abs(next.values[i])));
+        }
+        return result;
+    }
+
+    void Parareal::fine_pass(std::size_t first_window)
+    {
+        if (boundaries.size() < 2)
+        {
+            return;
+        }
+
+        auto windows = boundaries.size() - 1;
+        fine_states.resize(windows);
+
+        // Replica r solves windows first + r, first + r + replicas, ... in order
+        auto body = [&](std::size_t replica)
+        {
+            for (auto n = first_window + replica; n < windows; n += replicas)
+            {
+                fine_states[n] = states[n];
+                fine(replica, fine_states[n], boundaries[n], boundaries[n + 1]);
+            }
+        };
+
+        auto used = std::min(replicas, windows - std::min(first_window, windows));
+        utils::TaskScheduler::instance().parallel_for(used, body);
+    }
+
+    Parareal::Propagator Parareal::snapshot_propagator(std::vector<Graph *> systems, uint64_t step)
+    {
+        return [systems = std::move(systems), step](std::size_t replica, State &state, uint64_t start, uint64_t end)
+        {
+            auto system = systems[replica];
+            if (!system->load_snapshot(state.snapshot))
+            {
+                throw std::runtime_error(Logger::format("[Parareal] Replica {} failed to load the state at {}", replica, start));
+            }
+
+            for (auto t = start; t < end; t += step)
+            {
+                auto h = std::min(step, end - t);
+                system->executor->invoke(StepData(t, t + h, h));
+            }
+
+            if (!system->save_snapshot(state.snapshot))
+            {
+                throw std::runtime_error(Logger::format("[Parareal] Replica {} failed to save the state at {}", replica, end));
+            }
+
+            state.values.clear();
+            for (auto node : system->nodes)
+            {
+                auto offset = state.values.size();
+                state.values.resize(offset + node->input_values());
+                node->fetch_input_values(end, state.values.data() + offset);
+            }
+        };
+    }
+
+    bool Parareal::run(const State &initial, std::vector<uint64_t> window_boundaries)
+    {
+        if (window_boundaries.size() < 2)
+        {
+            throw std::runtime_error("[Parareal] At least one window is required");
+        }
+
+        boundaries = std::move(window_boundaries);
+        auto windows = boundaries.size() - 1;
+
+        states.assign(windows + 1, initial);
+        coarse_states.assign(windows, {});
+        residuals.clear();
+        iterations = 0;
+
+        // Initial prediction, serial coarse sweep
+        for (std::size_t n = 0; n < windows; n++)
+        {
+            coarse_states[n] = states[n];
+            coarse(0, coarse_states[n], boundaries[n], boundaries[n + 1]);
+            states[n + 1] = coarse_states[n];
+        }
+
+        bool converged = false;
+        while (iterations < max_iterations && !converged)
+        {
+            // Windows before the iteration count start from exact states and are final
+            auto first = static_cast<std::size_t>(iterations);
+            fine_pass(first);
+            iterations += 1;
+
+            double residual = 0.0;
+            if (correction == Correction::replacement)
+            {
+                for (auto n = first; n < windows; n++)
+                {
+                    residual = std::max(residual, change(states[n + 1], fine_states[n]));
+                    states[n + 1] = fine_states[n];
+                }
+            }
+            else
+            {
+                auto next = states[first];
+                for (auto n = first; n < windows; n++)
+                {
+                    auto predicted = next;
+                    coarse(0, predicted, boundaries[n], boundaries[n + 1]);
+
+                    next = predicted;
+                    for (std::size_t i = 0; i < next.values.size(); i++)
+                    {
+                        next.values[i] += fine_states[n].values[i] - coarse_states[n].values[i];
+                    }
+                    coarse_states[n] = std::move(predicted);
+
+                    // The window after the first one in the iteration is exact
+                    if (n == first)
+                    {
+                        next = fine_states[n];
+                    }
+
+                    residual = std::max(residual, change(states[n + 1], next));
+                    states[n + 1] = next;
+                }
+            }
+
+            residuals.push_back(residual);
+            converged = residual <= tolerance || iterations >= static_cast<int>(windows);
+
+            IF_LOG({
+                log(debug)("[{}] Iteration {}, residual {}", __func__, iterations, residual);
+            });
+        }
+
+        log(info)("[{}] {} windows, {} iterations, residual {}", __func__, windows, iterations, residuals.empty() ? 0.0 : residuals.back());
+        return converged;
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+    class Graph;
+
+    /**
+     * @brief Parareal iteration over macro-time windows
+     *
+     * The horizon is split into windows. A cheap coarse propagator G predicts the state at
+     * each window boundary serially, the accurate fine propagator F then solves all windows in
+     * parallel from the predicted states and the boundaries are corrected with
+     *
+     *   U[n+1] = G(U'[n]) + F(U[n]) - G(U[n])
+     *
+     * until they change less than the tolerance. After k iterations the first k windows equal
+     * the serial fine solution, their fine solves are skipped.
+     *
+     * States that can not be combined arithmetically, such as serialized co-simulation fmus,
+     * use replacement correction: a boundary takes the fine state of the window before it
+     *
+     *   U[n+1] = F(U[n])
+     *
+     * and the coarse propagator only makes the initial prediction. The values of the state,
+     * such as the coupling values at the boundary, are then only compared for convergence.
+     *
+     * Propagators advance a state from start to end on one of the replicas of the system.
+     * A replica is never used by two propagations at the same time, windows are distributed
+     * over the replicas round robin.
+     */
+    class Parareal
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.Parareal", LogLevel::info);
+
+        struct State
+        {
+            // Corrected arithmetically and compared between iterations
+            std::vector<double> values;
+            // Opaque part, replaced by the propagated state
+            std::vector<std::byte> snapshot;
+        };
+
+        // Advance state from start to end on a replica
+        using Propagator = std::function<void(std::size_t replica, State &state, uint64_t start, uint64_t end)>;
+
+        enum class Correction
+        {
+            arithmetic,
+            replacement
+        };
+
+        std::size_t replicas = 1;
+        Propagator coarse;
+        Propagator fine;
+
+        Correction correction = Correction::arithmetic;
+
+        int max_iterations = 10;
+        // Largest accepted change |U' - U| / (1 + |U'|) of the values of a boundary state between iterations
+        double tolerance = 1e-6;
+
+        // Window boundaries, windows + 1 times
+        std::vector<uint64_t> boundaries;
+        // State at each boundary
+        std::vector<State> states;
+
+        int iterations = 0;
+        // Largest boundary change in each iteration
+        std::vector<double> residuals;
+
+        Parareal(std::size_t replicas, Propagator coarse, Propagator fine);
+
+        // Equal windows from start to end, the last one may be shorter
+        static std::vector<uint64_t> split(uint64_t start, uint64_t end, std::size_t windows);
+
+        /**
+         * Iterate from the initial state until the boundaries converge or max_iterations
+         * is reached. Returns true when converged
+         */
+        bool run(const State &initial, std::vector<uint64_t> window_boundaries);
+
+        /**
+         * Run the fine propagator on every window from the current boundary states,
+         * windows in parallel. Used for a final pass that produces the outputs
+         */
+        void fine_pass(std::size_t first_window = 0);
+
+        /**
+         * Propagator on replicas of a system that saves snapshots, such as co-simulation fmus.
+         * The replica loads the snapshot of the state and is stepped by its executor in macro
+         * steps of step. The snapshot and the real inputs of the nodes at end, the coupling
+         * values, are written back to the state
+         */
+        static Propagator snapshot_propagator(std::vector<Graph *> systems, uint64_t step);
+
+    private:
+        // Fine solution at the end of each window
+        std::vector<State> fine_states;
+        // Coarse prediction at the end of each window from the current boundaries
+        std::vector<State> coarse_states;
+
+        // Largest relative change of the values, infinite if their number changed
+        static double change(const State &previous, const State &next);
+    };
+}
@@ -0,0 +1,180 @@
+#include "execution/realtime_pacer.hpp"
+
+#include "config.hpp"
+
+#include "utils/spin_wait.hpp"
+#include "utils/time.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#endif
+
+namespace ssp4sim::graph
+{
+
+    RealTimePacer::RealTimePacer(std::vector<Invocable *> nodes)
+    {
+        enabled = utils::Config::getOr("simulation.real_time.enable", false);
+        factor = utils::Config::getOr("simulation.real_time.factor", 1.0);
+        spin_ns = utils::time::s_to_ns(utils::Config::getOr("simulation.real_time.spin", 0.0002));
+        min_slack_ns = utils::time::s_to_ns(utils::Config::getOr("simulation.real_time.min_slack", 0.001));
+        skip_recording = utils::Config::getOr("simulation.real_time.skip_recording", false);
+        bin_width_ns = utils::time::s_to_ns(utils::Config::getOr("simulation.real_time.histogram.bin_width", 0.00005));
+        auto bins = utils::Config::getOr("simulation.real_time.histogram.bins", 20);
+
+        if (factor <= 0.0 || bin_width_ns == 0 || bins < 1)
+        {
+            throw std::runtime_error("[RealTimePacer] simulation.real_time.factor, histogram.bin_width and histogram.bins must be positive");
+        }
+
+        jitter.assign(static_cast<std::size_t>(bins), 0);
+        lateness.assign(static_cast<std::size_t>(bins), 0);
+
+        for (auto node : nodes)
+        {
+            models.push_back({node});
+        }
+    }
+
+    void RealTimePacer::start(uint64_t sim_time)
+    {
+        origin = clock::now();
+        sim_origin = sim_time;
+        last_sim_time = sim_time;
+        late = false;
+        for (auto &m : models)
+        {
+            m.last_walltime = m.node->walltime_ns;
+        }
+    }
+
+    RealTimePacer::clock::time_point RealTimePacer::deadline(uint64_t sim_time) const
+    {
+        auto wall = static_cast<double>(sim_time - sim_origin) / factor;
+        return origin + std::chrono::nanoseconds(static_cast<uint64_t>(wall));
+    }
+
+    void RealTimePacer::sleep_until(clock::time_point target) const
+    {
+        auto wake = target - std::chrono::nanoseconds(spin_ns);
+        if (clock::now() < wake)
+        {
+#if defined(__linux__)
+            // steady_clock is CLOCK_MONOTONIC on linux, an absolute sleep does not drift
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wake.time_since_epoch()).count();
+            timespec ts{static_cast<time_t>(ns / 1'000'000'000), static_cast<long>(ns % 1'000'000'000)};
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+            {
+            }
+#else
+            std::this_thread::sleep_until(wake);
+#endif
+        }
+
+        while (clock::now() < target)
+        {
+            utils::cpu_relax();
+        }
+    }
+
+    void RealTimePacer::add(std::vector<uint64_t> &histogram, uint64_t ns) const
+    {
+        auto bin = std::min<uint64_t>(ns / bin_width_ns, histogram.size() - 1);
+        histogram[bin] += 1;
+    }
+
+    bool RealTimePacer::pace(uint64_t step_start, uint64_t sim_time, const std::function<void()> &idle)
+    {
+        steps += 1;
+        last_sim_time = sim_time;
+
+        auto budget = static_cast<uint64_t>(static_cast<double>(sim_time - step_start) / factor);
+        for (auto &m : models)
+        {
+            auto used = m.node->walltime_ns - m.last_walltime;
+            m.last_walltime = m.node->walltime_ns;
+            m.max_step_walltime = std::max(m.max_step_walltime, used);
+            if (used > budget)
+            {
+                m.overruns += 1;
+            }
+        }
+
+        auto target = deadline(sim_time);
+        auto now = clock::now();
+        if (now > target)
+        {
+            auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - target).count());
+            max_lateness_ns = std::max(max_lateness_ns, ns);
+            add(lateness, ns);
+            overruns += 1;
+            late = true;
+
+            IF_LOG({
+                log(debug)("[{}] Deadline overrun at {}, {}s late", __func__, sim_time, utils::time::ns_to_s(ns));
+            });
+            return false;
+        }
+        late = false;
+
+        if (idle && target - now > std::chrono::nanoseconds(min_slack_ns))
+        {
+            idle();
+        }
+
+        sleep_until(target);
+
+        auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - target).count());
+        add(jitter, ns);
+        return true;
+    }
+
+    bool RealTimePacer::under_pressure() const
+    {
+        return late;
+    }
+
+    double RealTimePacer::real_time_factor() const
+    {
+        auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - origin).count();
+        return wall <= 0 ? 0.0 : static_cast<double>(last_sim_time - sim_origin) / static_cast<double>(wall);
+    }
+
+    std::string RealTimePacer::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "RealTimePacer { factor: " << factor
+            << ", steps: " << steps
+            << ", overruns: " << overruns
+            << ", max lateness: " << utils::time::ns_to_s(max_lateness_ns) << "s"
+            << ", real-time factor: " << real_time_factor()
+            << "\n";
+
+        auto print = [&](const char *label, const std::vector<uint64_t> &histogram)
+        {
+            oss << "  " << label << " (bins of " << utils::time::ns_to_s(bin_width_ns) << "s):";
+            for (auto count : histogram)
+            {
+                oss << " " << count;
+            }
+            oss << "\n";
+        };
+        print("jitter", jitter);
+        print("lateness", lateness);
+
+        for (auto &m : models)
+        {
+            oss << "  Model: " << m.node->name
+                << ", overruns " << m.overruns
+                << ", max step walltime " << utils::time::ns_to_s(m.max_step_walltime) << "s\n";
+        }
+        oss << "}\n";
+        return oss.str();
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include "invocable.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+
+    /**
+     * @brief Soft real-time pacing of the macro steps
+     *
+     * Each macro step has a wall clock deadline, start of the run plus the simulated time
+     * divided by the real-time factor. A step that finishes early gives its slack to background
+     * work and then sleeps until close to the deadline, the remainder is spun away to keep the
+     * wake up jitter low. A step that finishes late is an overrun, the following steps run
+     * back to back until the schedule is caught up.
+     *
+     * Models overrun when their own walltime in a step is larger than the wall time budget
+     * of the step.
+     *
+     * Configured through "simulation.real_time"
+     */
+    class RealTimePacer
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        Logger log = Logger("ssp4sim.execution.RealTimePacer", LogLevel::info);
+
+        struct Model
+        {
+            Invocable *node;
+            uint64_t last_walltime = 0;
+            uint64_t overruns = 0;
+            uint64_t max_step_walltime = 0;
+        };
+
+        bool enabled = false;
+
+        // Simulated seconds per wall clock second
+        double factor = 1.0;
+        // The last part before a deadline is spun instead of slept
+        uint64_t spin_ns = 200'000;
+        // Smallest slack that is handed to background work
+        uint64_t min_slack_ns = 1'000'000;
+        // Drop the recording of steps that follow an overrun
+        bool skip_recording = false;
+
+        uint64_t steps = 0;
+        uint64_t overruns = 0;
+        uint64_t max_lateness_ns = 0;
+
+        // Distance between completion and deadline, bins of bin_width_ns, the last one is open
+        uint64_t bin_width_ns = 50'000;
+        std::vector<uint64_t> jitter;
+        std::vector<uint64_t> lateness;
+
+        std::vector<Model> models;
+
+        RealTimePacer() = default;
+
+        // Reads the settings from the config
+        RealTimePacer(std::vector<Invocable *> nodes);
+
+        // Start of the schedule, sim_time is reached at once
+        void start(uint64_t sim_time);
+
+        /**
+         * Pace the step that ended at sim_time. idle is called while there is at least
+         * min_slack_ns left before the deadline. Returns false on a deadline overrun
+         */
+        bool pace(uint64_t step_start, uint64_t sim_time, const std::function<void()> &idle = {});
+
+        // The last step overran its deadline
+        bool under_pressure() const;
+
+        // Simulated time over wall time since start
+        double real_time_factor() const;
+
+        std::string to_string() const;
+
+    private:
+        clock::time_point origin;
+        uint64_t sim_origin = 0;
+        uint64_t last_sim_time = 0;
+        bool late = false;
+
+        clock::time_point deadline(uint64_t sim_time) const;
+
+        void sleep_until(clock::time_point target) const;
+
+        void add(std::vector<uint64_t> &histogram, uint64_t ns) const;
+    };
+}
@@ -0,0 +1,106 @@
+#include "execution/relaxation.hpp"
+
+#include "cutecpp/log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ssp4sim::graph
+{
+
+    Relaxation::Method Relaxation::parse(const std::string &method)
+    {
+        if (method == "none")
+        {
+            return Method::none;
+        }
+        else if (method == "constant")
+        {
+            return Method::constant;
+        }
+        else if (method == "aitken")
+        {
+            return Method::aitken;
+        }
+        throw std::runtime_error(Logger::format("[Relaxation] Unknown relaxation '{}'", method));
+    }
+
+    std::string Relaxation::to_string(Method method)
+    {
+        switch (method)
+        {
+        case Method::none:
+            return "none";
+        case Method::constant:
+            return "constant";
+        case Method::aitken:
+            return "aitken";
+        }
+        return "unknown";
+    }
+
+    void Relaxation::resize(std::size_t values)
+    {
+        residual.assign(values, 0.0);
+        previous_residual.assign(values, 0.0);
+    }
+
+    void Relaxation::reset()
+    {
+        factor = method == Method::none ? 1.0 : initial_factor;
+        has_previous = false;
+        error = 0.0;
+    }
+
+    void Relaxation::evaluate(std::size_t offset, const double *g, const double *u, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            auto r = g[i] - u[i];
+            residual[offset + i] = r;
+            error = std::max(error, std::abs(r) / (1.0 + std::abs(g[i])));
+        }
+    }
+
+    void Relaxation::apply(std::size_t offset, double *u, std::size_t count) const
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            u[i] += factor * residual[offset + i];
+        }
+    }
+
+    double Relaxation::finish()
+    {
+        auto result = error;
+        error = 0.0;
+
+        if (method == Method::aitken)
+        {
+            if (has_previous)
+            {
+                double numerator = 0.0;
+                double denominator = 0.0;
+                for (std::size_t i = 0; i < residual.size(); i++)
+                {
+                    auto dr = residual[i] - previous_residual[i];
+                    numerator += previous_residual[i] * dr;
+                    denominator += dr * dr;
+                }
+
+                if (denominator > 0.0)
+                {
+                    factor = std::clamp(-factor * numerator / denominator, -max_factor, max_factor);
+                }
+                if (factor == 0.0)
+                {
+                    factor = initial_factor;
+                }
+            }
+            previous_residual = residual;
+            has_previous = true;
+        }
+        return result;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+
+    /**
+     * @brief Under relaxation of a fixed point iteration u = G(u)
+     *
+     * Each iteration relaxes the current iterate u towards the evaluated G(u) with
+     * u += factor * (G(u) - u). The residual is recorded and applied in segments so that a
+     * seidel sweep can relax the inputs of its first model right before it is stepped, the
+     * sweep then uses the factor from the previous iteration.
+     *
+     * Aitken relaxation updates the factor from the last two residuals r:
+     *  factor_k+1 = -factor_k * r_k . (r_k+1 - r_k) / |r_k+1 - r_k|^2
+     */
+    class Relaxation
+    {
+    public:
+        enum class Method
+        {
+            none,
+            constant,
+            aitken
+        };
+
+        Method method = Method::none;
+        double initial_factor = 1.0;
+        // Bounds the magnitude of the aitken factor
+        double max_factor = 2.0;
+
+        // Factor used for the current iteration
+        double factor = 1.0;
+
+        static Method parse(const std::string &method);
+        static std::string to_string(Method method);
+
+        void resize(std::size_t values);
+
+        // Start of a new step, the factor starts over from initial_factor
+        void reset();
+
+        // Record the residual g - u for u[offset, offset + count)
+        void evaluate(std::size_t offset, const double *g, const double *u, std::size_t count);
+
+        // Closes the evaluation of an iteration and updates the factor.
+        // Returns the largest residual relative to the evaluated values, max |r| / (1 + |g|)
+        double finish();
+
+        // u[offset, offset + count) += factor * r
+        void apply(std::size_t offset, double *u, std::size_t count) const;
+
+    private:
+        std::vector<double> residual;
+        std::vector<double> previous_residual;
+        bool has_previous = false;
+        double error = 0.0;
+    };
+}
@@ -0,0 +1,669 @@
+#include "execution/scc_executor.hpp"
+
+#include "config.hpp"
+
+#include "model/model_fmu.hpp"
+
+#include "utils/tarjan.hpp"
+#include "utils/time.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace ssp4sim::graph
+{
+
+    SccExecutor::SccExecutor(std::vector<Invocable *> nodes, std::string default_relaxation)
+        : ExecutionBase(std::move(nodes)), scheduler(utils::TaskScheduler::instance())
+    {
+        this->name = "SccExecutor";
+
+        auto order = utils::Config::getOr("simulation.executor.scc.loop_order", std::string("seidel"));
+        if (order == "seidel")
+        {
+            loop_order = LoopOrder::seidel;
+        }
+        else if (order == "jacobi")
+        {
+            loop_order = LoopOrder::jacobi;
+        }
+        else
+        {
+            throw std::runtime_error(Logger::format("[SccExecutor] Unknown loop_order '{}'", order));
+        }
+
+        max_iterations = utils::Config::getOr("simulation.executor.scc.max_iterations", 20);
+        tolerance = utils::Config::getOr("simulation.executor.scc.tolerance", utils::Config::getOr("simulation.tolerance", 1e-4));
+        relaxation = Relaxation::parse(utils::Config::getOr("simulation.executor.scc.relaxation", default_relaxation));
+        relaxation_factor = utils::Config::getOr("simulation.executor.scc.relaxation_factor", 0.5);
+        metrics_file = utils::Config::getOr("simulation.executor.scc.metrics_file", std::string(""));
+        solver = utils::Config::getOr("simulation.executor.scc.solver", std::string("fixed_point"));
+        directional_derivatives = utils::Config::getOr("simulation.executor.scc.newton.directional_derivatives", true);
+        perturbation = utils::Config::getOr("simulation.executor.scc.newton.perturbation", 1e-6);
+        if (solver != "fixed_point" && solver != "newton" && solver != "iqn_ils")
+        {
+            throw std::runtime_error(Logger::format("[SccExecutor] Unknown solver '{}'", solver));
+        }
+
+        auto sccs = utils::graph::strongly_connected_components(utils::graph::Node::cast_to_parent_ptrs(this->nodes));
+
+        components.resize(sccs.size());
+        std::unordered_map<Invocable *, Component *> component_of;
+        for (std::size_t i = 0; i < sccs.size(); i++)
+        {
+            auto &c = components[i];
+            c.id = i;
+            for (auto node : sccs[i])
+            {
+                auto invocable = static_cast<Invocable *>(node);
+                c.members.push_back(invocable);
+                component_of[invocable] = &c;
+            }
+
+            // Keep the configured node order inside a loop
+            std::sort(c.members.begin(), c.members.end(), [](Invocable *a, Invocable *b)
+                      { return a->id < b->id; });
+            c.loop = c.members.size() > 1;
+        }
+
+        for (auto &c : components)
+        {
+            for (auto member : c.members)
+            {
+                for (auto child : member->children)
+                {
+                    auto target = component_of[static_cast<Invocable *>(child)];
+                    if (target != &c && std::find(c.children.begin(), c.children.end(), target) == c.children.end())
+                    {
+                        c.children.push_back(target);
+                        target->nr_parents += 1;
+                    }
+                }
+            }
+        }
+
+        for (auto &c : components)
+        {
+            if (c.nr_parents == 0)
+            {
+                start_components.push_back(&c);
+            }
+
+            if (!c.loop)
+            {
+                continue;
+            }
+
+            // Members that can not save their state are found by the first step
+            c.iterate = true;
+            std::size_t values = 0;
+            c.offsets.push_back(0);
+            for (auto member : c.members)
+            {
+                values += member->input_values();
+                c.offsets.push_back(values);
+            }
+
+            c.values.assign(values, 0.0);
+            c.evaluated.assign(values, 0.0);
+            c.relaxation.method = relaxation;
+            c.relaxation.initial_factor = relaxation_factor;
+            c.relaxation.resize(values);
+
+            if (solver != "fixed_point")
+            {
+                setup_coupling(c);
+            }
+        }
+
+        pending = std::make_unique<std::atomic<std::size_t>[]>(components.size());
+
+        log(info)("[{}] {}", __func__, to_string());
+    }
+
+    std::string SccExecutor::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "SccExecutor { components: " << components.size()
+            << ", loop_order: " << (loop_order == LoopOrder::seidel ? "seidel" : "jacobi")
+            << ", max_iterations: " << max_iterations
+            << ", tolerance: " << tolerance
+            << ", relaxation: " << Relaxation::to_string(relaxation)
+            << ", relaxation_factor: " << relaxation_factor
+            << ", solver: " << solver << "\n";
+        for (auto &c : components)
+        {
+            if (!c.loop)
+            {
+                continue;
+            }
+            oss << "  Loop " << c.id << (c.iterate ? " (iterated):" : " (single pass):");
+            for (auto member : c.members)
+            {
+                oss << " " << member->name;
+            }
+            oss << "\n";
+        }
+        oss << "}\n";
+        return oss.str();
+    }
+
+    bool SccExecutor::gather(Component &component, std::size_t member, uint64_t input_time)
+    {
+        return component.members[member]->fetch_input_values(input_time, component.evaluated.data() + component.offsets[member]);
+    }
+
+    void SccExecutor::setup_coupling(Component &component)
+    {
+        auto &members = component.members;
+        std::vector<FmuModel *> models;
+        for (auto member : members)
+        {
+            models.push_back(dynamic_cast<FmuModel *>(member));
+        }
+
+        for (std::size_t m = 0; m < members.size(); m++)
+        {
+            if (models[m] == nullptr)
+            {
+                component.resolved = false;
+                for (auto i = component.offsets[m]; i < component.offsets[m + 1]; i++)
+                {
+                    component.coupling.push_back({m, 0, std::string::npos, 0, true, false});
+                }
+                continue;
+            }
+
+            // Same order as FmuModel::fetch_input_values
+            for (auto &variable : models[m]->input_area->variables)
+            {
+                if (variable.type != types::DataType::real)
+                {
+                    continue;
+                }
+
+                CouplingValue value{m, 0, std::string::npos, 0, variable.count == 1, true};
+                for (auto &[_, input] : models[m]->inputs)
+                {
+                    if (input.index == variable.index)
+                    {
+                        value.value_ref = input.value_ref;
+                    }
+                }
+
+                for (auto &connection : models[m]->connections)
+                {
+                    if (connection.target_index != variable.index)
+                    {
+                        continue;
+                    }
+                    for (std::size_t source = 0; source < members.size(); source++)
+                    {
+                        if (models[source] == nullptr || models[source]->output_area.get() != connection.source_storage)
+                        {
+                            continue;
+                        }
+                        value.source = source;
+                        for (auto &[_, output] : models[source]->outputs)
+                        {
+                            if (output.index == connection.source_index)
+                            {
+                                value.source_ref = output.value_ref;
+                            }
+                        }
+                    }
+                }
+
+                for (std::size_t k = 0; k < variable.count; k++)
+                {
+                    component.coupling.push_back(value);
+                }
+            }
+        }
+
+        // Directional derivatives need the source of every input
+        component.directional.assign(members.size(), false);
+        for (std::size_t m = 0; m < members.size(); m++)
+        {
+            if (!directional_derivatives || !component.resolved || !models[m]->fmu->get_model()->can_get_directional_derivative())
+            {
+                continue;
+            }
+
+            // Array inputs or outputs are perturbed instead
+            bool scalar = true;
+            for (auto &value : component.coupling)
+            {
+                if ((value.member == m || value.source == m) && !value.scalar)
+                {
+                    scalar = false;
+                }
+            }
+            component.directional[m] = scalar;
+        }
+
+        auto solver_ptr = make_coupling_solver(solver, component.values.size(), [this, &component](std::vector<double> &jacobian)
+                                               { coupling_jacobian(component, jacobian); });
+        if (auto iqn = dynamic_cast<IqnIlsSolver *>(solver_ptr.get()))
+        {
+            iqn->initial_factor = relaxation_factor;
+            iqn->reuse_steps = utils::Config::getOr("simulation.executor.scc.iqn_ils.reuse_steps", 8);
+            iqn->max_columns = static_cast<std::size_t>(utils::Config::getOr("simulation.executor.scc.iqn_ils.max_columns", 20));
+        }
+        component.solver = std::move(solver_ptr);
+    }
+
+    bool SccExecutor::save(Component &component)
+    {
+        for (auto member : component.members)
+        {
+            if (!member->save_state())
+            {
+                log(warning)("[{}] {} can not save its state, its loop is invoked once per step", __func__, member->name);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void SccExecutor::restore(Component &component)
+    {
+        for (auto member : component.members)
+        {
+            if (!member->restore_state())
+            {
+                throw std::runtime_error(Logger::format("[SccExecutor] Failed to restore the state of {}", member->name));
+            }
+        }
+    }
+
+    void SccExecutor::step_member(Component &component, std::size_t member, const StepData &step_data)
+    {
+        component.members[member]->step_with_inputs(step_data, component.values.data() + component.offsets[member]);
+    }
+
+    void SccExecutor::record(Component &component, const StepData &step_data, int iterations, double residual, bool converged)
+    {
+        component.stats.steps += 1;
+        component.stats.iterations += static_cast<uint64_t>(iterations);
+        component.stats.most = std::max(component.stats.most, iterations);
+
+        if (!metrics_file.empty())
+        {
+            std::scoped_lock lock(metrics_mutex);
+            if (!metrics)
+            {
+                metrics = std::make_unique<signal::CsvWriter>(metrics_file);
+                if (!metrics->is_open())
+                {
+                    throw std::runtime_error(Logger::format("[SccExecutor] Unable to open metrics file {}", metrics_file));
+                }
+                *metrics << "loop, time, iterations, residual\n";
+            }
+            *metrics << component.id << ", " << utils::time::ns_to_s(step_data.end_time) << ", " << iterations << ", " << residual << '\n';
+        }
+        loop_iterations.fetch_add(static_cast<uint64_t>(iterations), std::memory_order_relaxed);
+        if (!converged)
+        {
+            unconverged_steps.fetch_add(1, std::memory_order_relaxed);
+            IF_LOG({
+                log(warning)("[{}] Loop {} did not converge in {} iterations at {}, residual {}", __func__, component.id, max_iterations, step_data.end_time, residual);
+            });
+        }
+    }
+
+    void SccExecutor::invoke_loop(Component &component, const StepData &step_data)
+    {
+        if (component.iterate && !save(component))
+        {
+            component.iterate = false;
+        }
+
+        if (!component.iterate)
+        {
+            for (auto member : component.members)
+            {
+                member->invoke(step_data);
+            }
+            return;
+        }
+
+        if (component.solver)
+        {
+            invoke_coupled(component, step_data);
+            return;
+        }
+
+        auto &members = component.members;
+        auto &offsets = component.offsets;
+        auto &relax = component.relaxation;
+
+        relax.reset();
+
+        // First iteration, a plain pass with the inputs available at the start of the step
+        if (loop_order == LoopOrder::jacobi)
+        {
+            for (std::size_t m = 0; m < members.size(); m++)
+            {
+                gather(component, m, step_data.input_time);
+            }
+        }
+        for (std::size_t m = 0; m < members.size(); m++)
+        {
+            if (loop_order == LoopOrder::seidel)
+            {
+                gather(component, m, step_data.input_time);
+            }
+            std::copy(component.evaluated.begin() + offsets[m], component.evaluated.begin() + offsets[m + 1], component.values.begin() + offsets[m]);
+            step_member(component, m, step_data);
+        }
+
+        int iterations = 1;
+        double residual = 0.0;
+        bool converged = false;
+        while (!converged && iterations < max_iterations)
+        {
+            if (loop_order == LoopOrder::jacobi)
+            {
+                // Evaluate the inputs of all members from the last iteration, when they are
+                // consistent the fmus already hold the solution
+                bool held = true;
+                for (std::size_t m = 0; m < members.size(); m++)
+                {
+                    held = gather(component, m, step_data.input_time) && held;
+                    relax.evaluate(offsets[m], &component.evaluated[offsets[m]], &component.values[offsets[m]], offsets[m + 1] - offsets[m]);
+                }
+                residual = relax.finish();
+                if (residual <= tolerance && held)
+                {
+                    converged = true;
+                    break;
+                }
+
+                restore(component);
+                for (std::size_t m = 0; m < members.size(); m++)
+                {
+                    relax.apply(offsets[m], &component.values[offsets[m]], offsets[m + 1] - offsets[m]);
+                    step_member(component, m, step_data);
+                }
+            }
+            else
+            {
+                // Each member reads the outputs of the members before it in this sweep. The sweep
+                // is a fixed point map of the inputs of the first member, only those are relaxed
+                restore(component);
+                double swept = 0.0;
+                bool held = true;
+                for (std::size_t m = 0; m < members.size(); m++)
+                {
+                    held = gather(component, m, step_data.input_time) && held;
+                    if (m == 0)
+                    {
+                        relax.evaluate(0, component.evaluated.data(), component.values.data(), offsets[1]);
+                        relax.apply(0, component.values.data(), offsets[1]);
+                    }
+                    else
+                    {
+                        for (auto i = offsets[m]; i < offsets[m + 1]; i++)
+                        {
+                            auto g = component.evaluated[i];
+                            swept = std::max(swept, std::abs(g - component.values[i]) / (1.0 + std::abs(g)));
+                            component.values[i] = g;
+                        }
+                    }
+                    step_member(component, m, step_data);
+                }
+                residual = std::max(relax.finish(), swept);
+                converged = residual <= tolerance && held;
+            }
+            iterations += 1;
+        }
+
+        record(component, step_data, iterations, residual, converged);
+    }
+
+    void SccExecutor::invoke_coupled(Component &component, const StepData &step_data)
+    {
+        auto &members = component.members;
+
+        component.step = &step_data;
+        component.solver->start_step();
+
+        // First iteration with the inputs available at the start of the step
+        for (std::size_t m = 0; m < members.size(); m++)
+        {
+            gather(component, m, step_data.input_time);
+        }
+        component.values = component.evaluated;
+        for (std::size_t m = 0; m < members.size(); m++)
+        {
+            step_member(component, m, step_data);
+        }
+
+        int iterations = 1;
+        double residual = 0.0;
+        bool converged = false;
+        while (true)
+        {
+            residual = 0.0;
+            bool held = true;
+            for (std::size_t m = 0; m < members.size(); m++)
+            {
+                held = gather(component, m, step_data.input_time) && held;
+            }
+            for (std::size_t i = 0; i < component.values.size(); i++)
+            {
+                auto g = component.evaluated[i];
+                residual = std::max(residual, std::abs(g - component.values[i]) / (1.0 + std::abs(g)));
+            }
+
+            if (residual <= tolerance && held)
+            {
+                converged = true;
+                break;
+            }
+            if (iterations >= max_iterations)
+            {
+                break;
+            }
+
+            component.solver->update(component.values, component.evaluated);
+
+            restore(component);
+            for (std::size_t m = 0; m < members.size(); m++)
+            {
+                step_member(component, m, step_data);
+            }
+            iterations += 1;
+        }
+
+        component.step = nullptr;
+        record(component, step_data, iterations, residual, converged);
+    }
+
+    void SccExecutor::coupling_jacobian(Component &component, std::vector<double> &jacobian)
+    {
+        auto &members = component.members;
+        auto &step_data = *component.step;
+        auto n = component.values.size();
+
+        // G(u) at the current iterate, the perturbed members overwrite component.evaluated
+        auto base = component.evaluated;
+
+        for (std::size_t s = 0; s < members.size(); s++)
+        {
+            // Rows are the inputs produced by s, columns the inputs of s
+            std::vector<std::size_t> rows;
+            std::vector<std::size_t> columns;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                if (component.coupling[i].source == s || !component.coupling[i].resolved)
+                {
+                    rows.push_back(i);
+                }
+                if (component.coupling[i].member == s)
+                {
+                    columns.push_back(i);
+                }
+            }
+            if (rows.empty() || columns.empty())
+            {
+                continue;
+            }
+
+            if (component.directional[s])
+            {
+                auto model = static_cast<FmuModel *>(members[s]);
+                std::vector<uint64_t> unknowns;
+                for (auto i : rows)
+                {
+                    unknowns.push_back(component.coupling[i].source_ref);
+                }
+
+                std::vector<double> sensitivity(rows.size());
+                double seed = 1.0;
+                for (auto j : columns)
+                {
+                    if (!model->fmu->get_model()->get_directional_derivative(unknowns, {component.coupling[j].value_ref}, &seed, sensitivity.data()))
+                    {
+                        throw std::runtime_error(Logger::format("[SccExecutor] Failed to get the directional derivative of {}", model->name));
+                    }
+                    for (std::size_t k = 0; k < rows.size(); k++)
+                    {
+                        jacobian[rows[k] * n + j] = sensitivity[k];
+                    }
+                }
+                continue;
+            }
+
+            for (auto j : columns)
+            {
+                auto h = perturbation * (1.0 + std::abs(component.values[j]));
+
+                if (!members[s]->restore_state())
+                {
+                    throw std::runtime_error(Logger::format("[SccExecutor] Failed to restore the state of {}", members[s]->name));
+                }
+                component.values[j] += h;
+                step_member(component, s, step_data);
+                component.values[j] -= h;
+
+                for (std::size_t m = 0; m < members.size(); m++)
+                {
+                    gather(component, m, step_data.input_time);
+                }
+                for (auto i : rows)
+                {
+                    jacobian[i * n + j] = (component.evaluated[i] - base[i]) / h;
+                }
+            }
+
+            // Without known sources every row is read, the next member must see unperturbed outputs of s
+            if (!component.resolved)
+            {
+                if (!members[s]->restore_state())
+                {
+                    throw std::runtime_error(Logger::format("[SccExecutor] Failed to restore the state of {}", members[s]->name));
+                }
+                step_member(component, s, step_data);
+            }
+        }
+
+        component.evaluated = std::move(base);
+    }
+
+    void SccExecutor::run_task(void *context, std::size_t id)
+    {
+        auto self = static_cast<SccExecutor *>(context);
+        self->run_component(&self->components[id]);
+    }
+
+    void SccExecutor::run_component(Component *component)
+    {
+        while (component != nullptr)
+        {
+            if (component->loop)
+            {
+                invoke_loop(*component, step);
+            }
+            else
+            {
+                component->members.front()->invoke(step);
+            }
+
+            Component *next = nullptr;
+            for (auto child : component->children)
+            {
+                if (pending[child->id].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    if (next == nullptr)
+                    {
+                        next = child;
+                    }
+                    else
+                    {
+                        scheduler.spawn(tasks, &SccExecutor::run_task, this, child->id);
+                    }
+                }
+            }
+            component = next;
+        }
+    }
+
+    uint64_t SccExecutor::invoke(StepData step_data)
+    {
+        IF_LOG({
+            log(debug)("[{}] stepdata: {}", __func__, step_data.to_string());
+        });
+
+        for (auto &c : components)
+        {
+            pending[c.id].store(c.nr_parents, std::memory_order_relaxed);
+        }
+
+        step = StepData(step_data.start_time, // start
+                        step_data.end_time,   // end
+                        sub_step,             // step_size
+                        step_data.end_time,   // components read the results of their parents from this step
+                        step_data.end_time);  // output_time
+
+        for (auto c : start_components)
+        {
+            scheduler.spawn(tasks, &SccExecutor::run_task, this, c->id);
+        }
+
+        // Rethrows the first exception thrown by a component
+        scheduler.wait(tasks);
+
+        wait_for_result_collection();
+
+        return step_data.end_time;
+    }
+
+    void SccExecutor::log_metrics()
+    {
+        {
+            std::scoped_lock lock(metrics_mutex);
+            if (metrics)
+            {
+                metrics->flush();
+            }
+        }
+
+        for (auto &c : components)
+        {
+            if (!c.iterate || c.stats.steps == 0)
+            {
+                continue;
+            }
+
+            log(info)("[{}] Loop {}: steps {}, mean iterations {:.2f}, max iterations {}",
+                      __func__, c.id, c.stats.steps, static_cast<double>(c.stats.iterations) / static_cast<double>(c.stats.steps), c.stats.most);
+        }
+        log(info)("[{}] Loop iterations {}, unconverged steps {}", __func__, loop_iterations.load(), unconverged_steps.load());
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include "ssp4sim_definitions.hpp"
+
+#include "executor.hpp"
+#include "coupling_solver.hpp"
+#include "invocable.hpp"
+#include "relaxation.hpp"
+
+#include "signal/csv_writer.hpp"
+#include "utils/task_scheduler.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+
+    /**
+     * @brief Executor over the strongly connected components of the model graph
+     *
+     * The graph is condensed into a DAG of components that is scheduled like ParallelSeidel,
+     * a component starts when all components it depends on have completed the step.
+     * Single models are invoked once, algebraic loops repeat the step until the inputs of
+     * the loop converge. Between iterations the loop members are rolled back with save_state and
+     * restore_state and their real inputs, see Invocable::input_values, are relaxed towards the
+     * outputs of the last iteration. Loops with members that can not save their state are
+     * invoked once in seidel order.
+     *
+     * Configured through "simulation.executor.scc":
+     *  - loop_order: "seidel" (default) or "jacobi" iteration inside a loop
+     *  - max_iterations: iterations per step before accepting an unconverged loop
+     *  - tolerance: relative tolerance on the loop inputs, defaults to simulation.tolerance
+     *  - relaxation: "none", "constant" or "aitken", see Relaxation. In seidel order only the
+     *    inputs of the first member are relaxed, the sweep determines the others
+     *  - relaxation_factor: (initial) relaxation factor
+     *  - metrics_file: optional csv with the iterations of each loop and step, written as the
+     *    steps are taken
+     *  - solver: "fixed_point" (default), "newton" or "iqn_ils", see CouplingSolver.
+     *    The newton type solvers evaluate the loop in jacobi order
+     *  - newton.directional_derivatives: use fmi directional derivatives for the coupling jacobian
+     *    where available, other members are perturbed with finite differences. Only for loops of fmus
+     *  - newton.perturbation: relative finite difference step
+     *  - iqn_ils.reuse_steps, iqn_ils.max_columns: secant information kept between steps
+     *
+     * The "iterative" executor method is the same executor with aitken relaxation as default.
+     */
+    class SccExecutor final : public ExecutionBase
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.SccExecutor", LogLevel::info);
+
+        enum class LoopOrder
+        {
+            seidel,
+            jacobi
+        };
+
+        // A loop input value and the loop member that produces it
+        struct CouplingValue
+        {
+            std::size_t member;
+            uint64_t value_ref;
+            // Loop member of the connected output, or npos for inputs from outside the loop
+            std::size_t source;
+            uint64_t source_ref;
+            bool scalar;
+            // The source is only known for fmu members, any member may produce the others
+            bool resolved;
+        };
+
+        // Running aggregates of the iterated steps of a loop
+        struct IterationStats
+        {
+            uint64_t steps = 0;
+            uint64_t iterations = 0;
+            int most = 0;
+        };
+
+        struct Component
+        {
+            std::size_t id = 0;
+            std::vector<Invocable *> members;
+            std::vector<Component *> children;
+            std::size_t nr_parents = 0;
+
+            bool loop = false;
+            bool iterate = false;
+
+            // Loop only, the inputs of member m are values[offsets[m], offsets[m + 1])
+            std::vector<std::size_t> offsets;
+
+            // Current iterate and the inputs evaluated from the last iteration
+            std::vector<double> values;
+            std::vector<double> evaluated;
+            Relaxation relaxation;
+
+            // Newton type solvers only
+            std::unique_ptr<CouplingSolver> solver;
+            std::vector<CouplingValue> coupling;
+            std::vector<bool> directional;
+            bool resolved = true;
+            const StepData *step = nullptr;
+
+            IterationStats stats;
+        };
+
+        std::vector<Component> components;
+        std::vector<Component *> start_components;
+
+        LoopOrder loop_order = LoopOrder::seidel;
+        int max_iterations = 20;
+        double tolerance = 1e-4;
+        Relaxation::Method relaxation = Relaxation::Method::none;
+        double relaxation_factor = 1.0;
+        std::string metrics_file;
+
+        std::string solver = "fixed_point";
+        bool directional_derivatives = true;
+        double perturbation = 1e-6;
+
+        std::atomic<uint64_t> loop_iterations{0};
+        std::atomic<uint64_t> unconverged_steps{0};
+
+        SccExecutor(std::vector<Invocable *> nodes, std::string default_relaxation = "none");
+
+        std::string to_string() const override;
+
+        // Logs the iteration statistics of each loop and writes the metrics file
+        void log_metrics() override;
+
+        // hot path
+        uint64_t invoke(StepData step_data) override final;
+
+    private:
+        std::unique_ptr<std::atomic<std::size_t>[]> pending;
+        utils::TaskScheduler &scheduler;
+        utils::TaskGroup tasks;
+
+        // Opened by the first record, shared by the loops running in parallel
+        std::unique_ptr<signal::CsvWriter> metrics;
+        std::mutex metrics_mutex;
+
+        // Step of the running invoke, read by the spawned tasks
+        StepData step;
+
+        void run_component(Component *component);
+
+        static void run_task(void *context, std::size_t id);
+
+        void invoke_loop(Component &component, const StepData &step_data);
+
+        // Loop iterated with a newton type coupling solver
+        void invoke_coupled(Component &component, const StepData &step_data);
+
+        // dG/du of a loop, directional derivatives or finite differences per member
+        void coupling_jacobian(Component &component, std::vector<double> &jacobian);
+
+        void setup_coupling(Component &component);
+
+        // False if a member can not save its state
+        bool save(Component &component);
+
+        void restore(Component &component);
+
+        // Step a member on its part of the current iterate
+        void step_member(Component &component, std::size_t member, const StepData &step_data);
+
+        // Update the statistics of the loop and write the step to the metrics file
+        void record(Component &component, const StepData &step_data, int iterations, double residual, bool converged);
+
+        // Fetch the inputs of a loop member into component.evaluated. False if its non real
+        // inputs changed since its last step, the loop has then not converged
+        bool gather(Component &component, std::size_t member, uint64_t input_time);
+    };
+}
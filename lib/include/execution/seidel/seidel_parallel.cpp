@@ -1,15 +1,124 @@
-
 #include "execution/seidel/seidel_parallel.hpp"
 
 #include "config.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace ssp4sim::graph
 {
-    ParallelSeidel::ParallelSeidel(std::vector<Invocable *> nodes) : SeidelBase(nodes)
+    ParallelSeidel::ParallelSeidel(std::vector<Invocable *> nodes)
+        : SeidelBase(nodes),
+          pending(std::make_unique<std::atomic<std::size_t>[]>(nr_of_nodes)),
+          children(nr_of_nodes),
+          critical_path(nr_of_nodes, 0),
+          scheduler(utils::TaskScheduler::instance())
     {
         log(info)("[{}]", __func__);
+
+        for (auto &n : seidel_nodes)
+        {
+            for (auto c : n.node->children)
+            {
+                children[n.id].push_back(&seidel_nodes[((Invocable *)c)->id]);
+            }
+        }
+
+        // Kahn's algorithm, any node left unvisited is part of a loop
+        std::vector<std::size_t> remaining(nr_of_nodes);
+        for (auto &n : seidel_nodes)
+        {
+            remaining[n.id] = n.nr_parents;
+        }
+
+        topological_order = start_nodes;
+        for (std::size_t i = 0; i < topological_order.size(); i++)
+        {
+            for (auto child : children[topological_order[i]->id])
+            {
+                remaining[child->id] -= 1;
+                if (remaining[child->id] == 0)
+                {
+                    topological_order.push_back(child);
+                }
+            }
+        }
+
+        if (topological_order.size() != seidel_nodes.size())
+        {
+            for (auto &n : seidel_nodes)
+            {
+                if (remaining[n.id] != 0)
+                {
+                    log(error)("[{}] {} is part of an algebraic loop", __func__, n.node->name);
+                }
+            }
+            throw std::runtime_error("[ParallelSeidel] The connection graph contains algebraic loops, break them with a delay or use jacobi");
+        }
+
+        update_priorities();
+    }
+
+    void ParallelSeidel::update_priorities()
+    {
+        for (auto it = topological_order.rbegin(); it != topological_order.rend(); ++it)
+        {
+            auto id = (*it)->id;
+            uint64_t longest_child = 0;
+            for (auto child : children[id])
+            {
+                longest_child = std::max(longest_child, critical_path[child->id]);
+            }
+            // +1 gives the node count as path length before any walltime is measured
+            critical_path[id] = (*it)->node->walltime_ns + 1 + longest_child;
+        }
+
+        auto by_priority = [this](SeidelNode *a, SeidelNode *b)
+        {
+            return critical_path[a->id] > critical_path[b->id];
+        };
+
+        for (auto &c : children)
+        {
+            std::sort(c.begin(), c.end(), by_priority);
+        }
+        std::sort(start_nodes.begin(), start_nodes.end(), by_priority);
+    }
+
+    void ParallelSeidel::run_task(void *context, std::size_t id)
+    {
+        auto self = static_cast<ParallelSeidel *>(context);
+        self->run_node(&self->seidel_nodes[id]);
+    }
+
+    void ParallelSeidel::run_node(SeidelNode *node)
+    {
+        while (node != nullptr)
+        {
+            IF_LOG({
+                log(trace)("[{}] Starting {}:{}", __func__, node->id, node->node->name);
+            });
+
+            node->node->invoke(step);
+
+            SeidelNode *next = nullptr;
+            for (auto child : children[node->id])
+            {
+                if (pending[child->id].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    if (next == nullptr)
+                    {
+                        // Highest priority ready child continues on this thread
+                        next = child;
+                    }
+                    else
+                    {
+                        scheduler.spawn(tasks, &ParallelSeidel::run_task, this, static_cast<std::size_t>(child->id));
+                    }
+                }
+            }
+            node = next;
+        }
     }
 
     /**
@@ -22,67 +131,26 @@ namespace ssp4sim::graph
             log(ext_trace)("[{}] step data: {}", __func__, step_data.to_string());
         });
 
-        step_data.input_time = step_data.end_time;
-
-        throw std::runtime_error("This is not implemented");
-
-        // reset_counters();
-
-        // // track how many are currently running
-        // int launched = 0;
-        // int completed = 0;
-
-        // IF_LOG({
-        //     log(trace)("[{}] Invoking all start nodes", __func__);
-        // });
-
-        // for (auto &sn : start_nodes)
-        // {
-        //     sn->node->async_invoke(step_data);
-        //     launched += 1;
-        // }
-
-        // while (launched != completed)
-        // {
-        //     IF_LOG({
-        //         log(trace)("[{}] Waiting for nodes to finish. launched {}, completed  {}", __func__, launched, completed);
-        //     });
-
-        //     shared_state->sem.acquire();
-        //     completed += 1;
-
-        //     DoneMsg msg;
-        //     {
-        //         std::lock_guard<std::mutex> lock(shared_state->mtx);
-        //         msg = std::move(shared_state->inbox.front());
-        //         shared_state->inbox.pop();
-        //     }
-        //     auto &finished_node = seidel_nodes[msg.worker_id];
-
-        //     IF_LOG({
-        //         log(trace)("[{}] Node finished: {}", __func__, finished_node.node->name);
-        //     });
-
-        //     // enqueue children whose all parents are invoked
-        //     for (auto c : finished_node.node->children)
-        //     {
-        //         auto &child = seidel_nodes[((AsyncNode *)c)->worker_id];
-
-        //         child.nr_parents_counter -= 1;
-        //         if (child.nr_parents_counter == 0)
-        //         {
-        //             IF_LOG({
-        //                 log(debug)("[{}] Node ready, invoking: {}", __func__, child.node->name);
-        //             });
-
-        //             child.node->async_invoke(step_data);
-        //             launched += 1;
-        //         }
-        //     }
-        // }
-        // IF_LOG({
-        //     log(trace)("[{}] End. launched {}, completed  {}", __func__, launched, completed);
-        // });
+        for (auto &n : seidel_nodes)
+        {
+            pending[n.id].store(n.nr_parents, std::memory_order_relaxed);
+        }
+
+        step = StepData(step_data.start_time, // start
+                        step_data.end_time,   // end
+                        sub_step,             // step_size
+                        step_data.end_time,   // it should be able to use results from the current iteration
+                        step_data.end_time);  // output_time
+
+        for (auto &sn : start_nodes)
+        {
+            scheduler.spawn(tasks, &ParallelSeidel::run_task, this, static_cast<std::size_t>(sn->id));
+        }
+
+        // Rethrows the first exception thrown by a node
+        scheduler.wait(tasks);
+
+        update_priorities();
 
         wait_for_result_collection();
 
@@ -2,11 +2,27 @@
 
 #include "execution/seidel/seidel_base.hpp"
 
+#include "utils/task_scheduler.hpp"
+
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace ssp4sim::graph
 {
+    /**
+     * @brief Dependency driven Seidel executor
+     *
+     * Each node waits on an atomic counter of unfinished parents. A finishing node decrements
+     * the counters of its children, the ready child with the longest critical path continues
+     * on the same thread and the others are spawned on the shared work-stealing scheduler.
+     *
+     * The critical path is the accumulated walltime from a node to the end of the graph,
+     * it is refreshed after each step so that expensive branches are started first.
+     * The graph must be acyclic, algebraic loops are rejected at construction.
+     */
     class ParallelSeidel final : public SeidelBase
     {
     public:
@@ -24,5 +40,29 @@ namespace ssp4sim::graph
          * [hot path]
          */
         uint64_t invoke(StepData step_data) override final;
+
+    private:
+        // Unfinished parents of each node in the current step
+        std::unique_ptr<std::atomic<std::size_t>[]> pending;
+
+        std::vector<SeidelNode *> topological_order;
+
+        // Children of each node, longest critical path first
+        std::vector<std::vector<SeidelNode *>> children;
+
+        // Accumulated walltime along the longest path from the node to a sink
+        std::vector<uint64_t> critical_path;
+
+        utils::TaskScheduler &scheduler;
+        utils::TaskGroup tasks;
+
+        // Step of the running invoke, read by the spawned tasks
+        StepData step;
+
+        void run_node(SeidelNode *node);
+
+        static void run_task(void *context, std::size_t id);
+
+        void update_priorities();
     };
 }
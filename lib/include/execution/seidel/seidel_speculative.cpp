@@ -0,0 +1,279 @@
+#include "execution/seidel/seidel_speculative.hpp"
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace ssp4sim::graph
+{
+    SpeculativeSeidel::SpeculativeSeidel(std::vector<Invocable *> nodes)
+        : SeidelBase(std::move(nodes)),
+          scheduler(utils::TaskScheduler::instance()),
+          speculated(nr_of_nodes)
+    {
+        this->name = "SpeculativeSeidel";
+
+        tolerance = utils::Config::getOr("simulation.executor.seidel.speculative.tolerance", utils::Config::getOr("simulation.tolerance", 1e-4));
+        order = utils::Config::getOr("simulation.executor.seidel.speculative.order", 1);
+        if (order != 0 && order != 1)
+        {
+            throw std::runtime_error("[SpeculativeSeidel] simulation.executor.seidel.speculative.order must be 0 or 1");
+        }
+
+        // Kahn's algorithm, any node left unvisited is part of a loop
+        std::vector<std::size_t> remaining(nr_of_nodes);
+        for (auto &n : seidel_nodes)
+        {
+            remaining[n.id] = n.nr_parents;
+        }
+
+        topological_order = start_nodes;
+        for (std::size_t i = 0; i < topological_order.size(); i++)
+        {
+            for (auto c : topological_order[i]->node->children)
+            {
+                auto child = &seidel_nodes[((Invocable *)c)->id];
+                remaining[child->id] -= 1;
+                if (remaining[child->id] == 0)
+                {
+                    topological_order.push_back(child);
+                }
+            }
+        }
+
+        if (topological_order.size() != seidel_nodes.size())
+        {
+            throw std::runtime_error("[SpeculativeSeidel] The connection graph contains algebraic loops, break them with a delay or use scc");
+        }
+
+        for (auto &n : seidel_nodes)
+        {
+            if (n.nr_parents == 0)
+            {
+                eager.push_back(&n);
+                continue;
+            }
+
+            auto values = n.node->input_values();
+            if (values == 0)
+            {
+                log(info)("[{}] {} has no real inputs to predict and runs after its parents", __func__, n.node->name);
+                continue;
+            }
+
+            // Nodes that can not save their state are found by their first speculation
+            auto &s = speculated[n.id];
+            s.node = n.node;
+            s.predicted.assign(values, 0.0);
+            s.actual.assign(values, 0.0);
+            s.latest.assign(values, 0.0);
+            s.previous.assign(values, 0.0);
+            eager.push_back(&n);
+        }
+
+        log(info)("[{}] {}", __func__, to_string());
+    }
+
+    std::string SpeculativeSeidel::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "SpeculativeSeidel { tolerance: " << tolerance << ", order: " << order << ", speculating:";
+        for (auto &s : speculated)
+        {
+            if (s.node != nullptr)
+            {
+                oss << " " << s.node->name;
+            }
+        }
+        oss << " }";
+        return oss.str();
+    }
+
+    const SpeculativeSeidel::Statistics &SpeculativeSeidel::statistics(std::size_t id) const
+    {
+        return speculated.at(id).statistics;
+    }
+
+    double SpeculativeSeidel::hit_rate() const
+    {
+        uint64_t hits = 0;
+        uint64_t validated = 0;
+        for (auto &s : speculated)
+        {
+            hits += s.statistics.hits;
+            validated += s.statistics.hits + s.statistics.misses;
+        }
+        return validated == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(validated);
+    }
+
+    void SpeculativeSeidel::log_metrics()
+    {
+        log(info)("[{}] Speculation hit rate {}", __func__, hit_rate());
+        for (auto &s : speculated)
+        {
+            if (s.node == nullptr)
+            {
+                continue;
+            }
+            log(info)("[{}]  - {}: hits {}, misses {}, skipped {}", __func__, s.node->name,
+                      s.statistics.hits, s.statistics.misses, s.statistics.skipped);
+        }
+    }
+
+    double SpeculativeSeidel::extrapolate(uint64_t t0, double v0, uint64_t t1, double v1, uint64_t t)
+    {
+        auto span = static_cast<double>(t1 - t0);
+        auto ahead = static_cast<double>(t) - static_cast<double>(t1);
+        return v1 + (v1 - v0) * ahead / span;
+    }
+
+    double SpeculativeSeidel::deviation(const std::vector<double> &predicted, const std::vector<double> &actual)
+    {
+        double result = 0.0;
+        for (std::size_t i = 0; i < actual.size(); i++)
+        {
+            result = std::max(result, std::abs(actual[i] - predicted[i]) / (1.0 + std::abs(actual[i])));
+        }
+        return result;
+    }
+
+    void SpeculativeSeidel::remember(Speculated &s, uint64_t input_time)
+    {
+        if (s.history > 0 && input_time == s.latest_time)
+        {
+            // A repeated step replaces its inputs
+            s.latest = s.actual;
+            return;
+        }
+
+        std::swap(s.previous, s.latest);
+        s.previous_time = s.latest_time;
+        s.latest = s.actual;
+        s.latest_time = input_time;
+        s.history = std::min(s.history + 1, 2);
+    }
+
+    bool SpeculativeSeidel::speculate(Speculated &s, const StepData &step)
+    {
+        if (s.history == 0)
+        {
+            return false;
+        }
+
+        if (!s.node->save_state())
+        {
+            log(info)("[{}] {} can not save its state and runs after its parents", __func__, s.node->name);
+            s.node = nullptr;
+            return false;
+        }
+
+        bool linear = order == 1 && s.history == 2 && s.previous_time < s.latest_time;
+        for (std::size_t i = 0; i < s.predicted.size(); i++)
+        {
+            s.predicted[i] = linear ? extrapolate(s.previous_time, s.previous[i], s.latest_time, s.latest[i], step.input_time) : s.latest[i];
+        }
+
+        s.node->step_with_inputs(step, s.predicted.data());
+        return true;
+    }
+
+    void SpeculativeSeidel::validate(Speculated &s, const StepData &step)
+    {
+        // Overwrites the speculated inputs with the final outputs of the parents
+        bool held = s.node->fetch_input_values(step.input_time, s.actual.data());
+        remember(s, step.input_time);
+
+        auto error = deviation(s.predicted, s.actual);
+        if (error <= tolerance && held)
+        {
+            s.statistics.hits += 1;
+            return;
+        }
+
+        IF_LOG({
+            log(debug)("[{}] Rollback of {} at {}, deviation {}", __func__, s.node->name, step.end_time, error);
+        });
+
+        s.statistics.misses += 1;
+        if (!s.node->restore_state())
+        {
+            throw std::runtime_error(Logger::format("[SpeculativeSeidel] Failed to restore the state of {}", s.node->name));
+        }
+        s.node->step_with_inputs(step, s.actual.data());
+    }
+
+    void SpeculativeSeidel::run(Speculated &s, const StepData &step)
+    {
+        s.node->fetch_input_values(step.input_time, s.actual.data());
+        remember(s, step.input_time);
+        s.node->step_with_inputs(step, s.actual.data());
+    }
+
+    uint64_t SpeculativeSeidel::invoke(StepData step_data)
+    {
+        IF_LOG({
+            log(trace)("[{}] step data: {}", __func__, step_data.to_string());
+        });
+
+        auto step = StepData(step_data.start_time, // start
+                             step_data.end_time,   // end
+                             sub_step,             // step_size
+                             step_data.end_time,   // it should be able to use results from the current iteration
+                             step_data.end_time);  // output_time
+
+        reset_counters();
+
+        auto macro_step = step_data.end_time - step_data.start_time;
+        auto body = [&](std::size_t i)
+        {
+            auto n = eager[i];
+            auto &s = speculated[n->id];
+            if (s.node == nullptr)
+            {
+                if (n->nr_parents == 0)
+                {
+                    n->node->invoke(step);
+                    n->invoked = true;
+                }
+                return;
+            }
+
+            // Slower nodes step ahead once per period, their inputs are not predicted
+            s.active = (s.node->step_size == 0 || s.node->step_size <= macro_step) && speculate(s, step);
+            if (!s.active)
+            {
+                s.statistics.skipped += 1;
+            }
+        };
+
+        // Sources and speculating nodes start at once
+        scheduler.parallel_for(eager.size(), body);
+
+        // Validate, or run, in dependency order on the final outputs of the parents
+        for (auto n : topological_order)
+        {
+            auto &s = speculated[n->id];
+            if (s.active)
+            {
+                validate(s, step);
+                s.active = false;
+            }
+            else if (!n->invoked && s.node != nullptr)
+            {
+                run(s, step);
+            }
+            else if (!n->invoked)
+            {
+                n->node->invoke(step);
+            }
+            n->invoked = true;
+        }
+
+        wait_for_result_collection();
+
+        return step_data.end_time;
+    }
+}
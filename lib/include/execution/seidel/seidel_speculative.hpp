@@ -0,0 +1,111 @@
+#pragma once
+
+#include "execution/seidel/seidel_base.hpp"
+
+#include "utils/task_scheduler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+    /**
+     * @brief Seidel executor that starts downstream models before their inputs are known
+     *
+     * Nodes with parents step at once on inputs extrapolated from the real inputs of their
+     * previous steps, in parallel with the source nodes. The step is then validated in
+     * topological order: the real inputs are fetched from the final outputs of the parents and
+     * compared with the speculation. If they deviate more than the tolerance, or other inputs
+     * changed, the node is rolled back with restore_state and redoes the step on the real inputs.
+     *
+     * Nodes speculate through Invocable::input_values and step_with_inputs. Nodes without real
+     * inputs, that can not save their state or that step slower than the macro step run after
+     * their parents like in SerialSeidel. Steps are sub-stepped like in SerialSeidel.
+     *
+     * Selected with "simulation.executor.seidel.speculate" and configured through
+     * "simulation.executor.seidel.speculative":
+     *  - tolerance: largest accepted |real - predicted| / (1 + |real|) (default simulation.tolerance or 1e-4)
+     *  - order: 0 holds the last input, 1 extrapolates linearly from the last two (default 1)
+     */
+    class SpeculativeSeidel final : public SeidelBase
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.SpeculativeSeidel", LogLevel::info);
+
+        double tolerance = 1e-4;
+        int order = 1;
+
+        struct Statistics
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            // Steps where the model could not speculate, such as the first step
+            uint64_t skipped = 0;
+        };
+
+        SpeculativeSeidel(std::vector<Invocable *> nodes);
+
+        std::string to_string() const override;
+
+        // Statistics of a node, indexed by node id
+        const Statistics &statistics(std::size_t id) const;
+
+        // Share of validated speculations that were kept
+        double hit_rate() const;
+
+        void log_metrics() override;
+
+        // hot path
+        uint64_t invoke(StepData step_data) override final;
+
+        // Value at t of the line through (t0, v0) and (t1, v1), t0 < t1
+        static double extrapolate(uint64_t t0, double v0, uint64_t t1, double v1, uint64_t t);
+
+        // Largest |actual - predicted| / (1 + |actual|)
+        static double deviation(const std::vector<double> &predicted, const std::vector<double> &actual);
+
+    private:
+        struct Speculated
+        {
+            Invocable *node = nullptr;
+
+            std::vector<double> predicted;
+            std::vector<double> actual;
+
+            // Real inputs of the last two steps, the source of the prediction
+            std::vector<double> latest;
+            std::vector<double> previous;
+            uint64_t latest_time = 0;
+            uint64_t previous_time = 0;
+            int history = 0;
+
+            // Speculated in the current step
+            bool active = false;
+
+            Statistics statistics;
+        };
+
+        utils::TaskScheduler &scheduler;
+
+        std::vector<SeidelNode *> topological_order;
+
+        // Indexed by node id
+        std::vector<Speculated> speculated;
+
+        // Nodes started in parallel at the beginning of a step, sources and speculating models
+        std::vector<SeidelNode *> eager;
+
+        // Step the node on predicted inputs, false if there is no history to predict from
+        bool speculate(Speculated &s, const StepData &step);
+
+        // Compare with the real inputs and redo the step when they deviate
+        void validate(Speculated &s, const StepData &step);
+
+        // Step on the real inputs without speculation
+        void run(Speculated &s, const StepData &step);
+
+        void remember(Speculated &s, uint64_t input_time);
+    };
+}
@@ -5,6 +5,8 @@
 #include "executor.hpp"
 #include "invocable.hpp"
 
+#include <algorithm>
+
 
 namespace ssp4sim::graph
 {
@@ -14,7 +16,7 @@ namespace ssp4sim::graph
         while (node->current_time < step_data.end_time)
         {
             auto substep_start = node->current_time;
-            auto substep_end = node->current_time + step_data.timestep;
+            auto substep_end = std::min(node->current_time + step_data.timestep, step_data.end_time);
 
             auto output_time = substep_end;
             if (node->delay == 0)
@@ -0,0 +1,173 @@
+#include "execution/step_controller.hpp"
+
+#include "config.hpp"
+#include "utils/time.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace ssp4sim::graph
+{
+
+    StepController::StepController(uint64_t timestep)
+    {
+        enabled = utils::Config::getOr("simulation.adaptive_step.enable", false);
+
+        auto timestep_s = utils::time::ns_to_s(timestep);
+        min_step = utils::time::s_to_ns(utils::Config::getOr("simulation.adaptive_step.min_step", timestep_s));
+        max_step = utils::time::s_to_ns(utils::Config::getOr("simulation.adaptive_step.max_step", timestep_s));
+        rel_tolerance = utils::Config::getOr("simulation.adaptive_step.rel_tolerance", rel_tolerance);
+        abs_tolerance = utils::Config::getOr("simulation.adaptive_step.abs_tolerance", abs_tolerance);
+        safety = utils::Config::getOr("simulation.adaptive_step.safety", safety);
+        min_factor = utils::Config::getOr("simulation.adaptive_step.min_factor", min_factor);
+        max_factor = utils::Config::getOr("simulation.adaptive_step.max_factor", max_factor);
+
+        if (min_step == 0 || min_step > max_step)
+        {
+            throw std::runtime_error(Logger::format("[{}] Invalid adaptive step bounds, min_step {} max_step {}", __func__, min_step, max_step));
+        }
+
+        reset(std::clamp(timestep, min_step, max_step));
+    }
+
+    void StepController::add_storage(signal::SignalStorage *storage)
+    {
+        for (auto &variable : storage->variables)
+        {
+            if (variable.type == types::DataType::real)
+            {
+                signals.push_back({storage, variable.index});
+            }
+        }
+        reset(step);
+    }
+
+    void StepController::reset(uint64_t initial_step)
+    {
+        step = initial_step;
+        last_error = 0.0;
+        history = 0;
+
+        previous.assign(signals.size(), 0.0);
+        current.assign(signals.size(), 0.0);
+        sample.assign(signals.size(), 0.0);
+    }
+
+    uint64_t StepController::next_step(uint64_t time, uint64_t end_time) const
+    {
+        if (time >= end_time)
+        {
+            return 0;
+        }
+
+        auto remaining = end_time - time;
+        auto s = std::min(step, remaining);
+
+        // Avoid leaving a sliver smaller than min_step at the end
+        if (remaining - s < min_step && remaining <= max_step)
+        {
+            s = remaining;
+        }
+        return s;
+    }
+
+    void StepController::read_signals(uint64_t time, std::vector<double> &values)
+    {
+        signal::SignalStorage *storage = nullptr;
+        std::size_t area = 0;
+        bool found = false;
+
+        for (std::size_t i = 0; i < signals.size(); i++)
+        {
+            auto &s = signals[i];
+            if (s.storage != storage)
+            {
+                storage = s.storage;
+                found = storage->find_latest_valid_area(time, area);
+            }
+
+            if (found)
+            {
+                values[i] = *reinterpret_cast<double *>(storage->get_item(area, s.index));
+            }
+        }
+    }
+
+    double StepController::estimate_error(uint64_t time) const
+    {
+        double error = 0.0;
+        auto ratio = static_cast<double>(time - current_time) / static_cast<double>(current_time - previous_time);
+
+        for (std::size_t i = 0; i < signals.size(); i++)
+        {
+            auto predicted = current[i] + (current[i] - previous[i]) * ratio;
+            auto scale = abs_tolerance + rel_tolerance * std::max(std::abs(sample[i]), std::abs(current[i]));
+            error = std::max(error, std::abs(sample[i] - predicted) / scale);
+        }
+        return error;
+    }
+
+    double StepController::update(uint64_t time)
+    {
+        if (history > 0 && time <= current_time)
+        {
+            return last_error;
+        }
+
+        read_signals(time, sample);
+
+        double error = 0.0;
+        if (history >= 2)
+        {
+            error = estimate_error(time);
+
+            // Residual of a linear extrapolation is O(h^2)
+            auto factor = max_factor;
+            if (error > 0.0)
+            {
+                factor = std::clamp(safety * std::pow(error, -0.5), min_factor, max_factor);
+            }
+
+            auto new_step = static_cast<uint64_t>(static_cast<double>(step) * factor);
+            new_step = std::clamp(new_step, min_step, max_step);
+
+            IF_LOG({
+                log(debug)("[{}] time {}, error {}, step {} -> {}", __func__, time, error, step, new_step);
+            });
+
+            if (error > 1.0)
+            {
+                violations += 1;
+            }
+            step = new_step;
+            last_error = error;
+        }
+
+        accepted += 1;
+        history = std::min<std::size_t>(history + 1, 2);
+
+        std::swap(previous, current);
+        std::swap(current, sample);
+        previous_time = current_time;
+        current_time = time;
+
+        return error;
+    }
+
+    std::string StepController::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "StepController { "
+            << "enabled: " << enabled
+            << ", signals: " << signals.size()
+            << ", min_step: " << min_step
+            << ", max_step: " << max_step
+            << ", step: " << step
+            << ", accepted: " << accepted
+            << ", violations: " << violations
+            << " }";
+        return oss.str();
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include "signal/storage.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+
+    /**
+     * @brief Adaptive communication (macro) step controller
+     *
+     * The coupling error of a macro step is estimated from extrapolation residuals:
+     * each real output is linearly extrapolated from the two previous communication points
+     * and compared with the value the model actually produced. The normalized residual
+     * is used by an elementary controller to grow or shrink the next macro step
+     * within [min_step, max_step].
+     *
+     * A step is never repeated, there is no rollback of the models. A too large error
+     * only makes the following step smaller.
+     *
+     * Configured through "simulation.adaptive_step"
+     */
+    class StepController
+    {
+    public:
+        Logger log = Logger("ssp4sim.execution.StepController", LogLevel::info);
+
+        struct Signal
+        {
+            signal::SignalStorage *storage;
+            std::size_t index;
+        };
+
+        bool enabled = false;
+
+        uint64_t min_step = 0;
+        uint64_t max_step = 0;
+
+        double rel_tolerance = 1e-3;
+        double abs_tolerance = 1e-6;
+        double safety = 0.9;
+        double min_factor = 0.2;
+        double max_factor = 2.0;
+
+        uint64_t step = 0;
+        double last_error = 0.0;
+
+        uint64_t accepted = 0;
+        uint64_t violations = 0;
+
+        std::vector<Signal> signals;
+
+        StepController() = default;
+
+        // Reads the settings from the config, timestep is used as initial step and default bounds
+        StepController(uint64_t timestep);
+
+        // Track all real valued signals in the storage
+        void add_storage(signal::SignalStorage *storage);
+
+        // Set the initial step and clear the extrapolation history
+        void reset(uint64_t initial_step);
+
+        // Step to take from time, never passing end_time
+        uint64_t next_step(uint64_t time, uint64_t end_time) const;
+
+        // Sample the tracked signals at time and adapt the step, returns the normalized error
+        double update(uint64_t time);
+
+        std::string to_string() const;
+
+    private:
+        std::vector<double> previous;
+        std::vector<double> current;
+        std::vector<double> sample;
+
+        uint64_t previous_time = 0;
+        uint64_t current_time = 0;
+        std::size_t history = 0;
+
+        void read_signals(uint64_t time, std::vector<double> &values);
+
+        double estimate_error(uint64_t time) const;
+    };
+}
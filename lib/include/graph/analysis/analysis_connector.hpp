@@ -39,7 +39,8 @@ namespace ssp4sim::analysis::graph
         uint64_t value_reference;
 
         types::DataType type;
-        std::size_t size;
+        std::size_t size;      // total size in bytes
+        std::size_t count = 1; // number of elements, > 1 for array variables
 
         // for start value / parameter
         std::unique_ptr<ssp4sim::ext::ssp1::ssv::StartValue> initial_value = nullptr;
@@ -44,6 +44,11 @@ namespace ssp4sim::analysis::graph
         {
             oss << "Model: " << model->to_string() << "\n";
         }
+
+        for (auto &system : systems)
+        {
+            oss << "System: " << system.name << ", parent: '" << system.parent << "', components: " << system.components.size() << "\n";
+        }
         return oss.str();
     }
 
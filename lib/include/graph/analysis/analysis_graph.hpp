@@ -13,6 +13,16 @@
 
 namespace ssp4sim::analysis::graph
 {
+    // A system nested in the top level system, executed as a graph of its own
+    struct AnalysisSystem
+    {
+        std::string name;
+        // Enclosing system, empty for the top level system
+        std::string parent;
+        // Components directly in this system
+        std::vector<std::string> components;
+    };
+
     class AnalysisGraph : public types::IWritable
     {
     public:
@@ -24,6 +34,9 @@ namespace ssp4sim::analysis::graph
 
         std::vector<AnalysisModel *> nodes;
 
+        // Depth first, an enclosing system comes before the systems it contains
+        std::vector<AnalysisSystem> systems;
+
         AnalysisGraph() = default;
 
         AnalysisGraph(std::map<std::string, std::unique_ptr<AnalysisModel>> models_,
@@ -10,6 +10,7 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "SSP1_SystemStructureDescription_Ext.hpp"
 #include "FMI2_modelDescription_Ext.hpp"
@@ -34,12 +35,18 @@ namespace ssp4sim::analysis::graph
             auto fmu = fmu_handler->fmu_info_map[ssp_resource_name].get();
             auto m = std::make_unique<AnalysisModel>(ssp_resource_name, resource->source, fmu);
 
-            if (fmu->model_description->CoSimulation)
+            if (fmu->model_description && fmu->model_description->CoSimulation)
             {
                 auto co_sim = *fmu->model_description->CoSimulation;
                 m->set_interpolation_data(co_sim.canInterpolateInputs.value_or(false), co_sim.maxOutputDerivativeOrder.value_or(0));
             }
 
+            if (models.contains(m->name))
+            {
+                log(error)("[{}] Component name {} is used in more than one system", __func__, m->name);
+                throw std::runtime_error("Component names must be unique across nested systems");
+            }
+
             log(trace)("[{}] New Model: {}", __func__, m->name);
             models[m->name] = std::move(m);
         }
@@ -56,8 +63,9 @@ namespace ssp4sim::analysis::graph
 
             auto mapping_start_values = ssp4sim::ext::ssp1::ssv::get_start_value_mappings(ssp);
 
-            for (auto &component : ssp.ssd->System.Elements.value().Components)
+            for (auto component_ptr : ext::ssp::get_resources(*ssp.ssd))
             {
+                auto &component = *component_ptr;
                 if (!component.name.has_value())
                 {
                     log(error)("[{}] Component does not specify name attribute, Its optional but needed for this application {}", __func__);
@@ -73,6 +81,12 @@ namespace ssp4sim::analysis::graph
                 }
                 auto fmu = fmu_handler->fmu_info_map[component_name].get();
 
+                if (fmu->is_fmi3())
+                {
+                    create_fmi3_connectors(component_name, fmu, items);
+                    continue;
+                }
+
                 auto md = fmu->model_description;
 
                 auto variables = ext::fmi2::model_variables::get_variables(*md, {types::Causality::input, types::Causality::output, types::Causality::parameter});
@@ -122,30 +136,105 @@ namespace ssp4sim::analysis::graph
         return items;
     }
 
+    void AnalysisGraphBuilder::create_fmi3_connectors(const std::string &component_name,
+                                                      handler::FmuInfo *fmu,
+                                                      std::map<std::string, std::unique_ptr<AnalysisConnector>> &items)
+    {
+        for (auto &var : handler::get_fmi3_variables(*fmu->fmi_instance))
+        {
+            types::Causality causality;
+            if (var.causality == fmi3CausalityInput)
+                causality = types::Causality::input;
+            else if (var.causality == fmi3CausalityOutput)
+                causality = types::Causality::output;
+            else if (var.causality == fmi3CausalityParameter)
+                causality = types::Causality::parameter;
+            else
+                continue;
+
+            types::DataType type;
+            if (var.type == fmi3DataTypeFloat64)
+                type = types::DataType::real;
+            else if (var.type == fmi3DataTypeInt32)
+                type = types::DataType::integer;
+            else if (var.type == fmi3DataTypeBoolean)
+                type = types::DataType::boolean;
+            else if (var.type == fmi3DataTypeString)
+                type = types::DataType::string;
+            else
+            {
+                log(warning)("[{}] Skipping {}.{}, unsupported FMI 3.0 data type {}", __func__, component_name, var.name, static_cast<int>(var.type));
+                continue;
+            }
+
+            if (var.count > 1 && type != types::DataType::real)
+            {
+                log(warning)("[{}] Skipping {}.{}, only Float64 arrays are supported", __func__, component_name, var.name);
+                continue;
+            }
+
+            log(debug)("[{}] Creating FMI 3.0 Connector: {}.{}, elements {}", __func__, component_name, var.name, var.count);
+            auto c = std::make_unique<AnalysisConnector>(component_name, var.name, var.value_reference, type);
+            c->causality = causality;
+            c->count = var.count;
+            c->size = c->size * var.count;
+
+            items[c->name] = std::move(c);
+        }
+    }
+
     std::map<std::string, std::unique_ptr<AnalysisConnection>> AnalysisGraphBuilder::create_connections(ssp4cpp::Ssp &ssp)
     {
         log(ext_trace)("[{}] init", __func__);
         std::map<std::string, std::unique_ptr<AnalysisConnection>> items;
-        if (ssp.ssd->System.Connections.has_value())
+        // Connections through the connectors of nested systems are joined end to end
+        for (auto &connection : ext::ssp1::elements::get_component_connections(*ssp.ssd))
         {
-            for (auto &connection : ssp.ssd->System.Connections.value().Connections)
-            {
-                auto c = std::make_unique<AnalysisConnection>(&connection);
-                log(trace)("[{}] New Connection: {}", __func__, c->name);
-                c->delay = utils::time::s_to_ns(connection.information_delay.value_or(0));
-                items[c->name] = std::move(c);
-            }
+            auto c = std::make_unique<AnalysisConnection>(&connection);
+            log(trace)("[{}] New Connection: {}", __func__, c->name);
+            c->delay = utils::time::s_to_ns(connection.information_delay.value_or(0));
+            items[c->name] = std::move(c);
         }
         log(ext_trace)("[{}] exit, Total connections created: {}", __func__, items.size());
         return items;
     }
 
+    std::vector<AnalysisSystem> AnalysisGraphBuilder::create_systems(ssp4cpp::Ssp &ssp)
+    {
+        log(ext_trace)("[{}] init", __func__);
+        std::vector<AnalysisSystem> systems;
+        for (auto &sub_system : ext::ssp1::ssd::get_sub_systems(*ssp.ssd))
+        {
+            AnalysisSystem system;
+            system.name = sub_system.name;
+            system.parent = sub_system.parent;
+
+            if (sub_system.system->Elements.has_value())
+            {
+                for (auto &component : sub_system.system->Elements.value().Components)
+                {
+                    system.components.push_back(component.name.value_or("null"));
+                }
+            }
+
+            log(debug)("[{}] New System: {}, parent: '{}', components: {}", __func__, system.name, system.parent, system.components.size());
+            systems.push_back(std::move(system));
+        }
+        log(ext_trace)("[{}] exit, Total systems created: {}", __func__, systems.size());
+        return systems;
+    }
+
     std::map<std::string, std::unique_ptr<AnalysisModelVariable>> AnalysisGraphBuilder::create_model_variables(std::map<std::string, ssp4cpp::Fmu *> &fmu_map)
     {
         log(warning)("[{}] init, deprecated", __func__);
         std::map<std::string, std::unique_ptr<AnalysisModelVariable>> items;
         for (auto &[name, fmu] : fmu_map)
         {
+            if (!fmu->md)
+            {
+                continue;
+            }
+
             for (auto &variable : fmu->md->ModelVariables.ScalarVariable)
             {
                 auto mv = std::make_unique<AnalysisModelVariable>(name, variable.name);
@@ -252,8 +341,11 @@ namespace ssp4sim::analysis::graph
         // possible to add internal connections as well
         // see below
 
+        auto graph = make_unique<AnalysisGraph>(std::move(models), std::move(connectors), std::move(connections));
+        graph->systems = create_systems(*ssp);
+
         log(ext_trace)("[{}] exit", __func__);
-        return make_unique<AnalysisGraph>(std::move(models), std::move(connectors), std::move(connections));
+        return graph;
     }
 
 }
@@ -12,6 +12,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace ssp4sim::analysis::graph
 {
@@ -30,8 +31,16 @@ namespace ssp4sim::analysis::graph
 
         std::map<std::string, std::unique_ptr<AnalysisConnector>> create_connectors(ssp4cpp::Ssp &ssp);
 
+        // FMI 3.0 variables are read through fmi4c, array variables become one connector
+        void create_fmi3_connectors(const std::string &component_name,
+                                    handler::FmuInfo *fmu,
+                                    std::map<std::string, std::unique_ptr<AnalysisConnector>> &items);
+
         std::map<std::string, std::unique_ptr<AnalysisConnection>> create_connections(ssp4cpp::Ssp &ssp);
 
+        // Nested systems of the ssd, the top level system is the graph itself
+        std::vector<AnalysisSystem> create_systems(ssp4cpp::Ssp &ssp);
+
         std::map<std::string, std::unique_ptr<AnalysisModelVariable>> create_model_variables(std::map<std::string, ssp4cpp::Fmu *> &fmu_map);
 
         std::unique_ptr<AnalysisGraph> build();
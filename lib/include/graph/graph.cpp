@@ -3,12 +3,20 @@
 #include "execution/executor.hpp"
 #include "execution/executor_builder.hpp"
 #include "graph/graph_builder.hpp"
+#include "model/model_fmu.hpp"
+#include "model/model_me_group.hpp"
+#include "config.hpp"
 #include "utils/map.hpp"
 #include "signal/recorder.hpp"
 
 #include "tarjan.hpp"
+#include "utils/time.hpp"
+#include "utils/timer.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <stdexcept>
 
 namespace ssp4sim::graph
 {
@@ -37,15 +45,175 @@ namespace ssp4sim::graph
         return oss.str();
     }
 
+    void Graph::build_executor()
+    {
+        if (!executor)
+        {
+            executor = nested ? ExecutorBuilder().build(nodes, executor_config) : ExecutorBuilder().build(nodes);
+            executor->set_recorder(recorder);
+        }
+
+        // The builder patches the global config, so nested executors are built here, one at a
+        // time, and never while the nodes initialize in parallel
+        for (auto &node : nodes)
+        {
+            if (auto system = dynamic_cast<Graph *>(node))
+            {
+                system->build_executor();
+            }
+        }
+    }
+
     void Graph::init()
     {
         log(trace)("[{}] Initializing Graph", __func__);
 
-        executor = ExecutorBuilder().build(nodes);
-        executor->set_recorder(recorder);
+        build_executor();
+
+        if (nested)
+        {
+            Invocable::init();
+            return;
+        }
 
         log(trace)("[{}] - Initializing executor ", __func__);
         executor->init();
+
+        step_controller = StepController(utils::time::s_to_ns(utils::Config::getDouble("simulation.timestep")));
+        if (step_controller.enabled)
+        {
+            auto add_storages = [this](auto &self, const std::vector<Invocable *> &graph_nodes) -> void
+            {
+                for (auto &node : graph_nodes)
+                {
+                    if (auto model = dynamic_cast<FmuModel *>(node))
+                    {
+                        step_controller.add_storage(model->output_area.get());
+                    }
+                    else if (auto group = dynamic_cast<ModelExchangeGroup *>(node))
+                    {
+                        for (auto &member : group->members)
+                        {
+                            step_controller.add_storage(member.model->output_area.get());
+                        }
+                    }
+                    else if (auto system = dynamic_cast<Graph *>(node))
+                    {
+                        self(self, system->nodes);
+                    }
+                }
+            };
+            add_storages(add_storages, nodes);
+            log(info)("[{}] Adaptive step enabled, {}", __func__, step_controller.to_string());
+        }
+
+        pacer = RealTimePacer(nodes);
+        if (pacer.enabled)
+        {
+            log(info)("[{}] Real-time pacing enabled, factor {}", __func__, pacer.factor);
+        }
+    }
+
+    void Graph::enter_init()
+    {
+        log(trace)("[{}] Initializing nested system {}", __func__, name);
+
+        if (!executor)
+        {
+            throw std::runtime_error(Logger::format("[Graph] The executor of nested system {} is built by Graph::init", name));
+        }
+
+        // The executor of the enclosing system initializes its nodes, so do the same for ours
+        for (auto &node : nodes)
+        {
+            node->enter_init();
+        }
+    }
+
+    void Graph::exit_init()
+    {
+        for (auto &node : nodes)
+        {
+            node->exit_init();
+        }
+    }
+
+    bool Graph::save_state()
+    {
+        bool saved = true;
+        for (auto &node : nodes)
+        {
+            saved = node->save_state() && saved;
+        }
+        return saved;
+    }
+
+    bool Graph::restore_state()
+    {
+        bool restored = true;
+        for (auto &node : nodes)
+        {
+            restored = node->restore_state() && restored;
+        }
+        if (!nodes.empty())
+        {
+            current_time = std::ranges::min(nodes, {}, &Invocable::current_time)->current_time;
+        }
+        return restored;
+    }
+
+    bool Graph::save_snapshot(std::vector<std::byte> &snapshot)
+    {
+        snapshot.clear();
+        std::vector<std::byte> part;
+        for (auto &node : nodes)
+        {
+            if (!node->save_snapshot(part))
+            {
+                return false;
+            }
+
+            uint64_t size = part.size();
+            auto offset = snapshot.size();
+            snapshot.resize(offset + sizeof(size) + part.size());
+            std::memcpy(snapshot.data() + offset, &size, sizeof(size));
+            std::copy(part.begin(), part.end(), snapshot.begin() + offset + sizeof(size));
+        }
+        return true;
+    }
+
+    bool Graph::load_snapshot(const std::vector<std::byte> &snapshot)
+    {
+        std::size_t offset = 0;
+        std::vector<std::byte> part;
+        for (auto &node : nodes)
+        {
+            uint64_t size = 0;
+            if (offset + sizeof(size) > snapshot.size())
+            {
+                return false;
+            }
+            std::memcpy(&size, snapshot.data() + offset, sizeof(size));
+            offset += sizeof(size);
+
+            if (offset + size > snapshot.size())
+            {
+                return false;
+            }
+            part.assign(snapshot.begin() + offset, snapshot.begin() + offset + size);
+            offset += size;
+
+            if (!node->load_snapshot(part))
+            {
+                return false;
+            }
+        }
+
+        if (!nodes.empty())
+        {
+            current_time = std::ranges::min(nodes, {}, &Invocable::current_time)->current_time;
+        }
+        return offset == snapshot.size();
     }
 
     uint64_t Graph::invoke(StepData step_data)
@@ -54,10 +222,26 @@ namespace ssp4sim::graph
             log(trace)("[{}] Invoking Graph, full step: {}", __func__, step_data.to_string());
         });
 
+        auto walltime = utils::time::Timer();
+
+        if (pacer.enabled)
+        {
+            return invoke_paced(step_data);
+        }
+
+        if (step_controller.enabled)
+        {
+            return invoke_adaptive(step_data);
+        }
+
+        // A nested system steps with its own timestep, the last step ends with the enclosing step
+        auto timestep = step_size != 0 ? step_size : step_data.timestep;
+
         auto t = step_data.start_time;
         while (t < step_data.end_time)
         {
-            auto s = StepData(t, t + step_data.timestep, step_data.timestep);
+            auto h = nested ? std::min(timestep, step_data.end_time - t) : timestep;
+            auto s = StepData(t, t + h, h);
 
             IF_LOG({
                 log(debug)("[{}] Graph executing step: {}", __func__, s.to_string());
@@ -65,8 +249,85 @@ namespace ssp4sim::graph
 
             executor->invoke(s);
 
-            t += step_data.timestep;
+            t += h;
         }
+
+        current_time = t;
+        if (nested)
+        {
+            walltime_ns += walltime.stop();
+        }
+        return t;
+    }
+
+    uint64_t Graph::invoke_adaptive(StepData step_data)
+    {
+        auto t = step_data.start_time;
+        while (t < step_data.end_time)
+        {
+            auto h = step_controller.next_step(t, step_data.end_time);
+            auto s = StepData(t, t + h, h);
+
+            IF_LOG({
+                log(debug)("[{}] Graph executing adaptive step: {}", __func__, s.to_string());
+            });
+
+            executor->invoke(s);
+
+            t += h;
+            step_controller.update(t);
+        }
+
+        log(info)("[{}] {}", __func__, step_controller.to_string());
+        return t;
+    }
+
+    uint64_t Graph::invoke_paced(StepData step_data)
+    {
+        auto slack = [this]()
+        { executor->use_slack(); };
+
+        pacer.start(step_data.start_time);
+
+        auto t = step_data.start_time;
+        while (t < step_data.end_time)
+        {
+            auto h = step_controller.enabled ? step_controller.next_step(t, step_data.end_time) : step_data.timestep;
+            auto s = StepData(t, t + h, h);
+
+            if (recorder && pacer.skip_recording)
+            {
+                if (pacer.under_pressure())
+                {
+                    recorder->pause();
+                }
+                else
+                {
+                    recorder->resume();
+                }
+            }
+
+            IF_LOG({
+                log(debug)("[{}] Graph executing paced step: {}", __func__, s.to_string());
+            });
+
+            executor->invoke(s);
+
+            t += h;
+            if (step_controller.enabled)
+            {
+                step_controller.update(t);
+            }
+
+            pacer.pace(s.start_time, t, slack);
+        }
+
+        if (recorder)
+        {
+            recorder->resume();
+        }
+
+        log(info)("[{}] {}", __func__, pacer.to_string());
         return t;
     }
 
@@ -4,11 +4,16 @@
 
 #include "invocable.hpp"
 #include "executor.hpp"
+#include "realtime_pacer.hpp"
+#include "step_controller.hpp"
 
 #include "signal/recorder.hpp"
 
 #include "cutecpp/log.hpp"
 
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -18,6 +23,14 @@
 
 namespace ssp4sim::graph
 {
+    /**
+     * @brief Execution graph of a system, the top level system or a nested one
+     *
+     * A nested system is a node in the graph of its enclosing system. It has its own executor,
+     * built from "simulation.executor" patched with "simulation.systems.<name>.executor", and
+     * runs its nodes in steps of "simulation.systems.<name>.timestep" within the step of the
+     * enclosing system. Adaptive steps and real-time pacing only apply to the top level.
+     */
     class Graph final : public Invocable
     {
     public:
@@ -29,15 +42,44 @@ namespace ssp4sim::graph
         std::unique_ptr<ExecutionBase> executor;
         ssp4sim::signal::DataRecorder *recorder = nullptr;
 
+        StepController step_controller;
+        RealTimePacer pacer;
+
+        // Nested systems are initialized and stepped by the executor of the enclosing system
+        bool nested = false;
+        nlohmann::json executor_config = nlohmann::json::object();
+
         Graph() = default;
 
         Graph(std::map<std::string, Invocable *> node_map, ssp4sim::signal::DataRecorder *recorder);
 
         std::string to_string() const override;
 
-        void init();
+        void init() override;
+
+        void enter_init() override;
+
+        void exit_init() override;
+
+        bool save_state() override;
+
+        bool restore_state() override;
+
+        // The snapshots of the nodes one after the other, each prefixed by its size
+        bool save_snapshot(std::vector<std::byte> &snapshot) override;
+
+        bool load_snapshot(const std::vector<std::byte> &snapshot) override;
 
         uint64_t invoke(StepData step_data) override final;
+
+        // Macro steps sized by the step controller, see "simulation.adaptive_step"
+        uint64_t invoke_adaptive(StepData step_data);
+
+        // Macro steps paced to the wall clock, see "simulation.real_time"
+        uint64_t invoke_paced(StepData step_data);
+
+    private:
+        void build_executor();
     };
 
 }
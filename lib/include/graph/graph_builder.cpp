@@ -4,11 +4,17 @@
 #include "graph/analysis/analysis_model.hpp"
 #include "graph/analysis/analysis_connection.hpp"
 #include "model/model_fmu.hpp"
+#include "model/model_me_group.hpp"
 #include "utils/map.hpp"
+#include "utils/time.hpp"
+
+#include "config.hpp"
 
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 namespace ssp4sim::graph
 {
@@ -41,13 +47,14 @@ namespace ssp4sim::graph
             {
                 int index = -1;
                 if (connector->causality == types::Causality::input)
-                    index = model->input_area->add(name, connector->type, connector->forward_derivatives_order);
+                    index = model->input_area->add(name, connector->type, connector->forward_derivatives_order, connector->count);
                 else if (connector->causality == types::Causality::output)
-                    index = model->output_area->add(name, connector->type, connector->forward_derivatives_order);
+                    index = model->output_area->add(name, connector->type, connector->forward_derivatives_order, connector->count);
 
                 ConnectorInfo info;
                 info.type = connector->type;
                 info.size = connector->size;
+                info.count = connector->count;
                 info.name = name;
 
                 info.forward_derivatives = connector->forward_derivatives;
@@ -83,6 +90,8 @@ namespace ssp4sim::graph
         }
 
         log(trace)("[{}] - Hand the information regarding the connections over to the model", __func__);
+        auto macro_step = utils::time::s_to_ns(utils::Config::getDouble("simulation.timestep"));
+        auto interpolate_rates = utils::Config::getOr("simulation.multi_rate.interpolate", false);
         for (auto &[_, connection] : analysis_graph->connections)
         {
             auto source_model = static_cast<FmuModel *>(models[connection->source_model->name].get());
@@ -91,6 +100,12 @@ namespace ssp4sim::graph
             auto &source_connector = source_model->outputs[connection->get_source_connector_name()];
             auto &target_connector = target_model->inputs[connection->get_target_connector_name()];
 
+            if (source_connector.size != target_connector.size)
+            {
+                log(error)("[{}] Connection {} connects signals of different size, {} and {}", __func__, connection->name, source_connector.size, target_connector.size);
+                throw std::runtime_error("Connection size mismatch");
+            }
+
             ConnectionInfo con_info;
             con_info.type = source_connector.type;
             con_info.size = source_connector.size;
@@ -106,6 +121,11 @@ namespace ssp4sim::graph
             con_info.delay = connection->delay;
             log(debug)("Connection: {}, delay {}", connection->name, connection->delay);
 
+            // Slow models lead the simulation, faster consumers can interpolate towards their next sample
+            auto effective_step = [&](FmuModel *m)
+            { return m->step_size != 0 ? m->step_size : macro_step; };
+            con_info.interpolate = interpolate_rates && effective_step(source_model) > effective_step(target_model);
+
             target_model->connections.push_back(std::move(con_info));
         }
 
@@ -131,12 +151,152 @@ namespace ssp4sim::graph
             }
         }
 
+        group_model_exchange();
+
+        group_systems();
+
         log(ext_trace)("[{}] exit", __func__);
     }
 
+    void GraphBuilder::group_model_exchange()
+    {
+        std::vector<FmuModel *> members;
+        for (auto &[name, model] : models)
+        {
+            auto m = static_cast<FmuModel *>(model.get());
+            if (m->fmu->is_model_exchange())
+            {
+                members.push_back(m);
+                grouped_models.insert(name);
+            }
+        }
+
+        if (members.empty())
+        {
+            return;
+        }
+
+        log(trace)("[{}] - Group {} model exchange fmus", __func__, members.size());
+        auto group = std::make_unique<ModelExchangeGroup>(model_exchange_group_name, members);
+
+        // The group takes over all connections to and from the members
+        for (auto &member : members)
+        {
+            auto children = member->children;
+            for (auto &child : children)
+            {
+                if (!grouped_models.contains(child->name))
+                {
+                    group->add_child(child);
+                }
+                member->remove_child(child);
+            }
+
+            auto parents = member->parents;
+            for (auto &parent : parents)
+            {
+                if (!grouped_models.contains(parent->name))
+                {
+                    group->add_parent(parent);
+                }
+                member->remove_parent(parent);
+            }
+        }
+
+        models[model_exchange_group_name] = std::move(group);
+    }
+
+    void GraphBuilder::group_systems()
+    {
+        auto &systems = analysis_graph->systems;
+        auto systems_config = utils::Config::resolvePath("simulation.systems");
+
+        // The innermost systems first, their graphs are nodes of the enclosing system
+        for (auto it = systems.rbegin(); it != systems.rend(); ++it)
+        {
+            auto &system = *it;
+            if (models.contains(system.name))
+            {
+                log(error)("[{}] System {} has the same name as another node", __func__, system.name);
+                throw std::runtime_error("System names must be unique among the components and systems");
+            }
+
+            std::map<std::string, Invocable *> members;
+            for (auto &component : system.components)
+            {
+                if (grouped_models.contains(component))
+                {
+                    log(warning)("[{}] {} in system {} is a model exchange fmu, it stays in the {}", __func__, component, system.name, model_exchange_group_name);
+                    continue;
+                }
+                members[component] = models.at(component).get();
+            }
+            for (auto &child : systems)
+            {
+                if (child.parent == system.name)
+                {
+                    members[child.name] = models.at(child.name).get();
+                }
+            }
+
+            auto graph = std::make_unique<Graph>(members, recorder);
+            graph->name = system.name;
+            graph->nested = true;
+
+            if (systems_config != nullptr && systems_config->contains(system.name))
+            {
+                auto &config = (*systems_config)[system.name];
+                graph->step_size = utils::time::s_to_ns(config.value("timestep", 0.0));
+                graph->executor_config = config.value("executor", nlohmann::json::object());
+            }
+            if (graph->step_size != 0 && !graph->executor_config.contains("sub_step"))
+            {
+                graph->executor_config["sub_step"] = utils::time::ns_to_s(graph->step_size);
+            }
+
+            log(trace)("[{}] - System {} with {} nodes, step {}", __func__, system.name, members.size(), graph->step_size);
+
+            // The system takes over all connections that leave it
+            for (auto &[name, member] : members)
+            {
+                auto children = member->children;
+                for (auto &child : children)
+                {
+                    if (!members.contains(child->name))
+                    {
+                        graph->add_child(child);
+                        member->remove_child(child);
+                    }
+                }
+
+                auto parents = member->parents;
+                for (auto &parent : parents)
+                {
+                    if (!members.contains(parent->name))
+                    {
+                        graph->add_parent(parent);
+                        member->remove_parent(parent);
+                    }
+                }
+                nested_nodes.insert(name);
+            }
+
+            models[system.name] = std::move(graph);
+        }
+    }
+
     std::unique_ptr<Graph> GraphBuilder::get_graph()
     {
-        return std::make_unique<Graph>(ssp4sim::utils::map_ns::map_unique_to_ref(models), recorder);
+        auto node_map = ssp4sim::utils::map_ns::map_unique_to_ref(models);
+        for (auto &name : grouped_models)
+        {
+            node_map.erase(name);
+        }
+        for (auto &name : nested_nodes)
+        {
+            node_map.erase(name);
+        }
+        return std::make_unique<Graph>(node_map, recorder);
     }
 
     std::map<std::string, std::unique_ptr<Invocable>> GraphBuilder::get_models()
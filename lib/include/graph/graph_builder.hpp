@@ -10,6 +10,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 
 namespace ssp4sim::graph
@@ -27,10 +28,22 @@ namespace ssp4sim::graph
 
         std::map<std::string, std::unique_ptr<Invocable>> models;
 
+        // Model exchange fmus, owned by models but invoked through the group
+        std::set<std::string> grouped_models;
+        inline static const std::string model_exchange_group_name = "model_exchange_group";
+
+        // Nodes of nested systems, owned by models but invoked through the graph of their system
+        std::set<std::string> nested_nodes;
+
         GraphBuilder(AnalysisGraph *ag, ssp4sim::signal::DataRecorder *recorder);
 
         void build();
 
+        void group_model_exchange();
+
+        // Nested ssp systems become Graph nodes, configured through "simulation.systems.<name>"
+        void group_systems();
+
         std::unique_ptr<Graph> get_graph();
 
         std::map<std::string, std::unique_ptr<Invocable>> get_models();
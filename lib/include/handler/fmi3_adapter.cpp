@@ -0,0 +1,538 @@
+#include "handler/fmi3_adapter.hpp"
+#include "handler/fmu_log_sink.hpp"
+
+#include "utils/time.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace ssp4sim::handler
+{
+    bool is_status_ok(fmi3Status status)
+    {
+        return status == fmi3OK;
+    }
+
+    std::vector<Fmi3VariableInfo> get_fmi3_variables(FmuInstance &instance)
+    {
+        std::vector<Fmi3VariableInfo> variables;
+
+        auto fmu = instance.raw();
+        auto nr_variables = fmi3_getNumberOfVariables(fmu);
+        for (int i = 0; i < nr_variables; i++)
+        {
+            auto var = fmi3_getVariableByIndex(fmu, i);
+            if (var == nullptr)
+            {
+                continue;
+            }
+
+            Fmi3VariableInfo info;
+            info.name = fmi3_getVariableName(var);
+            info.value_reference = fmi3_getVariableValueReference(var);
+            info.causality = fmi3_getVariableCausality(var);
+            info.type = fmi3_getVariableDataType(var);
+
+            auto dimensions = fmi3_getVariableNumberOfDimensions(var);
+            for (int d = 0; d < dimensions; d++)
+            {
+                auto dimension = fmi3_getVariableDimensionByIndex(var, d);
+                if (!fmi3_getDimensionHasStart(dimension))
+                {
+                    throw std::runtime_error(Logger::format("Variable {} in '{}' has a structural dimension, only fixed dimensions are supported", info.name, instance.path()));
+                }
+                info.count *= static_cast<std::size_t>(fmi3_getDimensionStart(dimension));
+            }
+
+            variables.push_back(std::move(info));
+        }
+        return variables;
+    }
+
+    static void fmi3Logger(fmi3InstanceEnvironment env,
+                           fmi3Status status,
+                           fmi3String category,
+                           fmi3String message)
+    {
+        auto my_env = (MyEnv *)env;
+        if (!my_env->accepts(status, category))
+        {
+            return;
+        }
+
+        FmuLogSink::instance().push(my_env->instance_name.c_str(), status, category, message);
+    }
+
+    static void fmi3IntermediateUpdate(fmi3InstanceEnvironment env,
+                                       fmi3Float64 intermediateUpdateTime,
+                                       fmi3Boolean intermediateVariableSetRequested,
+                                       fmi3Boolean intermediateVariableGetAllowed,
+                                       fmi3Boolean intermediateStepFinished,
+                                       fmi3Boolean canReturnEarly,
+                                       fmi3Boolean *earlyReturnRequested,
+                                       fmi3Float64 *earlyReturnTime)
+    {
+        // Early return is left to the fmu, it returns at its own events
+        (void)env;
+        (void)intermediateUpdateTime;
+        (void)intermediateVariableSetRequested;
+        (void)intermediateVariableGetAllowed;
+        (void)intermediateStepFinished;
+        (void)canReturnEarly;
+        (void)earlyReturnTime;
+        *earlyReturnRequested = false;
+    }
+
+    Fmi3CoSimulationModel::Fmi3CoSimulationModel(FmuInstance &instance) : instance_(instance)
+    {
+    }
+
+    Fmi3CoSimulationModel::~Fmi3CoSimulationModel()
+    {
+        terminate();
+    }
+
+    bool Fmi3CoSimulationModel::instantiate(bool visible, bool logging_on)
+    {
+        if (instantiated_)
+        {
+            return true;
+        }
+
+        if (instance_.version() != fmiVersion3)
+        {
+            throw std::runtime_error("Fmi3CoSimulationModel requires a FMI 3.0 FMU");
+        }
+
+        if (!instance_.supports_co_simulation())
+        {
+            throw std::runtime_error(Logger::format("FMU '{}' does not support co-simulation", instance_.path()));
+        }
+
+        early_return_allowed = early_return_allowed && fmi3cs_getCanReturnEarlyAfterIntermediateUpdate(instance_.raw());
+
+        log(debug)("[{}] Instantiating FMU {}, early return {}", __func__, instance_.path(), early_return_allowed);
+        detail::ensure_message_callback_registered();
+        detail::clear_last_message();
+
+        env.instance_name = instance_.instance_name();
+        env.enabled = logging_on;
+        env.categories = log_categories;
+
+        handle = fmi3_instantiateCoSimulation(instance_.raw(),
+                                              visible,
+                                              logging_on,
+                                              false, // eventModeUsed
+                                              early_return_allowed,
+                                              nullptr, // requiredIntermediateVariables
+                                              0,
+                                              &env,
+                                              fmi3Logger,
+                                              fmi3IntermediateUpdate);
+
+        bool success = handle != nullptr;
+        instantiated_ = success;
+        last_status_ = success ? fmi3OK : fmi3Error;
+        current_time_ = 0;
+
+        if (!success)
+        {
+            auto message = detail::consume_last_message();
+            throw std::runtime_error(Logger::format("Failed to instantiate FMU '{}': {}", instance_.path(), message.empty() ? "unknown error" : message));
+        }
+
+        if (logging_on && !log_categories.empty())
+        {
+            std::vector<fmi3String> names;
+            for (auto &c : log_categories)
+            {
+                names.push_back(c.c_str());
+            }
+            fmi3_setDebugLogging(handle, true, names.size(), names.data());
+        }
+
+        return success;
+    }
+
+    bool Fmi3CoSimulationModel::setup_experiment(uint64_t start_time, uint64_t stop_time, double tolerance)
+    {
+        if (!instantiated_)
+        {
+            throw std::logic_error("setup_experiment called before instantiate");
+        }
+
+        if (start_time < 1000)
+        {
+            start_time = 0;
+        }
+
+        stop_defined_ = stop_time > start_time;
+        tolerance_defined_ = tolerance > 0.0;
+        start_ = utils::time::ns_to_s(start_time);
+        stop_ = utils::time::ns_to_s(stop_time);
+        tolerance_ = tolerance;
+
+        current_time_ = start_time;
+        return true;
+    }
+
+    bool Fmi3CoSimulationModel::enter_initialization_mode()
+    {
+        if (!instantiated_)
+        {
+            throw std::logic_error("enter_initialization_mode called before instantiate");
+        }
+
+        log(debug)("[{}] start:{} stop[{}]:{} tolerance[{}]:{}", __func__, start_, stop_defined_, stop_, tolerance_defined_, tolerance_);
+        last_status_ = fmi3_enterInitializationMode(handle, tolerance_defined_, tolerance_, start_, stop_defined_, stop_);
+        return is_status_ok(last_status_);
+    }
+
+    bool Fmi3CoSimulationModel::exit_initialization_mode()
+    {
+        if (!instantiated_)
+        {
+            throw std::logic_error("exit_initialization_mode called before instantiate");
+        }
+
+        last_status_ = fmi3_exitInitializationMode(handle);
+        return is_status_ok(last_status_);
+    }
+
+    uint64_t Fmi3CoSimulationModel::step_until(uint64_t stop_time)
+    {
+        auto sim_time = get_simulation_time();
+        while (sim_time < stop_time)
+        {
+            bool early_return = false;
+            if (!this->step(stop_time - sim_time, early_return))
+            {
+                if (last_status_ == fmi3Error || last_status_ == fmi3Fatal)
+                {
+                    throw std::runtime_error(Logger::format("[{}] Model return status fmi3Error: Execution failed for model: {}", __func__, this->instance_.instance_name()));
+                }
+            }
+            sim_time = get_simulation_time();
+
+            if (early_return)
+            {
+                IF_LOG({
+                    log(debug)("[{}] Early return at {}", __func__, sim_time);
+                });
+
+                early_returns += 1;
+                if (on_early_return)
+                {
+                    on_early_return(sim_time);
+                }
+            }
+        }
+        return sim_time;
+    }
+
+    bool Fmi3CoSimulationModel::step(uint64_t step_size, bool &early_return)
+    {
+        if (!instantiated_)
+        {
+            throw std::logic_error("step called before instantiate");
+        }
+
+        double current = utils::time::ns_to_s(current_time_);
+        double step_value = utils::time::ns_to_s(step_size);
+
+        fmi3Boolean event_handling_needed = false;
+        fmi3Boolean terminate_simulation = false;
+        fmi3Boolean returned_early = false;
+        fmi3Float64 last_successful_time = current;
+
+        last_status_ = fmi3_doStep(handle, current, step_value, true,
+                                   &event_handling_needed, &terminate_simulation, &returned_early, &last_successful_time);
+
+        if (!is_status_ok(last_status_))
+        {
+            log(error)("[{}] step(current: {}, step:{}) returned non ok, status: {} for model {}", __func__, current, step_value, std::to_string(last_status_), this->instance_.instance_name());
+            return false;
+        }
+
+        if (terminate_simulation)
+        {
+            throw std::runtime_error(Logger::format("[{}] Model {} requested termination at {}", __func__, this->instance_.instance_name(), last_successful_time));
+        }
+
+        early_return = returned_early;
+        if (early_return)
+        {
+            auto reached = utils::time::s_to_ns(last_successful_time);
+            if (reached <= current_time_)
+            {
+                throw std::runtime_error(Logger::format("[{}] Model {} returned early without progress at {}", __func__, this->instance_.instance_name(), current));
+            }
+            current_time_ = reached;
+        }
+        else
+        {
+            current_time_ += step_size;
+        }
+        return true;
+    }
+
+    bool Fmi3CoSimulationModel::terminate()
+    {
+        if (!instantiated_)
+        {
+            return true;
+        }
+
+        log(debug)("[{}] Terminating FMU {}", __func__, instance_.path());
+        if (saved_state_ != nullptr)
+        {
+            fmi3_freeFMUState(handle, &saved_state_);
+            saved_state_ = nullptr;
+        }
+        last_status_ = fmi3_terminate(handle);
+        fmi3_freeInstance(handle);
+        instantiated_ = false;
+        auto terminated = is_status_ok(last_status_);
+        if (!terminated)
+        {
+            log(error)("[{}] Model {}, failed to terminate", __func__, this->instance_.instance_name());
+        }
+        // Some fmus send messages when they terminate, wait for this
+        usleep(100);
+        return terminated;
+    }
+
+    uint64_t Fmi3CoSimulationModel::get_simulation_time() const
+    {
+        return current_time_;
+    }
+
+    bool Fmi3CoSimulationModel::can_save_state() const
+    {
+        return fmi3cs_getCanGetAndSetFMUState(instance_.raw());
+    }
+
+    bool Fmi3CoSimulationModel::save_state()
+    {
+        if (!instantiated_)
+        {
+            throw std::logic_error("save_state called before instantiate");
+        }
+
+        last_status_ = fmi3_getFMUState(handle, &saved_state_);
+        saved_time_ = current_time_;
+        return is_status_ok(last_status_);
+    }
+
+    bool Fmi3CoSimulationModel::restore_state()
+    {
+        if (!instantiated_ || saved_state_ == nullptr)
+        {
+            throw std::logic_error("restore_state called without a saved state");
+        }
+
+        last_status_ = fmi3_setFMUState(handle, saved_state_);
+        current_time_ = saved_time_;
+        return is_status_ok(last_status_);
+    }
+
+    bool Fmi3CoSimulationModel::can_serialize_state() const
+    {
+        return fmi3cs_getCanSerializeFMUState(instance_.raw());
+    }
+
+    bool Fmi3CoSimulationModel::serialize_state(std::vector<std::byte> &out)
+    {
+        if (!instantiated_)
+        {
+            throw std::logic_error("serialize_state called before instantiate");
+        }
+
+        fmi3FMUState state = nullptr;
+        last_status_ = fmi3_getFMUState(handle, &state);
+        if (!is_status_ok(last_status_))
+        {
+            return false;
+        }
+
+        std::size_t size = 0;
+        last_status_ = fmi3_serializedFMUStateSize(handle, state, &size);
+        if (is_status_ok(last_status_))
+        {
+            // The time is stored in front of the fmu state
+            out.resize(sizeof(current_time_) + size);
+            std::memcpy(out.data(), &current_time_, sizeof(current_time_));
+            last_status_ = fmi3_serializeFMUState(handle, state, reinterpret_cast<fmi3Byte *>(out.data() + sizeof(current_time_)), size);
+        }
+        fmi3_freeFMUState(handle, &state);
+        return is_status_ok(last_status_);
+    }
+
+    bool Fmi3CoSimulationModel::deserialize_state(const std::vector<std::byte> &data)
+    {
+        if (!instantiated_ || data.size() < sizeof(current_time_))
+        {
+            throw std::logic_error("deserialize_state called before instantiate or without a serialized state");
+        }
+
+        fmi3FMUState state = nullptr;
+        last_status_ = fmi3_deserializeFMUState(handle, reinterpret_cast<const fmi3Byte *>(data.data() + sizeof(current_time_)), data.size() - sizeof(current_time_), &state);
+        if (!is_status_ok(last_status_))
+        {
+            return false;
+        }
+
+        last_status_ = fmi3_setFMUState(handle, state);
+        fmi3_freeFMUState(handle, &state);
+        std::memcpy(&current_time_, data.data(), sizeof(current_time_));
+        return is_status_ok(last_status_);
+    }
+
+    bool Fmi3CoSimulationModel::can_get_directional_derivative() const
+    {
+        return fmi3cs_getProvidesDirectionalDerivative(instance_.raw());
+    }
+
+    bool Fmi3CoSimulationModel::get_directional_derivative(const std::vector<uint64_t> &unknowns,
+                                                           const std::vector<uint64_t> &knowns,
+                                                           const double *seed,
+                                                           double *sensitivity)
+    {
+        std::vector<fmi3ValueReference> unknown_refs(unknowns.begin(), unknowns.end());
+        std::vector<fmi3ValueReference> known_refs(knowns.begin(), knowns.end());
+
+        last_status_ = fmi3_getDirectionalDerivative(handle,
+                                                     unknown_refs.data(), unknown_refs.size(),
+                                                     known_refs.data(), known_refs.size(),
+                                                     seed, known_refs.size(),
+                                                     sensitivity, unknown_refs.size());
+        return is_status_ok(last_status_);
+    }
+
+    fmi3Status Fmi3CoSimulationModel::last_status() const
+    {
+        return last_status_;
+    }
+
+    bool Fmi3CoSimulationModel::read_real(uint64_t value_reference, double &out)
+    {
+        return read_reals(value_reference, &out, 1);
+    }
+
+    bool Fmi3CoSimulationModel::read_reals(uint64_t value_reference, double *out, std::size_t count)
+    {
+        fmi3ValueReference vr = static_cast<fmi3ValueReference>(value_reference);
+        last_status_ = fmi3_getFloat64(handle, &vr, 1, out, count);
+        bool ok = is_status_ok(last_status_);
+        if (!ok)
+        {
+            log(error)("[{}] Model {}, failed to read_reals, vr {}, Trying to continue...", __func__, this->instance_.instance_name(), value_reference);
+        }
+        return ok;
+    }
+
+    bool Fmi3CoSimulationModel::read_integer(uint64_t value_reference, int &out)
+    {
+        fmi3ValueReference vr = static_cast<fmi3ValueReference>(value_reference);
+        fmi3Int32 value = 0;
+        last_status_ = fmi3_getInt32(handle, &vr, 1, &value, 1);
+        bool ok = is_status_ok(last_status_);
+        if (!ok)
+        {
+            log(error)("[{}] Model {}, failed to read_integer, vr {}, Trying to continue...", __func__, this->instance_.instance_name(), value_reference);
+        }
+        out = value;
+        return ok;
+    }
+
+    bool Fmi3CoSimulationModel::read_boolean(uint64_t value_reference, int &out)
+    {
+        fmi3ValueReference vr = static_cast<fmi3ValueReference>(value_reference);
+        fmi3Boolean value = false;
+        last_status_ = fmi3_getBoolean(handle, &vr, 1, &value, 1);
+        bool ok = is_status_ok(last_status_);
+        if (!ok)
+        {
+            log(error)("[{}] Model {}, failed to read_boolean, vr {}, Trying to continue...", __func__, this->instance_.instance_name(), value_reference);
+        }
+        out = value ? 1 : 0;
+        return ok;
+    }
+
+    bool Fmi3CoSimulationModel::read_string(uint64_t value_reference, std::string &out)
+    {
+        fmi3ValueReference vr = static_cast<fmi3ValueReference>(value_reference);
+        fmi3String value = nullptr;
+        last_status_ = fmi3_getString(handle, &vr, 1, &value, 1);
+        if (is_status_ok(last_status_) && value != nullptr)
+        {
+            out = std::string(value);
+            return true;
+        }
+
+        log(error)("[{}] Model {}, failed to read_string, vr {}, Trying to continue...", __func__, this->instance_.instance_name(), value_reference);
+        return false;
+    }
+
+    bool Fmi3CoSimulationModel::write_real(uint64_t value_reference, double value)
+    {
+        return write_reals(value_reference, &value, 1);
+    }
+
+    bool Fmi3CoSimulationModel::write_reals(uint64_t value_reference, const double *values, std::size_t count)
+    {
+        fmi3ValueReference vr = static_cast<fmi3ValueReference>(value_reference);
+        last_status_ = fmi3_setFloat64(handle, &vr, 1, values, count);
+        bool ok = is_status_ok(last_status_);
+        if (!ok)
+        {
+            log(error)("[{}] Model {}, failed to write_reals, vr {}, Trying to continue...", __func__, this->instance_.instance_name(), value_reference);
+        }
+        return ok;
+    }
+
+    bool Fmi3CoSimulationModel::write_integer(uint64_t value_reference, int value)
+    {
+        fmi3ValueReference vr = static_cast<fmi3ValueReference>(value_reference);
+        fmi3Int32 data = value;
+        last_status_ = fmi3_setInt32(handle, &vr, 1, &data, 1);
+        bool ok = is_status_ok(last_status_);
+        if (!ok)
+        {
+            log(error)("[{}] Model {}, failed to write_integer, vr {}, Trying to continue...", __func__, this->instance_.instance_name(), value_reference);
+        }
+        return ok;
+    }
+
+    bool Fmi3CoSimulationModel::write_boolean(uint64_t value_reference, int value)
+    {
+        fmi3ValueReference vr = static_cast<fmi3ValueReference>(value_reference);
+        fmi3Boolean data = value != 0;
+        last_status_ = fmi3_setBoolean(handle, &vr, 1, &data, 1);
+        bool ok = is_status_ok(last_status_);
+        if (!ok)
+        {
+            log(error)("[{}] Model {}, failed to write_boolean, vr {}, Trying to continue...", __func__, this->instance_.instance_name(), value_reference);
+        }
+        return ok;
+    }
+
+    bool Fmi3CoSimulationModel::write_string(uint64_t value_reference, const std::string &value)
+    {
+        fmi3ValueReference vr = static_cast<fmi3ValueReference>(value_reference);
+        fmi3String data = value.c_str();
+        last_status_ = fmi3_setString(handle, &vr, 1, &data, 1);
+        bool ok = is_status_ok(last_status_);
+        if (!ok)
+        {
+            log(error)("[{}] Model {}, failed to write_string, vr {}, Trying to continue...", __func__, this->instance_.instance_name(), value_reference);
+        }
+        return ok;
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "fmi4c_adapter.hpp"
+
+#include "cutecpp/log.hpp"
+
+#include <fmi4c.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::handler
+{
+
+    struct Fmi3VariableInfo
+    {
+        std::string name;
+        fmi3ValueReference value_reference;
+        fmi3Causality causality;
+        fmi3DataType type;
+        std::size_t count = 1; // number of elements, 1 for scalars
+    };
+
+    // Variables read through fmi4c, arrays must have fixed (start) dimensions
+    std::vector<Fmi3VariableInfo> get_fmi3_variables(FmuInstance &instance);
+
+    /**
+     * @brief FMI 3.0 co-simulation instance
+     *
+     * Instantiated without event mode. If the fmu supports it, early return is allowed
+     * so that event driven models end a step at an internal event, step_until then
+     * continues from the returned time and on_early_return can publish the outputs.
+     */
+    class Fmi3CoSimulationModel final : public FmiModel
+    {
+        FmuInstance &instance_;
+        bool instantiated_ = false;
+        uint64_t current_time_ = 0;
+        fmi3Status last_status_ = fmi3OK;
+        MyEnv env;
+
+        double start_ = 0.0;
+        double stop_ = 0.0;
+        double tolerance_ = 0.0;
+        bool stop_defined_ = false;
+        bool tolerance_defined_ = false;
+
+        fmi3FMUState saved_state_ = nullptr;
+        uint64_t saved_time_ = 0;
+
+    public:
+        Logger log = Logger("ssp4sim.handler.Fmi3CoSimulationModel", LogLevel::info);
+
+        fmi3InstanceHandle *handle = nullptr;
+
+        bool early_return_allowed = true;
+        uint64_t early_returns = 0;
+
+        // Called with the time reached when a step returns early
+        std::function<void(uint64_t)> on_early_return;
+
+        Fmi3CoSimulationModel(FmuInstance &instance);
+
+        ~Fmi3CoSimulationModel() override;
+
+        Fmi3CoSimulationModel(const Fmi3CoSimulationModel &) = delete;
+        Fmi3CoSimulationModel &operator=(const Fmi3CoSimulationModel &) = delete;
+
+        bool instantiate(bool visible, bool logging_on) override;
+
+        // FMI 3.0 passes the experiment to enterInitializationMode, the values are stored until then
+        bool setup_experiment(uint64_t start_time, uint64_t stop_time, double tolerance) override;
+
+        bool enter_initialization_mode() override;
+
+        bool exit_initialization_mode() override;
+
+        uint64_t step_until(uint64_t stop_time);
+
+        // early_return is set if the fmu stopped before current + step_size
+        bool step(uint64_t step_size, bool &early_return);
+
+        bool terminate() override;
+
+        [[nodiscard]] uint64_t get_simulation_time() const override;
+
+        [[nodiscard]] fmi3Status last_status() const;
+
+        bool read_real(uint64_t value_reference, double &out) override;
+
+        bool read_integer(uint64_t value_reference, int &out) override;
+
+        bool read_boolean(uint64_t value_reference, int &out) override;
+
+        bool read_string(uint64_t value_reference, std::string &out) override;
+
+        bool write_real(uint64_t value_reference, double value) override;
+
+        bool write_integer(uint64_t value_reference, int value) override;
+
+        bool write_boolean(uint64_t value_reference, int value) override;
+
+        bool write_string(uint64_t value_reference, const std::string &value) override;
+
+        bool read_reals(uint64_t value_reference, double *out, std::size_t count) override;
+
+        bool write_reals(uint64_t value_reference, const double *values, std::size_t count) override;
+
+        [[nodiscard]] bool can_save_state() const override;
+
+        bool save_state() override;
+
+        bool restore_state() override;
+
+        [[nodiscard]] bool can_serialize_state() const override;
+
+        bool serialize_state(std::vector<std::byte> &out) override;
+
+        bool deserialize_state(const std::vector<std::byte> &data) override;
+
+        [[nodiscard]] bool can_get_directional_derivative() const override;
+
+        bool get_directional_derivative(const std::vector<uint64_t> &unknowns,
+                                        const std::vector<uint64_t> &knowns,
+                                        const double *seed,
+                                        double *sensitivity) override;
+    };
+}
@@ -1,8 +1,10 @@
 #include "handler/fmi4c_adapter.hpp"
+#include "handler/fmu_log_sink.hpp"
 
 #include "utils/time.hpp"
 
 #include <cstdlib>
+#include <cstring>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -71,7 +73,7 @@ namespace ssp4sim::handler
         }
 
         version_ = fmi4c_getFmiVersion(handle_);
-        if (version_ != fmiVersion2)
+        if (version_ != fmiVersion2 && version_ != fmiVersion3)
         {
             throw std::runtime_error(Logger::format("Unsupported FMI version {} for FMU '{}'", static_cast<int>(version_), fmu_path_));
         }
@@ -89,9 +91,23 @@ namespace ssp4sim::handler
 
     bool FmuInstance::supports_co_simulation() const
     {
+        if (version_ == fmiVersion3)
+        {
+            return fmi3_getSupportsCoSimulation(handle_) == true;
+        }
         return fmi2_getSupportsCoSimulation(handle_) == true;
     }
 
+    bool FmuInstance::supports_model_exchange() const
+    {
+        // Model exchange is only integrated for FMI 2.0
+        if (version_ == fmiVersion3)
+        {
+            return false;
+        }
+        return fmi2_getSupportsModelExchange(handle_) == true;
+    }
+
     fmuHandle *FmuInstance::raw()
     {
         return handle_;
@@ -112,31 +128,42 @@ namespace ssp4sim::handler
         return instance_name_;
     }
 
-    // CoSimulationModel ----------------------------
+    // Fmi2Model ----------------------------
 
-    CoSimulationModel::CoSimulationModel(FmuInstance &instance) : instance_(instance)
+    Fmi2Model::Fmi2Model(FmuInstance &instance, fmi2Type type) : instance_(instance), type_(type)
     {
     }
 
-    CoSimulationModel::~CoSimulationModel()
+    Fmi2Model::~Fmi2Model()
     {
         terminate();
     }
 
-    static std::string formatWithVaList(const char *fmt, va_list args)
+    bool MyEnv::accepts(int status, const char *category) const
     {
-        std::vector<char> buf(256);
-        int needed = vsnprintf(buf.data(), buf.size(), fmt, args);
-        if (needed < 0)
-            return "";
+        if (status >= fmi2Error && status != fmi2Pending)
+        {
+            return true;
+        }
 
-        if (needed >= (int)buf.size())
+        if (!enabled)
         {
-            buf.resize(needed + 1);
-            vsnprintf(buf.data(), buf.size(), fmt, args);
+            return false;
+        }
+
+        if (categories.empty())
+        {
+            return true;
         }
 
-        return std::string(buf.data());
+        for (auto &c : categories)
+        {
+            if (category != nullptr && c == category)
+            {
+                return true;
+            }
+        }
+        return false;
     }
 
     static void myLogger(fmi2ComponentEnvironment env,
@@ -145,14 +172,16 @@ namespace ssp4sim::handler
                          fmi2String category,
                          fmi2String message, ...)
     {
-        auto log = *((MyEnv *)env)->log;
+        auto my_env = (MyEnv *)env;
+        if (!my_env->accepts(status, category))
+        {
+            return;
+        }
 
         va_list args;
         va_start(args, message);
-        std::string msg = formatWithVaList(message, args);
+        FmuLogSink::instance().vpush(instanceName != nullptr ? instanceName : my_env->instance_name.c_str(), status, category, message, args);
         va_end(args);
-
-        log(debug)("[{}] ({}) status:{} {}", instanceName, category, std::to_string(status), msg);
     }
 
     static void *myAllocateMemory(size_t nobj, size_t size)
@@ -173,7 +202,7 @@ namespace ssp4sim::handler
         (void)status;
     }
 
-    bool CoSimulationModel::instantiate(bool visible, bool logging_on)
+    bool Fmi2Model::instantiate(bool visible, bool logging_on)
     {
         if (instantiated_)
         {
@@ -185,11 +214,16 @@ namespace ssp4sim::handler
             throw std::runtime_error("Only FMI 2.0 FMUs are supported");
         }
 
-        if (!instance_.supports_co_simulation())
+        if (type_ == fmi2CoSimulation && !instance_.supports_co_simulation())
         {
             throw std::runtime_error(Logger::format("FMU '{}' does not support co-simulation", instance_.path()));
         }
 
+        if (type_ == fmi2ModelExchange && !instance_.supports_model_exchange())
+        {
+            throw std::runtime_error(Logger::format("FMU '{}' does not support model exchange", instance_.path()));
+        }
+
         log(debug)("[{}] Instantiating FMU {}", __func__, instance_.path());
         detail::ensure_message_callback_registered();
         detail::clear_last_message();
@@ -198,11 +232,13 @@ namespace ssp4sim::handler
         callbacks.allocateMemory = myAllocateMemory;
         callbacks.freeMemory = myFreeMemory;
         callbacks.stepFinished = myStepFinished;
-        env.log = std::make_shared<Logger>("fmu." + instance_.instance_name(), info);
+        env.instance_name = instance_.instance_name();
+        env.enabled = logging_on;
+        env.categories = log_categories;
         callbacks.componentEnvironment = &env; // passed back as 'env' to the callbacks
 
         handle = fmi2_instantiate(instance_.raw(),
-                                  fmi2CoSimulation,
+                                  type_,
                                   callbacks.logger,
                                   callbacks.allocateMemory,
                                   callbacks.freeMemory,
@@ -222,10 +258,21 @@ namespace ssp4sim::handler
             throw std::runtime_error(Logger::format("Failed to instantiate FMU '{}': {}", instance_.path(), message.empty() ? "unknown error" : message));
         }
 
+        if (logging_on && !log_categories.empty())
+        {
+            // Let the fmu skip the other categories before it formats anything
+            std::vector<fmi2String> names;
+            for (auto &c : log_categories)
+            {
+                names.push_back(c.c_str());
+            }
+            fmi2_setDebugLogging(handle, fmi2True, names.size(), names.data());
+        }
+
         return success;
     }
 
-    bool CoSimulationModel::setup_experiment(uint64_t start_time, uint64_t stop_time, double tolerance)
+    bool Fmi2Model::setup_experiment(uint64_t start_time, uint64_t stop_time, double tolerance)
     {
         if (!instantiated_)
         {
@@ -253,7 +300,7 @@ namespace ssp4sim::handler
         return is_status_ok(last_status_);
     }
 
-    bool CoSimulationModel::enter_initialization_mode()
+    bool Fmi2Model::enter_initialization_mode()
     {
         if (!instantiated_)
         {
@@ -264,7 +311,7 @@ namespace ssp4sim::handler
         return is_status_ok(last_status_);
     }
 
-    bool CoSimulationModel::exit_initialization_mode()
+    bool Fmi2Model::exit_initialization_mode()
     {
         if (!instantiated_)
         {
@@ -275,67 +322,19 @@ namespace ssp4sim::handler
         return is_status_ok(last_status_);
     }
 
-    uint64_t CoSimulationModel::step_until(uint64_t stop_time)
-    {
-        auto sim_time = get_simulation_time();
-        while (sim_time < stop_time)
-        {
-            auto step_time = stop_time - sim_time;
-
-            IF_LOG({
-                log(debug)("[{}] step_time {}s ", __func__, utils::time::ns_to_s(step_time));
-            });
-
-            if (!this->step(step_time))
-            {
-                int status = last_status();
-                if (status == 3 or status == 4)
-                {
-                    throw std::runtime_error(std::format("[{}] Model return status fmi2Error: Execution failed for model: {}", __func__, this->instance_.instance_name()));
-                }
-            }
-            sim_time = get_simulation_time();
-
-            IF_LOG({
-                log(trace)("[{}], sim time {}", __func__, sim_time);
-            });
-        }
-        return sim_time;
-    }
-
-    bool CoSimulationModel::step(uint64_t step_size)
+    bool Fmi2Model::terminate()
     {
         if (!instantiated_)
         {
-            throw std::logic_error("step called before instantiate");
-        }
-
-        double current = utils::time::ns_to_s(current_time_);
-        double step_value = utils::time::ns_to_s(step_size);
-
-        IF_LOG({
-            log(debug)("[{}] current {} step {}", __func__, current, step_value);
-        });
-
-        last_status_ = fmi2_doStep(handle, current, step_value, fmi2True);
-        if (is_status_ok(last_status_))
-        {
-            current_time_ += step_size;
             return true;
         }
-        log(error)("[{}] step(current: {}, step:{}) returned non ok, status: {} for model {}", __func__, current, step_value, std::to_string(last_status_), this->instance_.instance_name());
 
-        return false;
-    }
-
-    bool CoSimulationModel::terminate()
-    {
-        if (!instantiated_)
+        log(debug)("[{}] Terminating FMU {}", __func__, instance_.path());
+        if (saved_state_ != nullptr)
         {
-            return true;
+            fmi2_freeFMUstate(handle, &saved_state_);
+            saved_state_ = nullptr;
         }
-
-        log(debug)("[{}] Terminating FMU {}", __func__, instance_.path());
         last_status_ = fmi2_terminate(handle);
         fmi2_freeInstance(handle);
         instantiated_ = false;
@@ -350,47 +349,136 @@ namespace ssp4sim::handler
         return terminated;
     }
 
-    uint64_t CoSimulationModel::get_simulation_time() const
+    uint64_t Fmi2Model::get_simulation_time() const
     {
         return current_time_;
     }
 
-    fmi2Status CoSimulationModel::last_status() const
+    bool Fmi2Model::can_save_state() const
     {
-        return last_status_;
+        if (type_ == fmi2ModelExchange)
+        {
+            return fmi2me_getCanGetAndSetFMUState(instance_.raw());
+        }
+        return fmi2cs_getCanGetAndSetFMUState(instance_.raw());
     }
 
-    bool CoSimulationModel::set_real_input_derivative(uint64_t value_reference, int derivative_order, double value)
+    bool Fmi2Model::save_state()
     {
-        fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
-        fmi2Integer order = static_cast<fmi2Integer>(derivative_order);
-        last_status_ = fmi2_setRealInputDerivatives(handle, &vr, 1, &order, &value);
+        if (!instantiated_)
+        {
+            throw std::logic_error("save_state called before instantiate");
+        }
 
-        bool ok = is_status_ok(last_status_);
-        if (!ok)
+        // An existing state is updated in place by the fmu
+        last_status_ = fmi2_getFMUstate(handle, &saved_state_);
+        saved_time_ = current_time_;
+        return is_status_ok(last_status_);
+    }
+
+    bool Fmi2Model::restore_state()
+    {
+        if (!instantiated_ || saved_state_ == nullptr)
         {
-            log(error)("[{}] Model {}, failed to set_real_input_derivative, vr {}, Trying to continue...", __func__, value_reference, this->instance_.instance_name());
+            throw std::logic_error("restore_state called without a saved state");
         }
 
-        return ok;
+        last_status_ = fmi2_setFMUstate(handle, saved_state_);
+        current_time_ = saved_time_;
+        return is_status_ok(last_status_);
     }
 
-    bool CoSimulationModel::get_real_output_derivative(uint64_t value_reference, int derivative_order, double &out)
+    bool Fmi2Model::can_serialize_state() const
     {
-        fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
-        fmi2Integer order = static_cast<fmi2Integer>(derivative_order);
-        last_status_ = fmi2_getRealOutputDerivatives(handle, &vr, 1, &order, &out);
+        if (type_ == fmi2ModelExchange)
+        {
+            return fmi2me_getCanSerializeFMUState(instance_.raw());
+        }
+        return fmi2cs_getCanSerializeFMUState(instance_.raw());
+    }
 
-        bool ok = is_status_ok(last_status_);
-        if (!ok)
+    bool Fmi2Model::serialize_state(std::vector<std::byte> &out)
+    {
+        if (!instantiated_)
         {
-            log(error)("[{}] Model {}, failed to get_real_output_derivative, vr {}, Trying to continue...", __func__, value_reference, this->instance_.instance_name());
+            throw std::logic_error("serialize_state called before instantiate");
         }
 
-        return ok;
+        fmi2FMUstate state = nullptr;
+        last_status_ = fmi2_getFMUstate(handle, &state);
+        if (!is_status_ok(last_status_))
+        {
+            return false;
+        }
+
+        std::size_t size = 0;
+        last_status_ = fmi2_serializedFMUstateSize(handle, state, &size);
+        if (is_status_ok(last_status_))
+        {
+            // The time is stored in front of the fmu state
+            out.resize(sizeof(current_time_) + size);
+            std::memcpy(out.data(), &current_time_, sizeof(current_time_));
+            last_status_ = fmi2_serializeFMUstate(handle, state, reinterpret_cast<fmi2Byte *>(out.data() + sizeof(current_time_)), size);
+        }
+        fmi2_freeFMUstate(handle, &state);
+        return is_status_ok(last_status_);
+    }
+
+    bool Fmi2Model::deserialize_state(const std::vector<std::byte> &data)
+    {
+        if (!instantiated_ || data.size() < sizeof(current_time_))
+        {
+            throw std::logic_error("deserialize_state called before instantiate or without a serialized state");
+        }
+
+        fmi2FMUstate state = nullptr;
+        last_status_ = fmi2_deSerializeFMUstate(handle, reinterpret_cast<const fmi2Byte *>(data.data() + sizeof(current_time_)), data.size() - sizeof(current_time_), &state);
+        if (!is_status_ok(last_status_))
+        {
+            return false;
+        }
+
+        last_status_ = fmi2_setFMUstate(handle, state);
+        fmi2_freeFMUstate(handle, &state);
+        std::memcpy(&current_time_, data.data(), sizeof(current_time_));
+        return is_status_ok(last_status_);
+    }
+
+    bool Fmi2Model::can_get_directional_derivative() const
+    {
+        if (type_ == fmi2ModelExchange)
+        {
+            return fmi2me_getProvidesDirectionalDerivative(instance_.raw());
+        }
+        return fmi2cs_getProvidesDirectionalDerivative(instance_.raw());
+    }
+
+    bool Fmi2Model::get_directional_derivative(const std::vector<uint64_t> &unknowns,
+                                               const std::vector<uint64_t> &knowns,
+                                               const double *seed,
+                                               double *sensitivity)
+    {
+        std::vector<fmi2ValueReference> unknown_refs(unknowns.begin(), unknowns.end());
+        std::vector<fmi2ValueReference> known_refs(knowns.begin(), knowns.end());
+
+        last_status_ = fmi2_getDirectionalDerivative(handle,
+                                                     unknown_refs.data(), unknown_refs.size(),
+                                                     known_refs.data(), known_refs.size(),
+                                                     seed, sensitivity);
+        return is_status_ok(last_status_);
     }
 
-    bool CoSimulationModel::read_real(uint64_t value_reference, double &out)
+    fmi2Status Fmi2Model::last_status() const
+    {
+        return last_status_;
+    }
+
+    bool Fmi2Model::is_model_exchange() const
+    {
+        return type_ == fmi2ModelExchange;
+    }
+
+    bool Fmi2Model::read_real(uint64_t value_reference, double &out)
     {
         fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
         last_status_ = fmi2_getReal(handle, &vr, 1, &out);
@@ -404,7 +492,7 @@ namespace ssp4sim::handler
 
     }
 
-    bool CoSimulationModel::read_integer(uint64_t value_reference, int &out)
+    bool Fmi2Model::read_integer(uint64_t value_reference, int &out)
     {
         fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
         last_status_ = fmi2_getInteger(handle, &vr, 1, &out);
@@ -417,7 +505,7 @@ namespace ssp4sim::handler
         return ok;
     }
 
-    bool CoSimulationModel::read_boolean(uint64_t value_reference, int &out)
+    bool Fmi2Model::read_boolean(uint64_t value_reference, int &out)
     {
         fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
         last_status_ = fmi2_getBoolean(handle, &vr, 1, &out);
@@ -430,7 +518,7 @@ namespace ssp4sim::handler
         return ok;
     }
 
-    bool CoSimulationModel::read_string(uint64_t value_reference, std::string &out)
+    bool Fmi2Model::read_string(uint64_t value_reference, std::string &out)
     {
         fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
         fmi2String value = nullptr;
@@ -445,7 +533,7 @@ namespace ssp4sim::handler
         return false;
     }
 
-    bool CoSimulationModel::write_real(uint64_t value_reference, double value)
+    bool Fmi2Model::write_real(uint64_t value_reference, double value)
     {
         fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
         last_status_ = fmi2_setReal(handle, &vr, 1, &value);
@@ -465,7 +553,7 @@ namespace ssp4sim::handler
         return ok;
     }
 
-    bool CoSimulationModel::write_integer(uint64_t value_reference, int value)
+    bool Fmi2Model::write_integer(uint64_t value_reference, int value)
     {
         fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
         last_status_ = fmi2_setInteger(handle, &vr, 1, &value);
@@ -479,7 +567,7 @@ namespace ssp4sim::handler
         return ok;
     }
 
-    bool CoSimulationModel::write_boolean(uint64_t value_reference, int value)
+    bool Fmi2Model::write_boolean(uint64_t value_reference, int value)
     {
         fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
         last_status_ = fmi2_setBoolean(handle, &vr, 1, &value);
@@ -493,7 +581,7 @@ namespace ssp4sim::handler
         return ok;
     }
 
-    bool CoSimulationModel::write_string(uint64_t value_reference, const std::string &value)
+    bool Fmi2Model::write_string(uint64_t value_reference, const std::string &value)
     {
         fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
         fmi2String data = value.c_str();
@@ -508,4 +596,207 @@ namespace ssp4sim::handler
         return ok;
     }
 
+    bool Fmi2Model::read_reals(uint64_t value_reference, double *out, std::size_t count)
+    {
+        if (count != 1)
+        {
+            throw std::logic_error(Logger::format("Array variables are not supported by FMI 2.0, model {}", this->instance_.instance_name()));
+        }
+        return read_real(value_reference, *out);
+    }
+
+    bool Fmi2Model::write_reals(uint64_t value_reference, const double *values, std::size_t count)
+    {
+        if (count != 1)
+        {
+            throw std::logic_error(Logger::format("Array variables are not supported by FMI 2.0, model {}", this->instance_.instance_name()));
+        }
+        return write_real(value_reference, *values);
+    }
+
+    // CoSimulationModel ----------------------------
+
+    CoSimulationModel::CoSimulationModel(FmuInstance &instance) : Fmi2Model(instance, fmi2CoSimulation)
+    {
+    }
+
+    uint64_t CoSimulationModel::step_until(uint64_t stop_time)
+    {
+        auto sim_time = get_simulation_time();
+        while (sim_time < stop_time)
+        {
+            auto step_time = stop_time - sim_time;
+
+            IF_LOG({
+                log(debug)("[{}] step_time {}s ", __func__, utils::time::ns_to_s(step_time));
+            });
+
+            if (!this->step(step_time))
+            {
+                int status = last_status();
+                if (status == 3 or status == 4)
+                {
+                    throw std::runtime_error(std::format("[{}] Model return status fmi2Error: Execution failed for model: {}", __func__, this->instance_.instance_name()));
+                }
+            }
+            sim_time = get_simulation_time();
+
+            IF_LOG({
+                log(trace)("[{}], sim time {}", __func__, sim_time);
+            });
+        }
+        return sim_time;
+    }
+
+    bool CoSimulationModel::step(uint64_t step_size)
+    {
+        if (!instantiated_)
+        {
+            throw std::logic_error("step called before instantiate");
+        }
+
+        double current = utils::time::ns_to_s(current_time_);
+        double step_value = utils::time::ns_to_s(step_size);
+
+        IF_LOG({
+            log(debug)("[{}] current {} step {}", __func__, current, step_value);
+        });
+
+        last_status_ = fmi2_doStep(handle, current, step_value, fmi2True);
+        if (is_status_ok(last_status_))
+        {
+            current_time_ += step_size;
+            return true;
+        }
+        log(error)("[{}] step(current: {}, step:{}) returned non ok, status: {} for model {}", __func__, current, step_value, std::to_string(last_status_), this->instance_.instance_name());
+
+        return false;
+    }
+
+    bool CoSimulationModel::set_real_input_derivative(uint64_t value_reference, int derivative_order, double value)
+    {
+        fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
+        fmi2Integer order = static_cast<fmi2Integer>(derivative_order);
+        last_status_ = fmi2_setRealInputDerivatives(handle, &vr, 1, &order, &value);
+
+        bool ok = is_status_ok(last_status_);
+        if (!ok)
+        {
+            log(error)("[{}] Model {}, failed to set_real_input_derivative, vr {}, Trying to continue...", __func__, value_reference, this->instance_.instance_name());
+        }
+
+        return ok;
+    }
+
+    bool CoSimulationModel::get_real_output_derivative(uint64_t value_reference, int derivative_order, double &out)
+    {
+        fmi2ValueReference vr = static_cast<fmi2ValueReference>(value_reference);
+        fmi2Integer order = static_cast<fmi2Integer>(derivative_order);
+        last_status_ = fmi2_getRealOutputDerivatives(handle, &vr, 1, &order, &out);
+
+        bool ok = is_status_ok(last_status_);
+        if (!ok)
+        {
+            log(error)("[{}] Model {}, failed to get_real_output_derivative, vr {}, Trying to continue...", __func__, value_reference, this->instance_.instance_name());
+        }
+
+        return ok;
+    }
+
+    // ModelExchangeModel ----------------------------
+
+    ModelExchangeModel::ModelExchangeModel(FmuInstance &instance) : Fmi2Model(instance, fmi2ModelExchange)
+    {
+    }
+
+    std::size_t ModelExchangeModel::nr_states() const
+    {
+        return static_cast<std::size_t>(fmi2_getNumberOfContinuousStates(instance_.raw()));
+    }
+
+    std::size_t ModelExchangeModel::nr_event_indicators() const
+    {
+        return static_cast<std::size_t>(fmi2_getNumberOfEventIndicators(instance_.raw()));
+    }
+
+    bool ModelExchangeModel::set_time(uint64_t time)
+    {
+        last_status_ = fmi2_setTime(handle, utils::time::ns_to_s(time));
+        if (is_status_ok(last_status_))
+        {
+            current_time_ = time;
+            return true;
+        }
+        log(error)("[{}] Model {}, failed to set_time {}", __func__, this->instance_.instance_name(), time);
+        return false;
+    }
+
+    bool ModelExchangeModel::set_continuous_states(const double *x, std::size_t nx)
+    {
+        last_status_ = fmi2_setContinuousStates(handle, x, nx);
+        return is_status_ok(last_status_);
+    }
+
+    bool ModelExchangeModel::get_continuous_states(double *x, std::size_t nx)
+    {
+        last_status_ = fmi2_getContinuousStates(handle, x, nx);
+        return is_status_ok(last_status_);
+    }
+
+    bool ModelExchangeModel::get_derivatives(double *dx, std::size_t nx)
+    {
+        last_status_ = fmi2_getDerivatives(handle, dx, nx);
+        return is_status_ok(last_status_);
+    }
+
+    bool ModelExchangeModel::get_event_indicators(double *z, std::size_t nz)
+    {
+        last_status_ = fmi2_getEventIndicators(handle, z, nz);
+        return is_status_ok(last_status_);
+    }
+
+    bool ModelExchangeModel::enter_event_mode()
+    {
+        last_status_ = fmi2_enterEventMode(handle);
+        return is_status_ok(last_status_);
+    }
+
+    bool ModelExchangeModel::enter_continuous_time_mode()
+    {
+        last_status_ = fmi2_enterContinuousTimeMode(handle);
+        return is_status_ok(last_status_);
+    }
+
+    bool ModelExchangeModel::update_discrete_states()
+    {
+        event_info.newDiscreteStatesNeeded = fmi2True;
+        event_info.terminateSimulation = fmi2False;
+
+        while (event_info.newDiscreteStatesNeeded == fmi2True && event_info.terminateSimulation == fmi2False)
+        {
+            last_status_ = fmi2_newDiscreteStates(handle, &event_info);
+            if (!is_status_ok(last_status_))
+            {
+                log(error)("[{}] Model {}, new discrete states failed, status {}", __func__, this->instance_.instance_name(), std::to_string(last_status_));
+                return false;
+            }
+        }
+
+        if (event_info.terminateSimulation == fmi2True)
+        {
+            throw std::runtime_error(Logger::format("[{}] Model {} requested termination", __func__, this->instance_.instance_name()));
+        }
+        return true;
+    }
+
+    bool ModelExchangeModel::completed_integrator_step(bool &enter_event_mode, bool &terminate_simulation)
+    {
+        fmi2Boolean event = fmi2False;
+        fmi2Boolean terminate = fmi2False;
+        last_status_ = fmi2_completedIntegratorStep(handle, fmi2True, &event, &terminate);
+
+        enter_event_mode = event == fmi2True;
+        terminate_simulation = terminate == fmi2True;
+        return is_status_ok(last_status_);
+    }
 }
@@ -4,15 +4,18 @@
 
 #include <fmi4c.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <filesystem>
+#include <vector>
 
 namespace ssp4sim::handler
 {
     namespace detail
     {
+        void ensure_message_callback_registered();
         void clear_last_message();
         void fmi4c_message_callback(const char *message);
         std::string consume_last_message();
@@ -32,6 +35,8 @@ namespace ssp4sim::handler
 
         bool supports_co_simulation() const;
 
+        bool supports_model_exchange() const;
+
         fmuHandle *raw();
 
         [[nodiscard]] fmiVersion_t version() const;
@@ -47,70 +52,229 @@ namespace ssp4sim::handler
         fmiVersion_t version_ = fmiVersionUnknown;
     };
 
+    /**
+     * @brief Passed back to the fmu log callbacks
+     * The filter is checked before the message is formatted, accepted messages are
+     * handed to FmuLogSink and logged from its thread
+     */
     struct MyEnv
     {
-        // it needs to be shared since the logger might live longer than the main application.
-        // Initial thoughts are that some fmus spawn internal threads...
-        std::shared_ptr<Logger> log = nullptr;
+        std::string instance_name;
+        bool enabled = false;
+        std::vector<std::string> categories; // empty accepts all categories
+
+        // Errors are always accepted, other messages only when enabled and in a listed category
+        [[nodiscard]] bool accepts(int status, const char *category) const;
+    };
+
+    /**
+     * @brief Interface independent access to an instantiated fmu
+     * Used for initialization and variable transfer, stepping is interface specific
+     */
+    class FmiModel
+    {
+    public:
+        // Forwarded to the fmu when logging is on, also filters the messages it sends back
+        std::vector<std::string> log_categories;
+
+        virtual ~FmiModel() = default;
+
+        virtual bool instantiate(bool visible, bool logging_on) = 0;
+
+        virtual bool setup_experiment(uint64_t start_time, uint64_t stop_time, double tolerance) = 0;
+
+        virtual bool enter_initialization_mode() = 0;
+
+        virtual bool exit_initialization_mode() = 0;
+
+        virtual bool terminate() = 0;
+
+        [[nodiscard]] virtual uint64_t get_simulation_time() const = 0;
+
+        virtual bool read_real(uint64_t value_reference, double &out) = 0;
+
+        virtual bool read_integer(uint64_t value_reference, int &out) = 0;
+
+        virtual bool read_boolean(uint64_t value_reference, int &out) = 0;
+
+        virtual bool read_string(uint64_t value_reference, std::string &out) = 0;
+
+        virtual bool write_real(uint64_t value_reference, double value) = 0;
+
+        virtual bool write_integer(uint64_t value_reference, int value) = 0;
+
+        virtual bool write_boolean(uint64_t value_reference, int value) = 0;
+
+        virtual bool write_string(uint64_t value_reference, const std::string &value) = 0;
+
+        // Array variables, values are contiguous. FMI 2.0 only has scalars
+        virtual bool read_reals(uint64_t value_reference, double *out, std::size_t count) = 0;
+
+        virtual bool write_reals(uint64_t value_reference, const double *values, std::size_t count) = 0;
+
+        // Single saved fmu state used to roll back a step, requires canGetAndSetFMUstate
+        [[nodiscard]] virtual bool can_save_state() const = 0;
+
+        virtual bool save_state() = 0;
+
+        virtual bool restore_state() = 0;
+
+        /**
+         * The current fmu state and time as bytes that can be loaded into another instance of
+         * the same fmu, requires canSerializeFMUstate. Independent of the saved state
+         */
+        [[nodiscard]] virtual bool can_serialize_state() const = 0;
+
+        virtual bool serialize_state(std::vector<std::byte> &out) = 0;
+
+        virtual bool deserialize_state(const std::vector<std::byte> &data) = 0;
+
+        // Partial derivatives of real outputs with respect to real inputs, requires providesDirectionalDerivative
+        [[nodiscard]] virtual bool can_get_directional_derivative() const = 0;
+
+        // sensitivity[unknowns.size()] = d unknowns / d knowns * seed[knowns.size()], scalar variables only
+        virtual bool get_directional_derivative(const std::vector<uint64_t> &unknowns,
+                                                const std::vector<uint64_t> &knowns,
+                                                const double *seed,
+                                                double *sensitivity) = 0;
     };
 
-    class CoSimulationModel
+    /**
+     * @brief Shared part of an FMI 2.0 instance
+     * Lifecycle and variable access that is identical for co-simulation and model exchange
+     */
+    class Fmi2Model : public FmiModel
     {
+    protected:
         FmuInstance &instance_;
+        fmi2Type type_;
         bool instantiated_ = false;
         uint64_t current_time_ = 0;
         fmi2Status last_status_ = fmi2OK;
         MyEnv env;
         fmi2CallbackFunctions callbacks;
 
+        fmi2FMUstate saved_state_ = nullptr;
+        uint64_t saved_time_ = 0;
+
     public:
-        Logger log = Logger("ssp4sim.handler.CoSimulationModel", LogLevel::info);
+        Logger log = Logger("ssp4sim.handler.Fmi2Model", LogLevel::info);
 
-        CoSimulationModel(FmuInstance &instance);
+        Fmi2Model(FmuInstance &instance, fmi2Type type);
 
-        ~CoSimulationModel();
+        ~Fmi2Model() override;
 
-        CoSimulationModel(const CoSimulationModel &) = delete;
-        CoSimulationModel &operator=(const CoSimulationModel &) = delete;
+        Fmi2Model(const Fmi2Model &) = delete;
+        Fmi2Model &operator=(const Fmi2Model &) = delete;
 
-        fmi2InstanceHandle *handle;
+        fmi2InstanceHandle *handle = nullptr;
 
-        bool instantiate(bool visible, bool logging_on);
+        bool instantiate(bool visible, bool logging_on) override;
 
-        bool setup_experiment(uint64_t start_time, uint64_t stop_time, double tolerance);
+        bool setup_experiment(uint64_t start_time, uint64_t stop_time, double tolerance) override;
 
-        bool enter_initialization_mode();
+        bool enter_initialization_mode() override;
 
-        bool exit_initialization_mode();
+        bool exit_initialization_mode() override;
 
-        uint64_t step_until(uint64_t stop_time);
+        bool terminate() override;
 
-        bool step(uint64_t step_size);
+        [[nodiscard]] uint64_t get_simulation_time() const override;
 
-        bool terminate();
+        [[nodiscard]] fmi2Status last_status() const;
 
-        [[nodiscard]] uint64_t get_simulation_time() const;
+        [[nodiscard]] bool is_model_exchange() const;
 
-        [[nodiscard]] fmi2Status last_status() const;
+        bool read_real(uint64_t value_reference, double &out) override;
+
+        bool read_integer(uint64_t value_reference, int &out) override;
+
+        bool read_boolean(uint64_t value_reference, int &out) override;
+
+        bool read_string(uint64_t value_reference, std::string &out) override;
+
+        bool write_real(uint64_t value_reference, double value) override;
+
+        bool write_integer(uint64_t value_reference, int value) override;
+
+        bool write_boolean(uint64_t value_reference, int value) override;
+
+        bool write_string(uint64_t value_reference, const std::string &value) override;
+
+        bool read_reals(uint64_t value_reference, double *out, std::size_t count) override;
+
+        bool write_reals(uint64_t value_reference, const double *values, std::size_t count) override;
+
+        [[nodiscard]] bool can_save_state() const override;
+
+        bool save_state() override;
+
+        bool restore_state() override;
+
+        [[nodiscard]] bool can_serialize_state() const override;
+
+        bool serialize_state(std::vector<std::byte> &out) override;
+
+        bool deserialize_state(const std::vector<std::byte> &data) override;
+
+        [[nodiscard]] bool can_get_directional_derivative() const override;
+
+        bool get_directional_derivative(const std::vector<uint64_t> &unknowns,
+                                        const std::vector<uint64_t> &knowns,
+                                        const double *seed,
+                                        double *sensitivity) override;
+    };
+
+    class CoSimulationModel final : public Fmi2Model
+    {
+    public:
+        Logger log = Logger("ssp4sim.handler.CoSimulationModel", LogLevel::info);
+
+        CoSimulationModel(FmuInstance &instance);
+
+        uint64_t step_until(uint64_t stop_time);
+
+        bool step(uint64_t step_size);
 
         bool set_real_input_derivative(uint64_t value_reference, int derivative_order, double value);
 
         bool get_real_output_derivative(uint64_t value_reference, int derivative_order, double &out);
+    };
+
+    /**
+     * @brief FMI 2.0 model exchange instance
+     * The continuous states are integrated outside of the fmu, see ModelExchangeGroup
+     */
+    class ModelExchangeModel final : public Fmi2Model
+    {
+    public:
+        Logger log = Logger("ssp4sim.handler.ModelExchangeModel", LogLevel::info);
+
+        fmi2EventInfo event_info{};
+
+        ModelExchangeModel(FmuInstance &instance);
+
+        [[nodiscard]] std::size_t nr_states() const;
+
+        [[nodiscard]] std::size_t nr_event_indicators() const;
+
+        bool set_time(uint64_t time);
 
-        bool read_real(uint64_t value_reference, double &out);
+        bool set_continuous_states(const double *x, std::size_t nx);
 
-        bool read_integer(uint64_t value_reference, int &out);
+        bool get_continuous_states(double *x, std::size_t nx);
 
-        bool read_boolean(uint64_t value_reference, int &out);
+        bool get_derivatives(double *dx, std::size_t nx);
 
-        bool read_string(uint64_t value_reference, std::string &out);
+        bool get_event_indicators(double *z, std::size_t nz);
 
-        bool write_real(uint64_t value_reference, double value);
+        bool enter_event_mode();
 
-        bool write_integer(uint64_t value_reference, int value);
+        bool enter_continuous_time_mode();
 
-        bool write_boolean(uint64_t value_reference, int value);
+        // Iterate new discrete states until the fmu is settled, result in event_info
+        bool update_discrete_states();
 
-        bool write_string(uint64_t value_reference, const std::string &value);
+        bool completed_integrator_step(bool &enter_event_mode, bool &terminate_simulation);
     };
 }
@@ -1,32 +1,84 @@
 #include "handler/fmu_handler.hpp"
 
 #include "SSP_Ext.hpp"
+#include "config.hpp"
 #include "ssp4cpp/fmu.hpp"
 #include "ssp4cpp/ssp.hpp"
 
+#include <nlohmann/json.hpp>
+
 #include <memory>
+#include <set>
 #include <stdexcept>
 
 namespace ssp4sim::handler
 {
 
-    FmuInfo::FmuInfo(std::string name, ssp4cpp::Fmu *fmu)
+    FmuInfo::FmuInfo(std::string name, ssp4cpp::Fmu *fmu, bool prefer_model_exchange)
     {
-        this->model_name = fmu->md->modelName;
         this->system_name = name;
-
         this->fmu = fmu;
 
         this->fmi_instance = std::make_unique<FmuInstance>(this->fmu->original_file, this->system_name);
-        if (!this->fmi_instance->supports_co_simulation())
+
+        if (this->fmi_instance->version() == fmiVersion3)
         {
-            throw std::runtime_error(Logger::format("FMU '{}' does not support co-simulation", this->system_name));
+            // The model description schema is FMI 2.0 only, variables are read through fmi4c
+            this->model_name = name;
+            this->model_description = nullptr;
+            if (!this->fmi_instance->supports_co_simulation())
+            {
+                throw std::runtime_error(Logger::format("FMI 3.0 FMU '{}' does not support co-simulation", this->system_name));
+            }
+            this->fmi3_model = std::make_unique<Fmi3CoSimulationModel>(*this->fmi_instance);
+            this->fmi3_model->early_return_allowed = utils::Config::getOr("simulation.fmi3.early_return", true);
+            return;
+        }
+
+        this->model_name = fmu->md->modelName;
+
+        auto co_simulation = this->fmi_instance->supports_co_simulation();
+        auto model_exchange = this->fmi_instance->supports_model_exchange();
+        if (!co_simulation && !model_exchange)
+        {
+            throw std::runtime_error(Logger::format("FMU '{}' supports neither co-simulation nor model exchange", this->system_name));
+        }
+
+        if (model_exchange && (prefer_model_exchange || !co_simulation))
+        {
+            this->me_model = std::make_unique<ModelExchangeModel>(*this->fmi_instance);
+        }
+        else
+        {
+            this->model = std::make_unique<CoSimulationModel>(*this->fmi_instance);
         }
-        this->model = std::make_unique<CoSimulationModel>(*this->fmi_instance);
 
         this->model_description = fmu->md.get();
     }
 
+    bool FmuInfo::is_model_exchange() const
+    {
+        return me_model != nullptr;
+    }
+
+    bool FmuInfo::is_fmi3() const
+    {
+        return fmi3_model != nullptr;
+    }
+
+    FmiModel *FmuInfo::get_model()
+    {
+        if (fmi3_model)
+        {
+            return fmi3_model.get();
+        }
+        if (me_model)
+        {
+            return me_model.get();
+        }
+        return model.get();
+    }
+
     FmuHandler::FmuHandler(ssp4cpp::Ssp *ssp) : ssp(ssp)
     {
         log(debug)("[{}] Creating FMU map", __func__);
@@ -38,10 +90,22 @@ namespace ssp4sim::handler
 
         fmu_ref_map = utils::map_ns::map_unique_to_ref(fmu_map);
 
+        auto prefer_model_exchange = utils::Config::getOr("simulation.model_exchange.prefer", false);
+        std::set<std::string> model_exchange_models;
+        if (auto names = utils::Config::resolvePath("simulation.model_exchange.models"))
+        {
+            model_exchange_models = names->get<std::set<std::string>>();
+        }
+
         log(debug)("[{}] Creating FMU Info map", __func__);
         for (auto &[name, fmu] : fmu_ref_map)
         {
-            fmu_info_map.emplace(name, std::make_unique<FmuInfo>(name, fmu));
+            auto prefer = prefer_model_exchange || model_exchange_models.contains(name);
+            fmu_info_map.emplace(name, std::make_unique<FmuInfo>(name, fmu, prefer));
+            if (fmu_info_map[name]->is_model_exchange())
+            {
+                log(info)("[{}] - {} uses model exchange", __func__, name);
+            }
         }
     }
 
@@ -2,6 +2,7 @@
 
 
 #include "fmi4c_adapter.hpp"
+#include "fmi3_adapter.hpp"
 
 #include "utils/map.hpp"
 
@@ -33,13 +34,23 @@ namespace ssp4sim::handler
 
         // Borrowing
         ssp4cpp::Fmu *fmu;
-        ssp4cpp::fmi2::md::fmi2ModelDescription *model_description;
+        ssp4cpp::fmi2::md::fmi2ModelDescription *model_description; // nullptr for FMI 3.0
 
         // Owning
         std::unique_ptr<FmuInstance> fmi_instance;
-        std::unique_ptr<CoSimulationModel> model;
+        std::unique_ptr<CoSimulationModel> model;       // set for co-simulation
+        std::unique_ptr<ModelExchangeModel> me_model;   // set for model exchange
+        std::unique_ptr<Fmi3CoSimulationModel> fmi3_model; // set for FMI 3.0 co-simulation
 
-        FmuInfo(std::string name, ssp4cpp::Fmu *fmu);
+        // Co-simulation is used when available unless model exchange is preferred
+        FmuInfo(std::string name, ssp4cpp::Fmu *fmu, bool prefer_model_exchange = false);
+
+        bool is_model_exchange() const;
+
+        bool is_fmi3() const;
+
+        // The active instance, regardless of interface
+        FmiModel *get_model();
         // can not be copied, has unique pointers
         FmuInfo(const FmuInfo &) = delete;
         FmuInfo &operator=(const FmuInfo &) = delete;
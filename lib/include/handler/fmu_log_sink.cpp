@@ -0,0 +1,173 @@
+#include "handler/fmu_log_sink.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+namespace ssp4sim::handler
+{
+    namespace
+    {
+        constexpr std::size_t queue_size = 1024;
+
+        void copy_name(char *dest, const char *src)
+        {
+            std::snprintf(dest, FmuLogSink::Message::name_size, "%s", src != nullptr ? src : "");
+        }
+
+        // fmi2Status and fmi3Status share the numbering for OK..Fatal
+        LogLevel to_level(int status)
+        {
+            switch (status)
+            {
+            case 0:
+                return LogLevel::info;
+            case 1:
+            case 2:
+                return LogLevel::warning;
+            case 3:
+                return LogLevel::error;
+            case 4:
+                return LogLevel::fatal;
+            default:
+                return LogLevel::info;
+            }
+        }
+    }
+
+    FmuLogSink::FmuLogSink() : queue(queue_size)
+    {
+    }
+
+    FmuLogSink &FmuLogSink::instance()
+    {
+        static FmuLogSink *sink = new FmuLogSink();
+        return *sink;
+    }
+
+    void FmuLogSink::start()
+    {
+        if (running.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (running.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        running.store(true, std::memory_order_release);
+        worker = std::thread([this]()
+                             { run(); });
+    }
+
+    bool FmuLogSink::vpush(const char *instance, int status, const char *category, const char *fmt, va_list args)
+    {
+        start();
+
+        bool pushed = queue.try_emplace([&](Message &m)
+                                        {
+            m.status = status;
+            copy_name(m.instance, instance);
+            copy_name(m.category, category);
+            std::vsnprintf(m.text, Message::text_size, fmt != nullptr ? fmt : "", args); });
+
+        if (!pushed)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return pushed;
+    }
+
+    bool FmuLogSink::push(const char *instance, int status, const char *category, const char *message)
+    {
+        start();
+
+        bool pushed = queue.try_emplace([&](Message &m)
+                                        {
+            m.status = status;
+            copy_name(m.instance, instance);
+            copy_name(m.category, category);
+            std::snprintf(m.text, Message::text_size, "%s", message != nullptr ? message : ""); });
+
+        if (!pushed)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return pushed;
+    }
+
+    void FmuLogSink::run()
+    {
+        auto idle = std::chrono::microseconds(50);
+        while (running.load(std::memory_order_acquire))
+        {
+            if (drain() > 0)
+            {
+                idle = std::chrono::microseconds(50);
+                continue;
+            }
+
+            std::this_thread::sleep_for(idle);
+            idle = std::min(idle * 2, std::chrono::microseconds(10000));
+        }
+        drain();
+    }
+
+    std::size_t FmuLogSink::drain()
+    {
+        std::lock_guard<std::mutex> lock(drain_mutex);
+
+        std::size_t count = 0;
+        while (queue.try_consume([this](Message &m)
+                                 { forward(m); }))
+        {
+            count += 1;
+        }
+        return count;
+    }
+
+    void FmuLogSink::forward(const Message &message)
+    {
+        auto it = loggers.find(std::string_view(message.instance));
+        if (it == loggers.end())
+        {
+            auto logger = std::make_unique<Logger>(Logger::format("fmu.{}", message.instance), LogLevel::info);
+            it = loggers.emplace(message.instance, std::move(logger)).first;
+        }
+
+        auto &fmu_log = *it->second;
+        fmu_log(to_level(message.status))("({}) status:{} {}", message.category, message.status, message.text);
+    }
+
+    void FmuLogSink::flush()
+    {
+        drain();
+    }
+
+    void FmuLogSink::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            if (running.exchange(false, std::memory_order_acq_rel) && worker.joinable())
+            {
+                worker.join();
+            }
+        }
+
+        auto lost = dropped_.exchange(0, std::memory_order_relaxed);
+        if (lost > 0)
+        {
+            log(warning)("[{}] {} fmu log messages were dropped, the log queue was full", __func__, lost);
+        }
+    }
+
+    uint64_t FmuLogSink::dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+}
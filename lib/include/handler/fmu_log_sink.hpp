@@ -0,0 +1,87 @@
+#pragma once
+
+#include "utils/mpmc_queue.hpp"
+
+#include "cutecpp/log.hpp"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ssp4sim::handler
+{
+
+    /**
+     * @brief Hands fmu log messages to a background thread
+     *
+     * The fmu callbacks format straight into a slot of a lock-free ring and return,
+     * the log thread drains the ring and forwards each message to a "fmu.<instance>" logger.
+     * Messages longer than a slot are truncated, if the ring is full the message is dropped and counted.
+     *
+     * The sink is created on first use and never destroyed since fmus may log from their own threads
+     * during shutdown, shutdown() joins the log thread after a final drain. The next message starts
+     * the thread again, so every simulation in the process may shut the sink down.
+     */
+    class FmuLogSink
+    {
+    public:
+        Logger log = Logger("ssp4sim.handler.FmuLogSink", LogLevel::info);
+
+        struct Message
+        {
+            static constexpr std::size_t name_size = 64;
+            static constexpr std::size_t text_size = 512;
+
+            int status = 0; // fmi2Status or fmi3Status, same numbering
+            char instance[name_size];
+            char category[name_size];
+            char text[text_size];
+        };
+
+        static FmuLogSink &instance();
+
+        FmuLogSink(const FmuLogSink &) = delete;
+        FmuLogSink &operator=(const FmuLogSink &) = delete;
+
+        // Formats fmt into a free slot, returns false if the message was dropped
+        bool vpush(const char *instance, int status, const char *category, const char *fmt, va_list args);
+
+        bool push(const char *instance, int status, const char *category, const char *message);
+
+        // Forward all published messages from the calling thread
+        void flush();
+
+        void shutdown();
+
+        [[nodiscard]] uint64_t dropped() const;
+
+    private:
+        utils::MpmcQueue<Message> queue;
+        std::atomic<uint64_t> dropped_{0};
+
+        std::atomic<bool> running{false};
+        std::mutex state_mutex; // serializes start and shutdown
+        std::thread worker;
+
+        // Only touched while draining
+        std::mutex drain_mutex;
+        std::map<std::string, std::unique_ptr<Logger>, std::less<>> loggers;
+
+        FmuLogSink();
+
+        void start();
+
+        void run();
+
+        // Returns the number of forwarded messages
+        std::size_t drain();
+
+        void forward(const Message &message);
+    };
+}
@@ -23,6 +23,7 @@ namespace ssp4sim::graph
             << ", source_index: " << source_index
             << ", target_index: " << target_index
             << ", forward_derivatives: " << forward_derivatives_order
+            << ", interpolate: " << interpolate
             << " }";
         return oss.str();
     }
@@ -42,6 +43,29 @@ namespace ssp4sim::graph
                 log(ext_trace)("[{}] Fetch valid data connection {}", __func__, connection.to_string());
             });
 
+            size_t before_area, after_area;
+            if (connection.interpolate && connection.type == types::DataType::real &&
+                connection.source_storage->find_interpolation_areas(input_time - connection.delay, before_area, after_area))
+            {
+                auto t0 = connection.source_storage->get_time(before_area);
+                auto t1 = connection.source_storage->get_time(after_area);
+                auto w = static_cast<double>(input_time - connection.delay - t0) / static_cast<double>(t1 - t0);
+
+                auto x0 = reinterpret_cast<double *>(connection.source_storage->get_item(before_area, connection.source_index));
+                auto x1 = reinterpret_cast<double *>(connection.source_storage->get_item(after_area, connection.source_index));
+                auto target = reinterpret_cast<double *>(connection.target_storage->get_item(static_cast<std::size_t>(target_area), connection.target_index));
+
+                for (std::size_t i = 0; i < connection.size / sizeof(double); i++)
+                {
+                    target[i] = x0[i] + w * (x1[i] - x0[i]);
+                }
+
+                IF_LOG({
+                    log(trace)("[{}] Interpolated between {} and {}, weight {}", __func__, t0, t1, w);
+                });
+                continue;
+            }
+
             size_t source_area;
             if (connection.source_storage->find_latest_valid_area(input_time - connection.delay, source_area))
             {
@@ -33,6 +33,9 @@ namespace ssp4sim::graph
 
         uint64_t delay = 0;
 
+        // Linear interpolation of real signals between source samples, used between models of different rates
+        bool interpolate = false;
+
         bool forward_derivatives = false;
         int forward_derivatives_order = 0;
 
@@ -20,6 +20,7 @@ namespace ssp4sim::graph
             << "name: " << name
             << ", type: " << type
             << ", size: " << size
+            << ", count: " << count
             << ", index: " << index
             << ", value_ref: " << value_ref
             << ", forward_derivatives: " << forward_derivatives_order
@@ -40,7 +41,7 @@ namespace ssp4sim::graph
             auto data_type_str = ssp4sim::ext::fmi2::enums::data_type_to_string(connector.type, data_ptr);
             log(debug)("[{}] Set initial value for {}, {} : {}", __func__, name, connector.type.to_string(), data_type_str);
 
-            utils::write_to_model_(connector.type, *connector.fmu->model, connector.value_ref, data_ptr);
+            utils::write_to_model_(connector.type, *connector.fmu->get_model(), connector.value_ref, data_ptr);
         }
     }
 
@@ -95,7 +96,13 @@ namespace ssp4sim::graph
                 log(debug)("[{}] Copying input to model. {}, data: {}", __func__, input.to_string(), data_type_str);
             });
 
-            utils::write_to_model_(input.type, *input.fmu->model, input.value_ref, static_cast<void *>(input_item));
+            if (input.count > 1)
+            {
+                input.fmu->get_model()->write_reals(input.value_ref, reinterpret_cast<double *>(input_item), input.count);
+                continue;
+            }
+
+            utils::write_to_model_(input.type, *input.fmu->get_model(), input.value_ref, static_cast<void *>(input_item));
         }
     }
 
@@ -114,7 +121,13 @@ namespace ssp4sim::graph
                 log(ext_trace)("[{}] Copying ref {} ({}) to index {}", __func__, output.value_ref, output.type.to_string(), output.index);
             });
 
-            utils::read_from_model_(output.type, *output.fmu->model, output.value_ref, static_cast<void *>(item));
+            if (output.count > 1)
+            {
+                output.fmu->get_model()->read_reals(output.value_ref, reinterpret_cast<double *>(item), output.count);
+                continue;
+            }
+
+            utils::read_from_model_(output.type, *output.fmu->get_model(), output.value_ref, static_cast<void *>(item));
 
             IF_LOG({
                 auto data_type_str = ssp4sim::ext::fmi2::enums::data_type_to_string(output.type, item);
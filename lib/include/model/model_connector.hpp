@@ -25,6 +25,7 @@ namespace ssp4sim::graph
 
         types::DataType type;
         size_t size;
+        size_t count = 1;
         std::string name;
 
         uint32_t index;
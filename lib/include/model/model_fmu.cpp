@@ -1,6 +1,7 @@
 #include "model/model_fmu.hpp"
 
 #include "config.hpp"
+#include "FMI2_modelDescription_Ext.hpp"
 #include "signal/storage.hpp"
 #include "handler/fmu_handler.hpp"
 #include "model/model_connection.hpp"
@@ -8,13 +9,34 @@
 #include "utils/time.hpp"
 #include "utils/timer.hpp"
 
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 namespace ssp4sim::graph
 {
+    namespace
+    {
+        // Fixed size non real inputs of an area as bytes
+        void read_held(signal::SignalStorage *storage, std::size_t area, std::vector<std::byte> &held)
+        {
+            held.clear();
+            for (auto &variable : storage->variables)
+            {
+                if (variable.type != types::DataType::real && variable.type != types::DataType::string)
+                {
+                    auto data = storage->get_item(area, variable.index);
+                    held.insert(held.end(), data, data + variable.type_size * variable.count);
+                }
+            }
+        }
+    }
 
     FmuModel::FmuModel(std::string name, ssp4sim::handler::FmuInfo *fmu, size_t maxOutputDerivativeOrder)
         : log(Logger::format("models.{}", name), LogLevel::info)
@@ -25,16 +47,53 @@ namespace ssp4sim::graph
         
         input_area = std::make_unique<ssp4sim::signal::SignalStorage>(10, this->name + ".input");
         output_area = std::make_unique<ssp4sim::signal::SignalStorage>(200, this->name + ".output");
-        forward_derivatives = utils::Config::getOr("simulation.executor.forward_derivatives", true);
+        // Model exchange fmus have no input/output derivatives, their states are integrated by the group
+        forward_derivatives = utils::Config::getOr("simulation.executor.forward_derivatives", true) && !fmu->is_model_exchange();
         fmu_logging = utils::Config::getOr("simulation.log.fmu", false);
+        if (auto categories = utils::Config::resolvePath("simulation.log.fmu_categories"))
+        {
+            fmu_log_categories = categories->get<std::vector<std::string>>();
+        }
+
+        // Multi-rate, an explicit step size wins over the DefaultExperiment of the fmu
+        auto step_sizes = utils::Config::resolvePath("simulation.multi_rate.step_sizes");
+        if (step_sizes != nullptr && step_sizes->contains(this->name))
+        {
+            step_size = utils::time::s_to_ns((*step_sizes)[this->name].get<double>());
+        }
+        else if (utils::Config::getOr("simulation.multi_rate.default_experiment", false) &&
+                 fmu->model_description != nullptr && fmu->model_description->DefaultExperiment &&
+                 fmu->model_description->DefaultExperiment->stepSize)
+        {
+            step_size = utils::time::s_to_ns(*fmu->model_description->DefaultExperiment->stepSize);
+        }
+
+        if (step_size != 0)
+        {
+            log(info)("[{}] {} communication step {}s", __func__, this->name, utils::time::ns_to_s(step_size));
+        }
+
+        // Input derivatives extrapolate from the start of every step, held inputs would change the result
+        collapse_sub_steps = utils::Config::getOr("simulation.executor.collapse_sub_steps", false) && !fmu->is_model_exchange();
+        if (collapse_sub_steps && forward_derivatives)
+        {
+            log(info)("[{}] {} forwards derivatives, sub-steps are not collapsed", __func__, this->name);
+            collapse_sub_steps = false;
+        }
+
+        if (auto quiescent = utils::Config::resolvePath("simulation.quiescence.models"))
+        {
+            auto names = quiescent->get<std::vector<std::string>>();
+            activity.enabled = std::find(names.begin(), names.end(), this->name) != names.end() && !fmu->is_model_exchange();
+        }
     }
 
     FmuModel::~FmuModel()
     {
         log(ext_trace)("[{}] Destroying FmuModel", __func__);
-        if (fmu != nullptr && fmu->model != nullptr)
+        if (fmu != nullptr && fmu->get_model() != nullptr)
         {
-            fmu->model->terminate();
+            fmu->get_model()->terminate();
         }
     }
 
@@ -50,7 +109,15 @@ namespace ssp4sim::graph
     void FmuModel::enter_init()
     {
         log(trace)("[{}] FmuModel init {}", __func__, name);
-        fmu->model->instantiate(false, fmu_logging); // visible, logging on
+        fmu->get_model()->log_categories = fmu_log_categories;
+        fmu->get_model()->instantiate(false, fmu_logging); // visible, logging on
+
+        if (fmu->is_fmi3())
+        {
+            // Publish the outputs at internal events when the fmu returns early
+            fmu->fmi3_model->on_early_return = [this](uint64_t time)
+            { post(time); };
+        }
 
         log(trace)("[{}] Input area: {}", __func__, input_area->to_string());
         log(trace)("[{}] Output area: {}", __func__, output_area->to_string());
@@ -59,19 +126,20 @@ namespace ssp4sim::graph
         double timestep = utils::Config::getDouble("simulation.timestep");
         double end_time = utils::Config::getDouble("simulation.stop_time");
         double tolerance = utils::Config::getDouble("simulation.tolerance");
+        stop_time = utils::time::s_to_ns(end_time);
 
         log(debug)("[{}] setup_experiment: {}", __func__, name);
 
         // The simulation may take one step beyond the stop_time. Some fmus may crash due to this
         // therfore tell the fmus that stop + one step should be ok
-        if (!fmu->model->setup_experiment(utils::time::s_to_ns(start_time), utils::time::s_to_ns(end_time + timestep * 10), tolerance))
+        if (!fmu->get_model()->setup_experiment(utils::time::s_to_ns(start_time), utils::time::s_to_ns(end_time + timestep * 10), tolerance))
         {
             log(error)("[{}] setup_experiment failed for {}, this may be due to a stop time that is larger than the DefaultExperiment specifed in the fmus. ", __func__, name);
             throw std::runtime_error(Logger::format("[{}] setup_experiment failed for {}", __func__, name));
         }
 
         log(debug)("[{}] enter_initialization_mode: {}", __func__, name);
-        if (!fmu->model->enter_initialization_mode())
+        if (!fmu->get_model()->enter_initialization_mode())
         {
             log(error)("[{}] enter_initialization_mode failed for {}", __func__, name);
             throw std::runtime_error(Logger::format("[{}] enter_initialization_mode failed for {}", __func__, name));
@@ -89,12 +157,17 @@ namespace ssp4sim::graph
     {
         log(trace)("[{}] FmuModel init {}", __func__, name);
         log(debug)("[{}] exit_initialization_mode: {}", __func__, name);
-        if (!fmu->model->exit_initialization_mode())
+        if (!fmu->get_model()->exit_initialization_mode())
         {
             log(error)("[{}] exit_initialization_mode failed for {}", __func__, name);
             throw std::runtime_error(Logger::format("[{}] exit_initialization_mode failed for {}", __func__, name));
         }
 
+        if (activity.enabled)
+        {
+            log(info)("[{}] {} is skipped while quiescent", __func__, name);
+        }
+
         log(ext_trace)("[{}] FmuModel init completed", __func__);
     }
 
@@ -123,17 +196,26 @@ namespace ssp4sim::graph
     }
 
     void FmuModel::pre(uint64_t input_time)
+    {
+        apply_inputs(fetch_inputs(input_time));
+    }
+
+    std::size_t FmuModel::fetch_inputs(uint64_t input_time, bool reuse)
     {
         IF_LOG({
             log(trace)("[{}] Init. current_time {}, input_time {}", __func__, current_time, input_time);
         });
 
-        auto target_area = input_area->push(input_time);
+        auto target_area = reuse || reuse_areas ? input_area->get_or_push(input_time) : input_area->push(input_time);
 
         ConnectionInfo::retrieve_model_inputs(connections, target_area, input_time);
 
         input_area->flag_new_data(target_area);
+        return target_area;
+    }
 
+    void FmuModel::apply_inputs(std::size_t target_area)
+    {
         ConnectorInfo::write_data_to_model(inputs, input_area.get(), target_area);
 
         if (forward_derivatives)
@@ -154,7 +236,7 @@ namespace ssp4sim::graph
             log(trace)("[{}] Store results, timestamp: {}", __func__, time);
         });
 
-        auto area = output_area->push(time);
+        auto area = reuse_areas ? output_area->get_or_push(time) : output_area->push(time);
 
         ConnectorInfo::read_values_from_model(outputs, output_area.get(), area);
 
@@ -166,26 +248,250 @@ namespace ssp4sim::graph
         }
         output_area->flag_new_data(area);
 
+        if (activity.enabled)
+        {
+            activity.settled = activity.has_output && activity.output_area != area &&
+                               output_area->get_time(activity.output_area) == activity.output_time &&
+                               output_area->equal_values(area, activity.output_area);
+            activity.has_output = true;
+            activity.output_area = area;
+            activity.output_time = time;
+        }
+
         IF_LOG({
             log(trace)("[{}] Output area after post: {}", __func__, output_area->export_area(area));
         });
     }
 
-    uint64_t FmuModel::step(StepData step_data)
+    uint64_t FmuModel::advance(uint64_t end_time)
     {
         IF_LOG({
-            log(debug)("[{}] Init {}, current_time {}, stepdata: {}", __func__, name, current_time, step_data.to_string());
+            log(debug)("[{}] Step until {}", __func__, end_time);
         });
 
-        pre(step_data.input_time);
+        auto model_timer = utils::time::Timer();
+        if (fmu->is_fmi3())
+        {
+            current_time = fmu->fmi3_model->step_until(end_time);
+        }
+        else
+        {
+            current_time = fmu->model->step_until(end_time);
+        }
+        this->walltime_ns += model_timer.stop();
+        return current_time;
+    }
+
+    bool FmuModel::save_state()
+    {
+        auto model = fmu->get_model();
+        if (fmu->is_model_exchange() || !model->can_save_state())
+        {
+            return false;
+        }
+
+        reuse_areas = false;
+        return model->save_state();
+    }
 
+    bool FmuModel::restore_state()
+    {
+        if (!fmu->get_model()->restore_state())
+        {
+            return false;
+        }
+
+        current_time = fmu->get_model()->get_simulation_time();
+        reuse_areas = true;
+        return true;
+    }
+
+    bool FmuModel::save_snapshot(std::vector<std::byte> &snapshot)
+    {
+        auto model = fmu->get_model();
+        if (fmu->is_model_exchange() || !model->can_serialize_state())
+        {
+            return false;
+        }
+        return model->serialize_state(snapshot);
+    }
+
+    bool FmuModel::load_snapshot(const std::vector<std::byte> &snapshot)
+    {
+        if (!fmu->get_model()->deserialize_state(snapshot))
+        {
+            return false;
+        }
+
+        current_time = fmu->get_model()->get_simulation_time();
+        post(current_time);
+        return true;
+    }
+
+    std::size_t FmuModel::input_values() const
+    {
+        std::size_t values = 0;
+        for (auto &variable : input_area->variables)
+        {
+            if (variable.type == types::DataType::real)
+            {
+                values += variable.count;
+            }
+        }
+        return values;
+    }
+
+    bool FmuModel::fetch_input_values(uint64_t input_time, double *values)
+    {
+        // Repeated fetches of a step overwrite its area
+        auto area = fetch_inputs(input_time, true);
+
+        for (auto &variable : input_area->variables)
+        {
+            if (variable.type == types::DataType::real)
+            {
+                auto data = reinterpret_cast<double *>(input_area->get_item(area, variable.index));
+                values = std::copy(data, data + variable.count, values);
+            }
+        }
+
+        std::vector<std::byte> held;
+        read_held(input_area.get(), area, held);
+        return held == held_inputs;
+    }
+
+    uint64_t FmuModel::step_with_inputs(StepData step_data, const double *values)
+    {
+        std::size_t area;
+        if (!input_area->find_area(step_data.input_time, area))
+        {
+            std::size_t latest;
+            bool has_latest = input_area->find_latest_valid_area(step_data.input_time, latest);
+            area = input_area->push(step_data.input_time);
+            if (has_latest)
+            {
+                input_area->copy_values(latest, area);
+            }
+            input_area->flag_new_data(area);
+        }
+
+        for (auto &variable : input_area->variables)
+        {
+            if (variable.type == types::DataType::real)
+            {
+                auto data = reinterpret_cast<double *>(input_area->get_item(area, variable.index));
+                std::copy(values, values + variable.count, data);
+                values += variable.count;
+            }
+        }
+        read_held(input_area.get(), area, held_inputs);
+
+        apply_inputs(area);
+
+        // The inputs are held for the step, a faster model sub-steps like in invoke
+        auto macro_step = step_data.end_time - step_data.start_time;
+        auto sub_step = step_size != 0 && step_size < macro_step ? step_size : macro_step;
+        while (current_time < step_data.end_time)
+        {
+            advance(std::min(current_time + sub_step, step_data.end_time));
+        }
+
+        post(step_data.output_time);
+        return current_time;
+    }
+
+    double FmuModel::coupling_residual(uint64_t time) const
+    {
+        double result = 0.0;
+        for (auto &c : connections)
+        {
+            if (c.type != types::DataType::real || c.target_storage->data->nr_inserts == 0)
+            {
+                continue;
+            }
+
+            std::size_t source;
+            if (!c.source_storage->find_latest_valid_area(time, source))
+            {
+                continue;
+            }
+
+            // The newest input area holds the values of the last step
+            auto used = reinterpret_cast<double *>(c.target_storage->get_item(c.target_storage->data->get_index_from_pos_rev(0), c.target_index));
+            auto actual = reinterpret_cast<double *>(c.source_storage->get_item(source, c.source_index));
+            for (std::size_t k = 0; k < c.size / sizeof(double); k++)
+            {
+                result = std::max(result, std::abs(used[k] - actual[k]) / (1.0 + std::abs(actual[k])));
+            }
+        }
+        return result;
+    }
+
+    double FmuModel::Activity::skip_ratio() const
+    {
+        auto total = stepped + skipped;
+        return total == 0 ? 0.0 : static_cast<double>(skipped) / static_cast<double>(total);
+    }
+
+    uint64_t FmuModel::step_active(StepData step_data)
+    {
+        auto area = fetch_inputs(step_data.input_time);
+
+        // A repeated step after a rollback overwrites its input area, it is never skipped
+        bool held = !reuse_areas && activity.has_input && activity.input_area != area &&
+                    input_area->get_time(activity.input_area) == activity.input_time &&
+                    input_area->equal_values(area, activity.input_area);
+
+        activity.has_input = true;
+        activity.input_area = area;
+        activity.input_time = step_data.input_time;
+
+        if (held && activity.settled)
+        {
+            IF_LOG({
+                log(trace)("[{}] {} quiescent, skipping {}", __func__, name, step_data.to_string());
+            });
+
+            // The fmu keeps its own time and catches up on the held inputs at the next real step
+            current_time = step_data.end_time;
+            activity.behind = true;
+
+            auto out = output_area->push(step_data.output_time);
+            output_area->copy_values(activity.output_area, out);
+            output_area->flag_new_data(out);
+            activity.output_area = out;
+            activity.output_time = step_data.output_time;
+
+            activity.skipped += 1;
+            return current_time;
+        }
+
+        activity.stepped += 1;
+        if (activity.behind)
+        {
+            advance(step_data.start_time);
+            activity.behind = false;
+        }
+        apply_inputs(area);
+        advance(step_data.end_time);
+        post(step_data.output_time);
+        return current_time;
+    }
+
+    uint64_t FmuModel::step(StepData step_data)
+    {
         IF_LOG({
-            log(debug)("[{}] Step until {}", __func__, step_data.end_time);
+            log(debug)("[{}] Init {}, current_time {}, stepdata: {}", __func__, name, current_time, step_data.to_string());
         });
 
-        auto model_timer = utils::time::Timer();
-        current_time = fmu->model->step_until(step_data.end_time);
-        this->walltime_ns += model_timer.stop();
+        if (activity.enabled)
+        {
+            return step_active(step_data);
+        }
+
+        pre(step_data.input_time);
+
+        advance(step_data.end_time);
 
         post(step_data.output_time);
 
@@ -196,9 +502,86 @@ namespace ssp4sim::graph
         return current_time;
     }
 
+    uint64_t FmuModel::step_held(StepData step_data, uint64_t sub_step)
+    {
+        IF_LOG({
+            log(debug)("[{}] Init {}, current_time {}, sub_step {}, stepdata: {}", __func__, name, current_time, sub_step, step_data.to_string());
+        });
+
+        if (current_time >= step_data.end_time)
+        {
+            return current_time;
+        }
+
+        pre(step_data.input_time);
+
+        // Sub-steps passing a point of the recording grid publish their outputs for the recorder
+        auto output_offset = step_data.output_time - step_data.end_time;
+        auto interval = output_area->recording_interval;
+        while (current_time < step_data.end_time)
+        {
+            auto previous = current_time + output_offset;
+            advance(std::min(current_time + sub_step, step_data.end_time));
+
+            auto output_time = current_time + output_offset;
+            if (current_time < step_data.end_time && (interval == 0 || previous / interval != output_time / interval))
+            {
+                post(output_time);
+            }
+        }
+
+        post(step_data.output_time);
+
+        return current_time;
+    }
+
     uint64_t FmuModel::invoke(StepData step_data)
     {
-        return step(step_data);
+        auto macro_step = step_data.end_time - step_data.start_time;
+        if (step_size == 0 || step_size == macro_step)
+        {
+            return step(step_data);
+        }
+
+        auto output_offset = step_data.output_time > step_data.end_time ? step_data.output_time - step_data.end_time : 0;
+
+        if (step_size < macro_step && collapse_sub_steps && !activity.enabled && step_data.input_time <= current_time)
+        {
+            // The inputs are the same for every sub-step, only outputs on the recording grid and the last are published
+            return step_held(StepData(current_time, step_data.end_time, step_size, step_data.input_time, step_data.end_time + output_offset), step_size);
+        }
+
+        if (step_size < macro_step)
+        {
+            // Fast model, sub-step inside the macro step. Inputs are never sampled after
+            // the input time of the executor to keep parallel executors deterministic
+            while (current_time < step_data.end_time)
+            {
+                auto start = current_time;
+                auto end = std::min(start + step_size, step_data.end_time);
+                step(StepData(start, end, step_size, std::min(start, step_data.input_time), end + output_offset));
+            }
+            return current_time;
+        }
+
+        // Slow model, steps one of its own steps at the start of the period and is held until it is due.
+        // Its outputs lead the simulation time, consumers hold or interpolate towards them
+        if (current_time >= step_data.end_time)
+        {
+            return current_time;
+        }
+
+        auto end = current_time + step_size;
+        if (stop_time != 0)
+        {
+            end = std::min(end, std::max(stop_time, step_data.end_time));
+        }
+
+        IF_LOG({
+            log(debug)("[{}] Slow step {} -> {}", __func__, current_time, end);
+        });
+
+        return step(StepData(current_time, end, step_size, step_data.input_time, end + output_offset));
     }
 
 }
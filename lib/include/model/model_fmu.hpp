@@ -42,6 +42,52 @@ namespace ssp4sim::graph
         bool forward_derivatives = false;
         size_t maxOutputDerivativeOrder = 0;
         bool fmu_logging = false;
+        std::vector<std::string> fmu_log_categories; // empty logs all categories
+
+        uint64_t stop_time = 0;
+
+        // Set after a rollback, a repeated step overwrites the areas of the first attempt
+        bool reuse_areas = false;
+
+        // Sub-steps on held inputs skip the input/output round trips, see step_held
+        bool collapse_sub_steps = false;
+
+        /**
+         * Quiescence, a model that only responds to input changes is not stepped while its inputs
+         * are unchanged since its last step and its outputs did not change in that step. The
+         * outputs are carried forward and the fmu catches up in one step once an input changes.
+         *
+         * Enabled per model with "simulation.quiescence.models". Only list models that respond to
+         * their inputs alone, a model with internal dynamics would be frozen while its inputs hold
+         */
+        struct Activity
+        {
+            bool enabled = false;
+
+            // The outputs did not change in the last step
+            bool settled = false;
+            // The fmu time is behind current_time after skipped steps
+            bool behind = false;
+
+            bool has_input = false;
+            std::size_t input_area = 0;
+            uint64_t input_time = 0;
+
+            bool has_output = false;
+            std::size_t output_area = 0;
+            uint64_t output_time = 0;
+
+            uint64_t stepped = 0;
+            uint64_t skipped = 0;
+
+            // Share of the steps that were skipped
+            double skip_ratio() const;
+        };
+
+        Activity activity;
+
+        // Non real inputs of the last step_with_inputs, compared by fetch_input_values
+        std::vector<std::byte> held_inputs;
 
         FmuModel(std::string name, ssp4sim::handler::FmuInfo *fmu, size_t maxOutputDerivativeOrder);
 
@@ -55,12 +101,57 @@ namespace ssp4sim::graph
 
         uint64_t direct_feedthrough(uint64_t start);
 
+        // fetch_inputs followed by apply_inputs
         void pre(uint64_t input_time);
 
+        // Copy the connected outputs into the input area, returns the area.
+        // With reuse an existing area of input_time is overwritten
+        std::size_t fetch_inputs(uint64_t input_time, bool reuse = false);
+
+        // Write an input area to the fmu
+        void apply_inputs(std::size_t target_area);
+
         void post(uint64_t time);
 
+        // Step the fmu to end_time without touching inputs or outputs
+        uint64_t advance(uint64_t end_time);
+
         uint64_t step(StepData step_data);
 
+        // step, skipped when the model is quiescent
+        uint64_t step_active(StepData step_data);
+
+        /**
+         * Step to the end of step_data in steps of sub_step with inputs held from the input time.
+         * Inputs are written once and outputs are read at the output time, the sub-steps in between
+         * only read outputs when they pass a point of the recording grid. Not used for quiescent
+         * models or when derivatives are forwarded
+         */
+        uint64_t step_held(StepData step_data, uint64_t sub_step);
+
+        bool save_state() override;
+
+        bool restore_state() override;
+
+        // Serialized fmu state, co-simulation fmus with canSerializeFMUstate only
+        bool save_snapshot(std::vector<std::byte> &snapshot) override;
+
+        bool load_snapshot(const std::vector<std::byte> &snapshot) override;
+
+        // The real variables of the input area in storage order
+        std::size_t input_values() const override;
+
+        bool fetch_input_values(uint64_t input_time, double *values) override;
+
+        // Without fetched inputs for the input time the other inputs are held from the latest area
+        uint64_t step_with_inputs(StepData step_data, const double *values) override;
+
+        double coupling_residual(uint64_t time) const override;
+
+        /**
+         * Steps the model with its own communication step if one is configured ("simulation.multi_rate").
+         * Faster models sub-step within the macro step, slower models step ahead once per period.
+         */
         uint64_t invoke(StepData step_data) override final;
     };
 }
@@ -0,0 +1,294 @@
+#include "model/model_me_group.hpp"
+
+#include "config.hpp"
+#include "handler/fmu_handler.hpp"
+#include "utils/time.hpp"
+#include "utils/timer.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace ssp4sim::graph
+{
+
+    ModelExchangeGroup::ModelExchangeGroup(std::string name, std::vector<FmuModel *> models)
+    {
+        this->name = std::move(name);
+
+        std::size_t state_offset = 0;
+        std::size_t indicator_offset = 0;
+        for (auto &model : models)
+        {
+            if (!model->fmu->is_model_exchange())
+            {
+                throw std::runtime_error(Logger::format("[{}] {} is not a model exchange fmu", __func__, model->name));
+            }
+
+            Member m;
+            m.model = model;
+            m.me = model->fmu->me_model.get();
+            m.state_offset = state_offset;
+            m.nr_states = m.me->nr_states();
+            m.indicator_offset = indicator_offset;
+            m.nr_indicators = m.me->nr_event_indicators();
+
+            state_offset += m.nr_states;
+            indicator_offset += m.nr_indicators;
+
+            log(debug)("[{}] Member {}, states {}, event indicators {}", __func__, model->name, m.nr_states, m.nr_indicators);
+            members.push_back(m);
+        }
+
+        states.resize(state_offset);
+        indicators.resize(indicator_offset);
+        previous_indicators.resize(indicator_offset);
+
+        method = utils::Config::getOr("simulation.model_exchange.solver", std::string("rk4"));
+        solver_step = utils::time::s_to_ns(utils::Config::getOr("simulation.model_exchange.step", utils::Config::getDouble("simulation.timestep")));
+        auto tolerance = utils::Config::getOr("simulation.model_exchange.newton_tolerance", 1e-8);
+        auto max_iterations = utils::Config::getOr("simulation.model_exchange.newton_max_iterations", 10);
+
+        ode_solver = solver::make_solver(method, states.size(), [this](double t, const double *x, double *dx)
+                                         { derivatives(t, x, dx); }, tolerance, max_iterations);
+    }
+
+    std::string ModelExchangeGroup::to_string() const
+    {
+        std::ostringstream oss;
+        oss << "ModelExchangeGroup { \n"
+            << "Name: " << name
+            << ", solver: " << method
+            << ", states: " << states.size()
+            << ", event indicators: " << indicators.size()
+            << "\n";
+        for (auto &m : members)
+        {
+            oss << "  Member: " << m.model->name << ", states " << m.nr_states << "\n";
+        }
+        oss << "}\n";
+        return oss.str();
+    }
+
+    void ModelExchangeGroup::enter_init()
+    {
+        log(trace)("[{}] Init {}", __func__, name);
+        for (auto &m : members)
+        {
+            m.model->enter_init();
+        }
+    }
+
+    void ModelExchangeGroup::exit_init()
+    {
+        log(trace)("[{}] Init {}", __func__, name);
+        for (auto &m : members)
+        {
+            m.model->exit_init();
+
+            // The fmu is in event mode after initialization
+            if (!m.me->update_discrete_states() || !m.me->enter_continuous_time_mode())
+            {
+                throw std::runtime_error(Logger::format("[{}] Failed to enter continuous time mode for {}", __func__, m.model->name));
+            }
+
+            if (m.nr_states > 0 && !m.me->get_continuous_states(&states[m.state_offset], m.nr_states))
+            {
+                throw std::runtime_error(Logger::format("[{}] Failed to get initial states for {}", __func__, m.model->name));
+            }
+
+            if (m.nr_indicators > 0)
+            {
+                m.me->get_event_indicators(&previous_indicators[m.indicator_offset], m.nr_indicators);
+            }
+        }
+
+        log(info)("[{}] {}", __func__, to_string());
+    }
+
+    void ModelExchangeGroup::set_states(uint64_t time, const double *x)
+    {
+        for (auto &m : members)
+        {
+            if (!m.me->set_time(time))
+            {
+                throw std::runtime_error(Logger::format("[{}] set_time failed for {}", __func__, m.model->name));
+            }
+
+            if (m.nr_states > 0 && !m.me->set_continuous_states(x + m.state_offset, m.nr_states))
+            {
+                throw std::runtime_error(Logger::format("[{}] set_continuous_states failed for {}", __func__, m.model->name));
+            }
+        }
+    }
+
+    void ModelExchangeGroup::derivatives(double t, const double *x, double *dx)
+    {
+        set_states(utils::time::s_to_ns(t), x);
+
+        for (auto &m : members)
+        {
+            if (m.nr_states > 0 && !m.me->get_derivatives(dx + m.state_offset, m.nr_states))
+            {
+                throw std::runtime_error(Logger::format("[{}] get_derivatives failed for {}", __func__, m.model->name));
+            }
+        }
+    }
+
+    uint64_t ModelExchangeGroup::next_time_event() const
+    {
+        uint64_t next = std::numeric_limits<uint64_t>::max();
+        for (auto &m : members)
+        {
+            if (m.me->event_info.nextEventTimeDefined == fmi2True)
+            {
+                next = std::min(next, utils::time::s_to_ns(m.me->event_info.nextEventTime));
+            }
+        }
+        return next;
+    }
+
+    bool ModelExchangeGroup::handle_events(uint64_t time)
+    {
+        bool any_event = false;
+        for (auto &m : members)
+        {
+            bool step_event = false;
+            bool terminate = false;
+            m.me->completed_integrator_step(step_event, terminate);
+            if (terminate)
+            {
+                throw std::runtime_error(Logger::format("[{}] {} requested termination at {}", __func__, m.model->name, time));
+            }
+
+            bool state_event = false;
+            if (m.nr_indicators > 0)
+            {
+                m.me->get_event_indicators(&indicators[m.indicator_offset], m.nr_indicators);
+                for (auto i = m.indicator_offset; i < m.indicator_offset + m.nr_indicators; i++)
+                {
+                    state_event = state_event || ((previous_indicators[i] > 0) != (indicators[i] > 0));
+                }
+            }
+
+            bool time_event = m.me->event_info.nextEventTimeDefined == fmi2True &&
+                              time >= utils::time::s_to_ns(m.me->event_info.nextEventTime);
+
+            if (step_event || state_event || time_event)
+            {
+                IF_LOG({
+                    log(debug)("[{}] Event in {} at {}, step {}, state {}, time {}", __func__, m.model->name, time, step_event, state_event, time_event);
+                });
+
+                if (!m.me->enter_event_mode() || !m.me->update_discrete_states() || !m.me->enter_continuous_time_mode())
+                {
+                    throw std::runtime_error(Logger::format("[{}] Event handling failed for {} at {}", __func__, m.model->name, time));
+                }
+
+                if (m.nr_states > 0 && m.me->event_info.valuesOfContinuousStatesChanged == fmi2True)
+                {
+                    m.me->get_continuous_states(&states[m.state_offset], m.nr_states);
+                }
+
+                if (m.nr_indicators > 0)
+                {
+                    m.me->get_event_indicators(&indicators[m.indicator_offset], m.nr_indicators);
+                }
+
+                nr_events += 1;
+                any_event = true;
+            }
+        }
+
+        std::swap(previous_indicators, indicators);
+        return any_event;
+    }
+
+    uint64_t ModelExchangeGroup::invoke(StepData step_data)
+    {
+        IF_LOG({
+            log(debug)("[{}] Init {}, current_time {}, stepdata: {}", __func__, name, current_time, step_data.to_string());
+        });
+
+        for (auto &m : members)
+        {
+            m.model->pre(step_data.input_time);
+        }
+
+        auto timer = utils::time::Timer();
+
+        auto t = current_time;
+        while (t < step_data.end_time)
+        {
+            auto h = std::min(solver_step, step_data.end_time - t);
+
+            auto time_event = next_time_event();
+            if (time_event > t && time_event < t + h)
+            {
+                h = time_event - t;
+            }
+
+            ode_solver->step(utils::time::ns_to_s(t), utils::time::ns_to_s(h), states);
+            t += h;
+
+            set_states(t, states.data());
+            if (handle_events(t))
+            {
+                ode_solver->reset();
+            }
+        }
+        current_time = t;
+
+        walltime_ns += timer.stop();
+
+        for (auto &m : members)
+        {
+            m.model->current_time = current_time;
+            m.model->post(step_data.output_time);
+        }
+
+        IF_LOG({
+            log(ext_trace)("[{}] Completed, current_time: {}", __func__, current_time);
+        });
+
+        return current_time;
+    }
+
+    double ModelExchangeGroup::coupling_residual(uint64_t time) const
+    {
+        double result = 0.0;
+        for (auto &m : members)
+        {
+            result = std::max(result, m.model->coupling_residual(time));
+        }
+        return result;
+    }
+
+    void ModelExchangeGroup::load_state(uint64_t time, const double *x)
+    {
+        IF_LOG({
+            log(debug)("[{}] Loading state of {} at {}", __func__, name, time);
+        });
+
+        std::copy(x, x + states.size(), states.begin());
+        set_states(time, states.data());
+
+        for (auto &m : members)
+        {
+            if (m.nr_indicators > 0)
+            {
+                m.me->get_event_indicators(&previous_indicators[m.indicator_offset], m.nr_indicators);
+            }
+        }
+        ode_solver->reset();
+
+        current_time = time;
+        for (auto &m : members)
+        {
+            m.model->current_time = time;
+            m.model->post(time);
+        }
+    }
+}
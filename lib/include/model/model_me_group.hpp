@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ssp4sim_definitions.hpp"
+
+#include "invocable.hpp"
+
+#include "model_fmu.hpp"
+
+#include "solver/ode_solver.hpp"
+
+#include "cutecpp/log.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::graph
+{
+
+    /**
+     * @brief All model exchange fmus integrated by one built-in solver
+     *
+     * The continuous states of every member are stored back to back in one vector,
+     * the solver only ever sees the combined state. Each member is still an FmuModel
+     * that owns its input/output areas and connections, the group replaces them in the
+     * execution graph and is invoked as a single node.
+     *
+     * Events are handled at the end of each internal step: time events shorten the
+     * step to hit the event, state events are detected from sign changes in the
+     * event indicators (no root localization) and step events from completedIntegratorStep.
+     *
+     * Configured through "simulation.model_exchange"
+     */
+    class ModelExchangeGroup final : public Invocable
+    {
+    public:
+        Logger log = Logger("ssp4sim.model.ModelExchangeGroup", LogLevel::info);
+
+        struct Member
+        {
+            FmuModel *model;
+            handler::ModelExchangeModel *me;
+
+            std::size_t state_offset;
+            std::size_t nr_states;
+
+            std::size_t indicator_offset;
+            std::size_t nr_indicators;
+        };
+
+        std::vector<Member> members;
+
+        std::vector<double> states;
+        std::vector<double> indicators;
+        std::vector<double> previous_indicators;
+
+        std::unique_ptr<solver::OdeSolver> ode_solver;
+        std::string method = "rk4";
+        uint64_t solver_step = 0;
+
+        uint64_t nr_events = 0;
+
+        ModelExchangeGroup(std::string name, std::vector<FmuModel *> models);
+
+        std::string to_string() const override;
+
+        void enter_init() override;
+
+        void exit_init() override;
+
+        uint64_t invoke(StepData step_data) override final;
+
+        // Largest residual of the members
+        double coupling_residual(uint64_t time) const override;
+
+        /**
+         * Continue from the combined continuous state x at time, which may be earlier than the
+         * current time. Discrete states are kept. The outputs are posted at time
+         */
+        void load_state(uint64_t time, const double *x);
+
+    private:
+        // Evaluate the derivatives of the combined state
+        void derivatives(double t, const double *x, double *dx);
+
+        // Write the combined state to the fmus at time
+        void set_states(uint64_t time, const double *x);
+
+        // Returns true if any member had an event
+        bool handle_events(uint64_t time);
+
+        // Earliest pending time event, or max when none
+        uint64_t next_time_event() const;
+    };
+}
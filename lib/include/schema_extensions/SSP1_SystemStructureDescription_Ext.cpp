@@ -8,6 +8,11 @@
 
 #include <algorithm>
 #include <initializer_list>
+#include <map>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -24,20 +29,49 @@ namespace ssp4sim::ext::ssp1
 
     namespace ssd
     {
-        std::vector<TComponent *> get_resources(const ssp4cpp::ssp1::ssd::SystemStructureDescription &ssd)
+        static void add_resources(const TSystem &system, vector<TComponent *> &resources)
         {
-            auto resources = vector<TComponent *>();
-
-            if (ssd.System.Elements.has_value())
+            if (system.Elements.has_value())
             {
-                for (auto &comp : ssd.System.Elements.value().Components)
+                for (auto &comp : system.Elements.value().Components)
                 {
                     // Make sure that the object is cast as a non const
                     resources.push_back(const_cast<TComponent *>(&comp));
                 }
+
+                for (auto &sub_system : system.Elements.value().Systems)
+                {
+                    add_resources(sub_system, resources);
+                }
             }
+        }
+
+        std::vector<TComponent *> get_resources(const ssp4cpp::ssp1::ssd::SystemStructureDescription &ssd)
+        {
+            auto resources = vector<TComponent *>();
+            add_resources(ssd.System, resources);
             return resources;
         }
+
+        static void add_sub_systems(const TSystem &system, const std::string &parent, vector<SubSystem> &systems)
+        {
+            if (system.Elements.has_value())
+            {
+                for (auto &sub_system : system.Elements.value().Systems)
+                {
+                    auto name = sub_system.name.value_or("system_" + std::to_string(systems.size()));
+                    systems.push_back({const_cast<TSystem *>(&sub_system), name, parent});
+                    add_sub_systems(sub_system, name, systems);
+                }
+            }
+        }
+
+        std::vector<SubSystem> get_sub_systems(const ssp4cpp::ssp1::ssd::SystemStructureDescription &ssd)
+        {
+            auto systems = vector<SubSystem>();
+            add_sub_systems(ssd.System, "", systems);
+            return systems;
+        }
     }
 
     namespace elements
@@ -88,17 +122,133 @@ namespace ssp4sim::ext::ssp1
             return out;
         }
 
-        std::set<std::pair<std::string, std::string>> get_fmu_connections(const ssp4cpp::ssp1::ssd::SystemStructureDescription &ssd)
+        // Connections of every system, keyed by their start. Components are keyed by "element.connector",
+        // connectors of systems by "/path/of/system/connector" which can not clash with a component
+        using ConnectionEdges = std::map<std::string, vector<const Connection *>>;
+
+        static std::string endpoint_key(const std::string &path,
+                                        const std::set<std::string> &sub_systems,
+                                        const std::optional<std::string> &element,
+                                        const std::string &connector)
         {
-            std::set<std::pair<std::string, std::string>> fmu_connections{};
-            if (ssd.System.Connections.has_value())
+            if (!element.has_value())
+            {
+                return path + "/" + connector;
+            }
+            if (sub_systems.contains(element.value()))
+            {
+                return path + "/" + element.value() + "/" + connector;
+            }
+            return element.value() + "." + connector;
+        }
+
+        static void add_connections(const TSystem &system, const std::string &path, ConnectionEdges &edges, vector<std::pair<std::string, const Connection *>> &all)
+        {
+            std::set<std::string> sub_systems;
+            if (system.Elements.has_value())
+            {
+                for (auto &sub_system : system.Elements.value().Systems)
+                {
+                    auto name = sub_system.name.value_or("");
+                    sub_systems.insert(name);
+                    add_connections(sub_system, path + "/" + name, edges, all);
+                }
+            }
+
+            if (system.Connections.has_value())
+            {
+                for (auto &connection : system.Connections.value().Connections)
+                {
+                    auto start = endpoint_key(path, sub_systems, connection.startElement, connection.startConnector);
+                    auto end = endpoint_key(path, sub_systems, connection.endElement, connection.endConnector);
+                    edges[start].push_back(&connection);
+                    all.push_back({end, &connection});
+                }
+            }
+        }
+
+        static void follow_connection(const ConnectionEdges &edges,
+                                      const std::map<const Connection *, std::string> &targets,
+                                      const Connection &start,
+                                      const Connection *current,
+                                      double delay,
+                                      bool has_delay,
+                                      std::size_t depth,
+                                      vector<Connection> &connections)
+        {
+            if (current->information_delay.has_value())
             {
-                for (auto connection : ssd.System.Connections.value().Connections)
+                delay += current->information_delay.value();
+                has_delay = true;
+            }
+
+            auto &target = targets.at(current);
+            if (target.front() != '/')
+            {
+                auto c = start;
+                c.endElement = current->endElement;
+                c.endConnector = current->endConnector;
+                c.information_delay = has_delay ? std::optional<double>(delay) : std::nullopt;
+                connections.push_back(std::move(c));
+                return;
+            }
+
+            if (depth > edges.size())
+            {
+                log(error)("[{}] Connection loop through the system connector {}", __func__, target);
+                throw std::runtime_error("Connection loop between system connectors");
+            }
+
+            auto next = edges.find(target);
+            if (next == edges.end())
+            {
+                log(warning)("[{}] System connector {} is not connected to any component", __func__, target);
+                return;
+            }
+
+            for (auto connection : next->second)
+            {
+                follow_connection(edges, targets, start, connection, delay, has_delay, depth + 1, connections);
+            }
+        }
+
+        std::vector<Connection> get_component_connections(const ssp4cpp::ssp1::ssd::SystemStructureDescription &ssd)
+        {
+            ConnectionEdges edges;
+            vector<std::pair<std::string, const Connection *>> all;
+            add_connections(ssd.System, "", edges, all);
+
+            std::map<const Connection *, std::string> targets;
+            for (auto &[target, connection] : all)
+            {
+                targets[connection] = target;
+            }
+
+            vector<Connection> connections;
+            for (auto &[start, outgoing] : edges)
+            {
+                // Only follow connections that start at a component
+                if (start.front() == '/')
+                {
+                    continue;
+                }
+
+                for (auto connection : outgoing)
                 {
-                    auto p = std::make_pair(connection.startElement.value(), connection.endElement.value());
-                    fmu_connections.insert(p);
+                    follow_connection(edges, targets, *connection, connection, 0.0, false, 0, connections);
                 }
             }
+            return connections;
+        }
+
+        std::set<std::pair<std::string, std::string>> get_fmu_connections(const ssp4cpp::ssp1::ssd::SystemStructureDescription &ssd)
+        {
+            std::set<std::pair<std::string, std::string>> fmu_connections{};
+            for (auto &connection : get_component_connections(ssd))
+            {
+                auto p = std::make_pair(connection.startElement.value(), connection.endElement.value());
+                fmu_connections.insert(p);
+            }
             return fmu_connections;
         }
 
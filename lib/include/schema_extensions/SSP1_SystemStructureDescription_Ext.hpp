@@ -23,7 +23,19 @@ namespace ssp4sim::ext::ssp1
     {
         inline auto log = Logger("ssp4sim.ext.ssp.ssp1.ssd", LogLevel::debug);
 
+        // Components of the system and of all nested systems
         std::vector<TComponent *> get_resources(const SystemStructureDescription &ssd);
+
+        struct SubSystem
+        {
+            TSystem *system;
+            std::string name;
+            // Name of the enclosing system, empty directly below the top level system
+            std::string parent;
+        };
+
+        // Nested systems, depth first with every system before the systems it contains
+        std::vector<SubSystem> get_sub_systems(const SystemStructureDescription &ssd);
     }
 
     namespace elements
@@ -39,6 +51,10 @@ namespace ssp4sim::ext::ssp1
             Elements &elements,
             std::initializer_list<types::Causality> causalities);
 
+        // Connections between components on any level. Connections routed through the connectors
+        // of nested systems are joined into one, their information delays are added
+        std::vector<Connection> get_component_connections(const SystemStructureDescription &ssd);
+
         // Get connections between fmus
         // return a set of <source_fmu, target_fmu> strings
         std::set<std::pair<std::string, std::string>> get_fmu_connections(const SystemStructureDescription &ssd);
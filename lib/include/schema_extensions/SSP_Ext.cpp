@@ -1,6 +1,8 @@
 
 #include "SSP_Ext.hpp"
 
+#include "SSP1_SystemStructureDescription_Ext.hpp"
+
 #include <map>
 #include <memory>
 #include <string>
@@ -49,17 +51,7 @@ namespace ssp4sim::ext::ssp
 
     std::vector<ssp4cpp::ssp1::ssd::TComponent *> get_resources(const ssp4cpp::ssp1::ssd::SystemStructureDescription &ssd)
     {
-        auto resources = std::vector<ssp4cpp::ssp1::ssd::TComponent *>();
-
-        if (ssd.System.Elements.has_value())
-        {
-            for (auto &comp : ssd.System.Elements.value().Components)
-            {
-                // Make sure that the object is cast as a non const
-                resources.push_back(const_cast<ssp4cpp::ssp1::ssd::TComponent *>(&comp));
-            }
-        }
-        return resources;
+        return ext::ssp1::ssd::get_resources(ssd);
     }
 
 }
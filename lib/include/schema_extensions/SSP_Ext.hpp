@@ -21,7 +21,7 @@ namespace ssp4sim::ext::ssp
      */
     std::map<std::string, std::unique_ptr<ssp4cpp::Fmu>> create_fmu_map(ssp4cpp::Ssp &ssp);
 
-    
+    // Components of the top level system and of all nested systems
     std::vector<ssp4cpp::ssp1::ssd::TComponent *> get_resources(const ssp4cpp::ssp1::ssd::SystemStructureDescription &ssd);
 
 }
@@ -0,0 +1,131 @@
+#include "signal/csv_writer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace ssp4sim::signal
+{
+
+    CsvWriter::CsvWriter(const std::string &filename, std::size_t buffer_size)
+        : file(filename, std::ios::out | std::ios::binary), buffer(std::max(buffer_size, max_number_size))
+    {
+    }
+
+    CsvWriter::~CsvWriter()
+    {
+        close();
+    }
+
+    bool CsvWriter::is_open() const
+    {
+        return file.is_open();
+    }
+
+    char *CsvWriter::reserve(std::size_t size)
+    {
+        if (used + size > buffer.size())
+        {
+            drain();
+        }
+        return buffer.data() + used;
+    }
+
+    void CsvWriter::drain()
+    {
+        if (used > 0 && file.is_open())
+        {
+            file.write(buffer.data(), static_cast<std::streamsize>(used));
+        }
+        used = 0;
+    }
+
+    void CsvWriter::write(std::string_view text)
+    {
+        if (text.size() > buffer.size())
+        {
+            drain();
+            if (file.is_open())
+            {
+                file.write(text.data(), static_cast<std::streamsize>(text.size()));
+            }
+            return;
+        }
+
+        std::memcpy(reserve(text.size()), text.data(), text.size());
+        used += text.size();
+    }
+
+    void CsvWriter::write(char c)
+    {
+        *reserve(1) = c;
+        used += 1;
+    }
+
+    void CsvWriter::write(double value)
+    {
+        auto begin = reserve(max_number_size);
+        auto result = std::to_chars(begin, begin + max_number_size, value);
+        used += static_cast<std::size_t>(result.ptr - begin);
+    }
+
+    void CsvWriter::write(int64_t value)
+    {
+        auto begin = reserve(max_number_size);
+        auto result = std::to_chars(begin, begin + max_number_size, value);
+        used += static_cast<std::size_t>(result.ptr - begin);
+    }
+
+    void CsvWriter::write(uint64_t value)
+    {
+        auto begin = reserve(max_number_size);
+        auto result = std::to_chars(begin, begin + max_number_size, value);
+        used += static_cast<std::size_t>(result.ptr - begin);
+    }
+
+    void CsvWriter::write(bool value)
+    {
+        write(value ? '1' : '0');
+    }
+
+    void CsvWriter::write(types::DataType type, const void *data)
+    {
+        switch (type)
+        {
+        case types::DataType::real:
+            write(*static_cast<const double *>(data));
+            return;
+        case types::DataType::boolean:
+            write(*static_cast<const bool *>(data));
+            return;
+        case types::DataType::integer:
+        case types::DataType::enumeration:
+            write(static_cast<int64_t>(*static_cast<const int *>(data)));
+            return;
+        case types::DataType::string:
+            write(std::string_view(*static_cast<const std::string *>(data)));
+            return;
+        default:
+            write(std::string_view("<bin>"));
+            return;
+        }
+    }
+
+    void CsvWriter::flush()
+    {
+        drain();
+        if (file.is_open())
+        {
+            file.flush();
+        }
+    }
+
+    void CsvWriter::close()
+    {
+        flush();
+        if (file.is_open())
+        {
+            file.close();
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ssp4sim_definitions.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace ssp4sim::signal
+{
+    /**
+     * @brief Buffered text writer for the result file
+     *
+     * Values are formatted with std::to_chars into one reusable buffer, reals as the shortest
+     * string that reads back to the same double. The buffer is handed to the file in large
+     * chunks when it fills up or on flush, no allocation is made per value.
+     */
+    class CsvWriter
+    {
+    public:
+        static constexpr std::size_t default_buffer_size = 1 << 20;
+
+        explicit CsvWriter(const std::string &filename, std::size_t buffer_size = default_buffer_size);
+
+        CsvWriter(const CsvWriter &) = delete;
+        CsvWriter &operator=(const CsvWriter &) = delete;
+
+        ~CsvWriter();
+
+        bool is_open() const;
+
+        void write(std::string_view text);
+
+        void write(char c);
+
+        void write(double value);
+
+        void write(int64_t value);
+
+        void write(uint64_t value);
+
+        // Booleans are written as 1 or 0
+        void write(bool value);
+
+        // A value of the storage layout of type
+        void write(types::DataType type, const void *data);
+
+        // Hand the buffer to the file and flush the file
+        void flush();
+
+        void close();
+
+        CsvWriter &operator<<(std::string_view text)
+        {
+            write(text);
+            return *this;
+        }
+
+        CsvWriter &operator<<(const char *text)
+        {
+            write(std::string_view(text));
+            return *this;
+        }
+
+        CsvWriter &operator<<(char c)
+        {
+            write(c);
+            return *this;
+        }
+
+        CsvWriter &operator<<(double value)
+        {
+            write(value);
+            return *this;
+        }
+
+        template <std::integral T>
+            requires(!std::same_as<T, char> && !std::same_as<T, bool>)
+        CsvWriter &operator<<(T value)
+        {
+            if constexpr (std::is_signed_v<T>)
+            {
+                write(static_cast<int64_t>(value));
+            }
+            else
+            {
+                write(static_cast<uint64_t>(value));
+            }
+            return *this;
+        }
+
+    private:
+        // Longest shortest round-trip double is 24 characters
+        static constexpr std::size_t max_number_size = 32;
+
+        std::ofstream file;
+        std::vector<char> buffer;
+        std::size_t used = 0;
+
+        // Make room for size characters
+        char *reserve(std::size_t size);
+
+        void drain();
+    };
+}
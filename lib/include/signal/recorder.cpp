@@ -5,15 +5,11 @@
 
 #include "config.hpp"
 
-#include "FMI2_Enums_Ext.hpp"
-
 #include "cutecpp/log.hpp"
 
 #include <cstddef>
 #include <cstring>
 #include <memory>
-#include <thread>
-#include <unistd.h>
 #include <utility>
 #include <vector>
 
@@ -21,7 +17,7 @@ namespace ssp4sim::signal
 {
 
     DataRecorder::DataRecorder(const std::string &filename, uint64_t interval, bool wait_for)
-        : file(filename, std::ios::out)
+        : file(filename)
     {
         log(ext_trace)("[{}] Constructor", __func__);
         log(debug)("[{}] Recording interval {}", __func__, recording_interval);
@@ -51,6 +47,10 @@ namespace ssp4sim::signal
 
             row_size += storage->mem_size;
 
+            storage->set_recording_grid(recording_interval, interpolate);
+            storage->on_backlog = [this]()
+            { update(); };
+
             log(trace)("[{}] Adding tracker, storage: {}", __func__, storage->name);
 
             tracker_index++;
@@ -74,7 +74,16 @@ namespace ssp4sim::signal
         {
             for (const auto &var : tracker.storage->variables)
             {
-                file << ',' << var.name;
+                if (var.count == 1)
+                {
+                    file << ',' << var.name;
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < var.count; i++)
+                {
+                    file << ',' << var.name << '[' << i << ']';
+                }
             }
         }
         file << '\n';
@@ -108,10 +117,8 @@ namespace ssp4sim::signal
     void DataRecorder::start_recording()
     {
         log(info)("[{}] Starting recording", __func__);
+        scheduler = &utils::TaskScheduler::instance();
         running = true;
-        worker = std::make_unique<std::thread>([this]()
-                                               { loop(); });
-        usleep(100);
     }
 
     void DataRecorder::stop_recording()
@@ -124,12 +131,16 @@ namespace ssp4sim::signal
 
         running = false;
 
-        usleep(100);
-        update();
+        // Finish the drain in flight and collect what arrived after it
+        scheduler->wait(drains);
+        collect();
 
-        if (worker && worker->joinable())
+        for (auto &tracker : trackers)
         {
-            worker->join();
+            if (auto dropped = tracker.storage->dropped_events.load(std::memory_order_relaxed))
+            {
+                log(warning)("[{}] {} events of {} were dropped, their rows may be incomplete", __func__, dropped, tracker.storage->name);
+            }
         }
 
         for (int i = 1; i <= rows; i++)
@@ -178,76 +189,91 @@ namespace ssp4sim::signal
                     log(ext_trace)("[{}] Printing tracker: {}, item:{}", __func__, tracker.storage->name, var.name);
                 });
 
-                auto pos = var.position;
                 auto type = var.type;
-                file << ", ";
-                if (updated_tracker[row][tracker.index])
+                for (std::size_t i = 0; i < var.count; i++)
                 {
-                    auto data_type_str = ssp4sim::ext::fmi2::enums::data_type_to_string(type, get_data_pos(row, tracker.row_pos + pos));
-                    file << data_type_str;
+                    auto pos = var.position + i * var.type_size;
+                    file << ", ";
+                    if (updated_tracker[row][tracker.index])
+                    {
+                        file.write(type, get_data_pos(row, tracker.row_pos + pos));
+                    }
                 }
             }
         }
         file << '\n';
         printed_rows += 1;
+    }
+
+    void DataRecorder::update()
+    {
+        IF_LOG({
+            log(ext_trace)("[{}] Requesting a drain", __func__);
+        });
+
+        if (!running || paused)
+        {
+            return;
+        }
 
-        if (printed_rows % 50 == 0)
+        // Only the first request spawns, later ones make the running drain do another pass
+        if (drain_requests.fetch_add(1, std::memory_order_acq_rel) == 0)
         {
-            file.flush();
+            scheduler->spawn(drains, [](void *context, std::size_t)
+                             { static_cast<DataRecorder *>(context)->drain(); }, this);
         }
     }
 
-    void DataRecorder::update()
+    void DataRecorder::drain()
     {
-        log(ext_trace)("[{}] Notifying recording to update", __func__);
+        auto seen = drain_requests.load(std::memory_order_acquire);
+        do
+        {
+            collect();
+        } while (!drain_requests.compare_exchange_strong(seen, 0, std::memory_order_acq_rel));
     }
 
-    void DataRecorder::loop()
+    void DataRecorder::collect()
     {
-        log(debug)("[{}] Starting recording thread", __func__);
+        IF_LOG({
+            log(ext_trace)("[{}] Looking for new content to write to file", __func__);
+        });
 
-        while (running)
+        // Only the flagged areas are visited, the cost follows the amount of new data
+        for (auto &tracker : trackers)
         {
-            IF_LOG({
-                log(ext_trace)("[{}] Looking for new content to write to file", __func__);
-            });
-
-            for (auto &tracker : trackers)
+            auto storage = tracker.storage;
+            DataEvent event;
+            while (storage->take_new_data(event))
             {
                 IF_LOG({
-                    log(ext_trace)("[{}] Evaluating storage {}", __func__, tracker.storage->to_string());
+                    log(trace)("[{}] Found new data; storage: {}, area: {}, time: {}", __func__, storage->name, event.area, event.time);
                 });
 
-                for (std::size_t area = 0; area < tracker.storage->areas; ++area)
-                {
-                    auto storage = tracker.storage;
-                    if (storage->new_data_flags[area])
-                    {
-                        IF_LOG({
-                            log(trace)("[{}] Found new data; area: {}", __func__, area);
-                        });
-
-                        process_new_data(tracker, storage, area);
-                        storage->new_data_flags[area] = false;
-                    }
-                }
+                process_new_data(tracker, storage, event);
             }
         }
-
-        log(debug)("[{}] Exiting recording thread", __func__);
     }
 
-    void DataRecorder::process_new_data(ssp4sim::signal::Tracker &tracker, signal::SignalStorage *storage, std::size_t area)
+    void DataRecorder::process_new_data(ssp4sim::signal::Tracker &tracker, signal::SignalStorage *storage, const signal::DataEvent &event)
     {
-        auto ts = storage->get_time(area);
+        auto area = event.area;
+        auto ts = event.time;
 
-        if (!time_row_map.contains(ts))
+        // The area was reused for a later time before the drain, its event has been queued again
+        if (storage->get_time(area) != event.area_time)
         {
             IF_LOG({
-                log(trace)("[{}] New print time: {}, last_print_time {}", __func__, ts, last_print_time);
+                log(debug)("[{}] Stale area; storage: {}, area: {}, time: {}", __func__, storage->name, area, ts);
             });
+            return;
+        }
 
-            last_print_time += recording_interval;
+        if (!time_row_map.contains(ts))
+        {
+            IF_LOG({
+                log(trace)("[{}] New print time: {}", __func__, ts);
+            });
 
             head = static_cast<uint16_t>((head + 1) % rows);
             if (new_item_counter >= rows)
@@ -277,27 +303,93 @@ namespace ssp4sim::signal
             });
 
             std::memcpy(get_data_pos(row, tracker.row_pos), storage->locations[area][0], tracker.size);
+            if (event.interpolated())
+            {
+                interpolate_row(row, tracker, storage, event);
+            }
             updated_tracker[row][tracker.index] = true;
         }
     }
 
+    void DataRecorder::interpolate_row(std::size_t row, ssp4sim::signal::Tracker &tracker, signal::SignalStorage *storage, const signal::DataEvent &event)
+    {
+        auto t0 = storage->get_time(event.previous);
+        auto t1 = storage->get_time(event.area);
+
+        // The previous area has been reused since, keep the values of the area
+        if (t0 > event.time || t1 < event.time || t1 == t0)
+        {
+            return;
+        }
+
+        auto w = static_cast<double>(event.time - t0) / static_cast<double>(t1 - t0);
+        for (auto &var : storage->variables)
+        {
+            if (var.type != types::DataType::real)
+            {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < var.count; i++)
+            {
+                auto offset = var.position + i * var.type_size;
+                double before;
+                double after;
+                std::memcpy(&before, storage->locations[event.previous][0] + offset, sizeof(double));
+                std::memcpy(&after, storage->locations[event.area][0] + offset, sizeof(double));
+
+                double value = before + w * (after - before);
+                std::memcpy(get_data_pos(row, tracker.row_pos + offset), &value, sizeof(double));
+            }
+        }
+    }
+
     void DataRecorder::wait_until_done()
     {
-        bool unprocessed_data;
-        do
+        if (running)
         {
-            unprocessed_data = false;
-            for (auto &tracker : trackers)
+            scheduler->wait(drains);
+        }
+    }
+
+    void DataRecorder::discard_new_data()
+    {
+        for (auto &tracker : trackers)
+        {
+            DataEvent event;
+            while (tracker.storage->take_new_data(event))
             {
-                for (std::size_t area = 0; area < tracker.storage->areas; ++area)
-                {
-                    if (tracker.storage->new_data_flags[area])
-                    {
-                        unprocessed_data = true;
-                    }
-                }
             }
-        } while (unprocessed_data);
+        }
+    }
+
+    void DataRecorder::pause()
+    {
+        paused = true;
+    }
+
+    void DataRecorder::resume()
+    {
+        if (!paused)
+        {
+            return;
+        }
+
+        wait_until_done();
+        discard_new_data();
+        paused = false;
+    }
+
+    void DataRecorder::flush()
+    {
+        if (!running || paused)
+        {
+            return;
+        }
+
+        update();
+        scheduler->wait(drains);
+        file.flush();
     }
 
 }
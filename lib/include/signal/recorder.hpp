@@ -5,20 +5,19 @@
 
 #include "ssp4sim_definitions.hpp"
 
+#include "signal/csv_writer.hpp"
 #include "signal/storage.hpp"
 #include "signal/record_tracker.hpp"
 
-#include <fstream>
+#include "utils/task_scheduler.hpp"
+
 #include <cstddef>
 #include <cstdint>
 #include <unordered_map>
 #include <memory>
-#include <mutex>
-#include <thread>
 #include <atomic>
 #include <string>
 #include <vector>
-#include <condition_variable>
 
 namespace ssp4sim::signal
 {
@@ -36,12 +35,16 @@ namespace ssp4sim::signal
     public:
         Logger log = Logger("ssp4sim.record.DataRecorder", LogLevel::info);
 
-        std::ofstream file;
-        std::unique_ptr<std::thread> worker;
+        CsvWriter file;
 
         std::atomic<bool> running;
-        std::mutex event_mutex;
-        std::condition_variable event;
+        // Data produced while paused is dropped
+        std::atomic<bool> paused{false};
+
+        // New data is collected by drain tasks on the shared scheduler, at most one at a time
+        utils::TaskScheduler *scheduler = nullptr;
+        utils::TaskGroup drains;
+        std::atomic<uint64_t> drain_requests{0};
 
         std::vector<Tracker> trackers;
         std::size_t tracker_index = 0;
@@ -57,12 +60,13 @@ namespace ssp4sim::signal
         std::unique_ptr<std::byte[]> data;
         std::vector<std::vector<std::atomic<bool>>> updated_tracker; // [row][tracker] bool to signify if the tracker is updated
 
-        uint64_t last_print_time = 0;
         size_t printed_rows = 0;
 
         // config
         uint64_t recording_interval = 0;
         bool wait_for_recorder = false;
+        // Record real signals interpolated onto the grid points instead of the first area after them
+        bool interpolate = false;
 
 
         DataRecorder(const std::string &filename, uint64_t interval, bool wait_for);
@@ -72,6 +76,7 @@ namespace ssp4sim::signal
 
         ~DataRecorder();
 
+        // The storage only hands over the areas on the recording grid
         void add_storage(SignalStorage *storage);
 
         void reset_update_status(std::size_t row);
@@ -88,12 +93,33 @@ namespace ssp4sim::signal
 
         void print_row(uint16_t row);
 
+        // Request a drain of the storages, called by the executors after each step and by
+        // storages with a backlog, see SignalStorage::on_backlog
         void update();
 
-        void loop();
+        // Collect new data until no further drain has been requested
+        void drain();
+
+        // One pass over all storages
+        void collect();
+
+        void process_new_data(ssp4sim::signal::Tracker &tracker, signal::SignalStorage *storage, const signal::DataEvent &event);
 
-        void process_new_data(ssp4sim::signal::Tracker &tracker, signal::SignalStorage *storage, std::size_t area);
+        // Write the real signals of the row as interpolated between the areas of the event
+        void interpolate_row(std::size_t row, ssp4sim::signal::Tracker &tracker, signal::SignalStorage *storage, const signal::DataEvent &event);
 
         void wait_until_done();
+
+        // Drop data produced while not recording, such as the iterations of a parareal run
+        void discard_new_data();
+
+        // Skip the steps that follow, used by real-time pacing under pressure
+        void pause();
+
+        // Continue with the next step, the data of the paused steps is discarded
+        void resume();
+
+        // Collect the new data and write it to the file
+        void flush();
     };
 }
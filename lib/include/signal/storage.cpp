@@ -1,6 +1,7 @@
 #include "signal/storage.hpp"
 
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
@@ -11,14 +12,20 @@ namespace ssp4sim::signal
 
     const size_t derivative_size = sizeof(double);
 
-    SignalStorage::SignalStorage(std::size_t areas, std::string name) : new_data_flags(areas)
+    SignalStorage::SignalStorage(std::size_t areas, std::string name)
+        : new_data_flags(areas), new_data_events(std::max<std::size_t>(2 * areas, 1)), queued_times(areas)
     {
         this->areas = areas;
         this->name = std::move(name);
     }
 
-    size_t SignalStorage::add(std::string name, types::DataType type, size_t max_interpolation_order)
+    size_t SignalStorage::add(std::string name, types::DataType type, size_t max_interpolation_order, size_t count)
     {
+        if (count == 0 || (count > 1 && (type == types::DataType::string || max_interpolation_order > 0)))
+        {
+            throw std::runtime_error(Logger::format("[{}] Unsupported array signal {}, count {}", __func__, name, count));
+        }
+
         auto position = 0;
         if (!variables.empty())
         {
@@ -32,10 +39,11 @@ namespace ssp4sim::signal
         d.max_interpolation_orders = max_interpolation_order;
 
         d.type_size = ssp4sim::ext::fmi2::enums::get_data_type_size(type);
-        d.total_size =  d.type_size + max_interpolation_order *derivative_size;
+        d.count = count;
+        d.total_size =  d.type_size * count + max_interpolation_order *derivative_size;
 
         d.position = position;
-        d.derivate_position = position + d.type_size;
+        d.derivate_position = position + d.type_size * count;
 
         this->mem_size += d.total_size;
 
@@ -109,6 +117,11 @@ namespace ssp4sim::signal
         return data->find_latest_valid_index(time, found_index);
     }
 
+    bool SignalStorage::find_interpolation_areas(uint64_t time, size_t &before, size_t &after)
+    {
+        return data->find_bracketing_indices(time, before, after);
+    }
+
     std::uint64_t SignalStorage::get_time(std::size_t area)
     {
         return data->get_time(area);
@@ -133,14 +146,146 @@ namespace ssp4sim::signal
         return nullptr;
     }
 
+    void SignalStorage::set_recording_grid(uint64_t interval, bool interpolate)
+    {
+        recording_interval = interval;
+        recording_interpolate = interpolate;
+        next_recording_time = 0;
+        has_last = false;
+    }
+
+    void SignalStorage::queue_new_data(std::size_t area, std::size_t previous, uint64_t time)
+    {
+        auto area_time = get_time(area);
+        last_event = {area, previous, time, area_time};
+        last_queued = true;
+
+        // An area already waiting for the recorder is only queued again if it was reused for
+        // another time. Each reuse before a drain queues another event, so a recorder that falls
+        // behind can fill the queue
+        auto waiting = new_data_flags[area].exchange(true, std::memory_order_acq_rel);
+        if (!waiting || queued_times[area] != area_time)
+        {
+            queued_times[area] = area_time;
+            if (!new_data_events.try_push(last_event))
+            {
+                // The drain is asynchronous, the event is lost
+                if (dropped_events.fetch_add(1, std::memory_order_relaxed) == 0)
+                {
+                    log(warning)("[{}] {} dropped an event for the recorder at {}, the recorder does not keep up", __func__, name, time);
+                }
+            }
+            if (on_backlog && 2 * new_data_events.size() >= areas)
+            {
+                on_backlog();
+            }
+        }
+    }
+
     void SignalStorage::flag_new_data(std::size_t area)
     {
-        if (allocated)
+        if (!allocated)
+        {
+            return;
+        }
+
+        auto time = get_time(area);
+        if (recording_interval == 0)
+        {
+            queue_new_data(area, area, time);
+            return;
+        }
+
+        // Rewritten at the same time, the recorder takes the area again if it was on the grid
+        if (has_last && area == last_area && time == last_time)
+        {
+            if (last_queued)
+            {
+                queue_new_data(last_event.area, last_event.previous, last_event.time);
+            }
+            return;
+        }
+        last_queued = false;
+
+        // Rolled back, the grid continues from the new time
+        if (has_last && time < last_time)
+        {
+            next_recording_time = (time + recording_interval - 1) / recording_interval * recording_interval;
+        }
+
+        if (time >= next_recording_time)
+        {
+            auto grid_time = next_recording_time;
+            if (time % recording_interval != 0 && recording_interpolate && has_last && last_time < grid_time && last_area != area)
+            {
+                queue_new_data(area, last_area, grid_time);
+            }
+            else
+            {
+                queue_new_data(area, area, time);
+            }
+            next_recording_time = (time / recording_interval + 1) * recording_interval;
+        }
+
+        last_time = time;
+        last_area = area;
+        has_last = true;
+    }
+
+    bool SignalStorage::take_new_data(DataEvent &event)
+    {
+        if (!new_data_events.try_pop(event))
+        {
+            return false;
+        }
+
+        // Data written after this point flags the area again
+        new_data_flags[event.area].exchange(false, std::memory_order_acq_rel);
+        return true;
+    }
+
+    bool SignalStorage::equal_values(std::size_t a, std::size_t b)
+    {
+        for (auto &var : variables)
         {
-            new_data_flags[area] = true;
+            auto first = locations[a][var.index];
+            auto second = locations[b][var.index];
+            if (var.type == types::DataType::string)
+            {
+                if (*reinterpret_cast<std::string *>(first) != *reinterpret_cast<std::string *>(second))
+                {
+                    return false;
+                }
+            }
+            else if (std::memcmp(first, second, var.type_size * var.count) != 0)
+            {
+                return false;
+            }
         }
+        return true;
     }
 
+    void SignalStorage::copy_values(std::size_t from, std::size_t to)
+    {
+        for (auto &var : variables)
+        {
+            auto source = locations[from][var.index];
+            auto target = locations[to][var.index];
+            if (var.type == types::DataType::string)
+            {
+                *reinterpret_cast<std::string *>(target) = *reinterpret_cast<std::string *>(source);
+            }
+            else
+            {
+                std::memcpy(target, source, var.type_size * var.count);
+            }
+
+            if (var.max_interpolation_orders > 0)
+            {
+                std::memset(derivate_locations[to][var.index], 0, var.max_interpolation_orders * derivative_size);
+            }
+        }
+    }
 
     std::string SignalStorage::to_string() const
     {
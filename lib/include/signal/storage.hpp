@@ -1,6 +1,7 @@
 #pragma once
 
 #include "utils/ring_buffer.hpp"
+#include "utils/spsc_queue.hpp"
 
 #include "FMI2_Enums_Ext.hpp"
 
@@ -9,6 +10,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -30,6 +32,7 @@ namespace ssp4sim::signal
         types::DataType type;
         std::string name;
         size_t type_size;
+        size_t count; // number of elements, arrays are stored contiguously
         size_t max_interpolation_orders;
         size_t total_size; // size of data and derivate
  
@@ -38,6 +41,21 @@ namespace ssp4sim::signal
 
      };
 
+    // New data for the recorder. With interpolation the values at time lie between previous and area.
+    // area_time is the time of area when it was flagged, the area is stale once its time differs
+    struct DataEvent
+    {
+        std::size_t area = 0;
+        std::size_t previous = 0;
+        uint64_t time = 0;
+        uint64_t area_time = 0;
+
+        bool interpolated() const
+        {
+            return previous != area;
+        }
+    };
+
     class SignalStorage : public types::IWritable
     {
     public:
@@ -52,13 +70,28 @@ namespace ssp4sim::signal
         std::vector<std::vector<std::byte *>> derivate_locations; // absolute location in memory
         std::vector<std::atomic<bool>> new_data_flags;
 
+        // Areas with new data for the recorder, one event per flagged area. The model that
+        // owns the storage produces and the recorder drain consumes
+        utils::SpscQueue<DataEvent> new_data_events;
+
+        // Called by the producer once half of the areas wait for the recorder, so the recorder
+        // drains before the ring wraps instead of only after the step of the executor
+        std::function<void()> on_backlog;
+
+        // Events lost to a full queue, written by the producer and reported by the recorder
+        std::atomic<uint64_t> dropped_events{0};
+
+        // Only areas on the recording grid are flagged, 0 flags every area
+        uint64_t recording_interval = 0;
+        bool recording_interpolate = false;
+
         std::size_t areas = 0;
         std::string name;
         bool allocated = false;
 
         SignalStorage(std::size_t areas, std::string name);
 
-        size_t add(std::string name, types::DataType type, size_t max_interpolation_order);
+        size_t add(std::string name, types::DataType type, size_t max_interpolation_order, size_t count = 1);
 
         void allocate();
 
@@ -70,16 +103,52 @@ namespace ssp4sim::signal
 
         bool find_latest_valid_area(uint64_t time, size_t &found_index);
 
+        // Areas to interpolate between for time, see RingBuffer::find_bracketing_indices
+        bool find_interpolation_areas(uint64_t time, size_t &before, size_t &after);
+
         std::uint64_t get_time(std::size_t area);
 
         std::byte *get_item(std::size_t area, std::size_t index) noexcept;
 
         std::byte *get_derivative(std::size_t area, std::size_t index, std::size_t order) noexcept;
 
+        /**
+         * Hand the area to the recorder if it is on the recording grid. An area past a grid point
+         * that was stepped over is recorded at its own time, or with interpolation as the values
+         * at the grid point between the previous area and this one. An area rewritten at the same
+         * time, by loop iterations or a repeated step, is handed over again
+         */
         void flag_new_data(std::size_t area);
 
+        // Consumer side of flag_new_data, the flag is cleared before the event is returned
+        bool take_new_data(DataEvent &event);
+
+        void set_recording_grid(uint64_t interval, bool interpolate);
+
+        // True when every variable has the same value in both areas, derivatives are not compared
+        bool equal_values(std::size_t a, std::size_t b);
+
+        // Copy the values of every variable, the derivatives of the target are cleared
+        void copy_values(std::size_t from, std::size_t to);
+
         std::string to_string() const override;
 
         std::string export_area(int area);
+
+    private:
+        // Producer side state of the recording grid
+        uint64_t next_recording_time = 0;
+        uint64_t last_time = 0;
+        std::size_t last_area = 0;
+        bool has_last = false;
+
+        // Event of the last flagged area, if it was on the grid
+        DataEvent last_event;
+        bool last_queued = false;
+
+        // Area time of the latest event of each area
+        std::vector<uint64_t> queued_times;
+
+        void queue_new_data(std::size_t area, std::size_t previous, uint64_t time);
     };
 }
@@ -11,18 +11,27 @@
 #include "config.hpp"
 
 #include "handler/fmu_handler.hpp"
+#include "handler/fmu_log_sink.hpp"
 
 #include "execution/invocable.hpp"
+#include "execution/parareal.hpp"
 #include "graph/graph.hpp"
+#include "model/model_fmu.hpp"
+#include "model/model_me_group.hpp"
 
 #include "cutecpp/log.hpp"
 
 #include "ssp4cpp/fmu.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <map>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace ssp4sim
 {
@@ -38,8 +47,106 @@ namespace ssp4sim
         std::unique_ptr<graph::Graph> sim_graph;
 
         std::map<std::string, std::unique_ptr<graph::Invocable>> nodes;
+
+        // An independent copy of the system, used by parareal to solve windows in parallel
+        struct Replica
+        {
+            std::unique_ptr<handler::FmuHandler> fmu_handler;
+            std::unique_ptr<signal::DataRecorder> recorder = nullptr;
+            std::unique_ptr<graph::Graph> sim_graph;
+            std::map<std::string, std::unique_ptr<graph::Invocable>> nodes;
+        };
+
+        std::string result_file;
+
+        bool parareal = false;
+        std::size_t nr_replicas = 1;
+        // Replicas besides the main system
+        std::vector<Replica> replicas;
+
+        std::unique_ptr<graph::Graph> build_graph(handler::FmuHandler *handler,
+                                                  signal::DataRecorder *recorder,
+                                                  std::map<std::string, std::unique_ptr<graph::Invocable>> &graph_nodes);
+
+        void simulate_parareal(uint64_t start_time, uint64_t end_time, uint64_t timestep);
     };
 
+    namespace
+    {
+        /**
+         * The model exchange groups of a parareal system, their continuous states are corrected
+         * arithmetically. Empty if any other node is part of the system, such a system is
+         * propagated through snapshots of its fmus instead
+         */
+        std::vector<graph::ModelExchangeGroup *> model_exchange_groups(graph::Graph *graph)
+        {
+            std::vector<graph::ModelExchangeGroup *> groups;
+            for (auto node : graph->nodes)
+            {
+                auto group = dynamic_cast<graph::ModelExchangeGroup *>(node);
+                if (group == nullptr)
+                {
+                    return {};
+                }
+                groups.push_back(group);
+            }
+            return groups;
+        }
+
+        std::string part_file(const std::string &result_file, std::size_t replica)
+        {
+            return result_file + ".part" + std::to_string(replica);
+        }
+
+        // Merge the time sorted part files into one result file, the header is taken from the first part
+        void merge_parts(const std::string &result_file, std::size_t parts)
+        {
+            std::vector<std::ifstream> inputs;
+            std::vector<std::string> lines(parts);
+            std::vector<bool> valid(parts, false);
+
+            std::ofstream output(result_file, std::ios::out);
+            for (std::size_t i = 0; i < parts; i++)
+            {
+                inputs.emplace_back(part_file(result_file, i));
+                std::string header;
+                std::getline(inputs[i], header);
+                if (i == 0)
+                {
+                    output << header << '\n';
+                }
+                valid[i] = static_cast<bool>(std::getline(inputs[i], lines[i]));
+            }
+
+            auto time_of = [](const std::string &line)
+            { return std::stod(line.substr(0, line.find(','))); };
+
+            while (true)
+            {
+                std::size_t next = parts;
+                for (std::size_t i = 0; i < parts; i++)
+                {
+                    if (valid[i] && (next == parts || time_of(lines[i]) < time_of(lines[next])))
+                    {
+                        next = i;
+                    }
+                }
+                if (next == parts)
+                {
+                    break;
+                }
+                output << lines[next] << '\n';
+                valid[next] = static_cast<bool>(std::getline(inputs[next], lines[next]));
+            }
+
+            inputs.clear();
+            for (std::size_t i = 0; i < parts; i++)
+            {
+                std::filesystem::remove(part_file(result_file, i));
+            }
+        }
+    }
+
     Simulation::Simulation(ssp4cpp::Ssp *ssp) : p(std::make_unique<SimulationPrivate>())
     {
         p->ssp = ssp;
@@ -48,17 +155,43 @@ namespace ssp4sim
         p->fmu_handler = std::make_unique<handler::FmuHandler>(p->ssp);
 
         auto enable_recording = utils::Config::getOr("simulation.recording.enable", true);
-        auto result_file = utils::Config::getOr("simulation.recording.result_file", std::string("./result/data.scv"));
+        p->result_file = utils::Config::getOr("simulation.recording.result_file", std::string("./result/data.scv"));
         auto recording_interval = utils::time::s_to_ns(utils::Config::getOr("simulation.recording.interval", 1.0));
         auto wait_for_recorder = utils::Config::getOr("simulation.recording.wait_for", false);
+        auto interpolate_recording = utils::Config::getOr("simulation.recording.interpolate", false);
+
+        p->parareal = utils::Config::getOr("simulation.parareal.enable", false);
+        if (p->parareal)
+        {
+            p->nr_replicas = static_cast<std::size_t>(std::max(1, utils::Config::getOr("simulation.parareal.replicas", 4)));
+        }
 
         if (enable_recording)
         {
-            p->recorder = std::make_unique<signal::DataRecorder>(result_file, recording_interval, wait_for_recorder);
+            // Parareal records each replica to a part file, merged once the simulation is done
+            auto file = p->parareal ? part_file(p->result_file, 0) : p->result_file;
+            p->recorder = std::make_unique<signal::DataRecorder>(file, recording_interval, wait_for_recorder);
+            p->recorder->interpolate = interpolate_recording;
+
+            for (std::size_t r = 1; r < p->nr_replicas; r++)
+            {
+                auto &replica = p->replicas.emplace_back();
+                replica.recorder = std::make_unique<signal::DataRecorder>(part_file(p->result_file, r), recording_interval, wait_for_recorder);
+                replica.recorder->interpolate = interpolate_recording;
+            }
+        }
+        else
+        {
+            p->replicas.resize(p->nr_replicas - 1);
         }
     }
 
-    Simulation::~Simulation() = default;
+    Simulation::~Simulation()
+    {
+        // Models may log while terminating, stop the log thread once they are gone
+        p.reset();
+        handler::FmuLogSink::instance().shutdown();
+    }
 
     /**
      * @brief Initializes the simulation.
@@ -71,26 +204,175 @@ namespace ssp4sim
         p->log(info)("[{}] - Initializing fmus", __func__);
         p->fmu_handler->init();
 
-        p->log(info)("[{}] - Creating analysis graph", __func__);
-        auto analysis_graph = analysis::graph::AnalysisGraphBuilder(p->ssp, p->fmu_handler.get()).build();
-        p->log(debug)(" -- {}", analysis_graph->to_string());
+        p->sim_graph = p->build_graph(p->fmu_handler.get(), p->recorder.get(), p->nodes);
+
+        // Checked before the replicas are instantiated
+        std::vector<std::byte> snapshot;
+        if (p->parareal && model_exchange_groups(p->sim_graph.get()).empty() && !p->sim_graph->save_snapshot(snapshot))
+        {
+            throw std::runtime_error("[Parareal] The system needs model exchange fmus or co-simulation fmus that can serialize their state (canSerializeFMUstate). Disable simulation.parareal.enable");
+        }
+
+        for (auto &replica : p->replicas)
+        {
+            p->log(info)("[{}] - Initializing replica", __func__);
+            replica.fmu_handler = std::make_unique<handler::FmuHandler>(p->ssp);
+            replica.fmu_handler->init();
+            replica.sim_graph = p->build_graph(replica.fmu_handler.get(), replica.recorder.get(), replica.nodes);
+        }
+    }
 
-        p->log(info)("[{}] - Creating simulation graph", __func__);
-        auto graph_builder = graph::GraphBuilder(analysis_graph.get(), p->recorder.get());
+    std::unique_ptr<graph::Graph> SimulationPrivate::build_graph(handler::FmuHandler *handler,
+                                                                 signal::DataRecorder *recorder,
+                                                                 std::map<std::string, std::unique_ptr<graph::Invocable>> &graph_nodes)
+    {
+        log(info)("[{}] - Creating analysis graph", __func__);
+        auto analysis_graph = analysis::graph::AnalysisGraphBuilder(ssp, handler).build();
+        log(debug)(" -- {}", analysis_graph->to_string());
+
+        log(info)("[{}] - Creating simulation graph", __func__);
+        auto graph_builder = graph::GraphBuilder(analysis_graph.get(), recorder);
         graph_builder.build();
 
-        p->sim_graph = graph_builder.get_graph();
-        p->log(debug)(" -- {}", p->sim_graph->to_string());
+        auto sim_graph = graph_builder.get_graph();
+        log(debug)(" -- {}", sim_graph->to_string());
 
-        p->nodes = graph_builder.get_models(); // transfer ownership of nodes to simulation
+        graph_nodes = graph_builder.get_models(); // transfer ownership of nodes to simulation
 
-        p->log(info)("[{}] - Init simulation graph", __func__);
-        p->sim_graph->init();
+        log(info)("[{}] - Init simulation graph", __func__);
+        sim_graph->init();
 
-        if (p->recorder)
+        if (recorder)
         {
-            p->log(info)("[{}] - Initializing recorder", __func__);
-            p->recorder->init();
+            log(info)("[{}] - Initializing recorder", __func__);
+            recorder->init();
+        }
+        return sim_graph;
+    }
+
+    /**
+     * @brief Parareal over the states of the system
+     *
+     * Every replica is a full copy of the system. The coarse propagator steps replica 0 with
+     * "simulation.parareal.coarse_step" as macro step, the fine propagator steps with the
+     * configured timestep on the replica assigned to the window. Once the window boundaries
+     * have converged all windows are solved again, in parallel, with the recorders running and
+     * the part files are merged into the result file.
+     *
+     * Systems of model exchange fmus correct the continuous states of their groups, the coarse
+     * step is also used as solver step. Other systems move serialized fmu states between the
+     * replicas and use replacement correction, see Parareal, converging on the coupling values
+     * at the window boundaries.
+     */
+    void SimulationPrivate::simulate_parareal(uint64_t start_time, uint64_t end_time, uint64_t timestep)
+    {
+        std::vector<graph::Graph *> graphs{sim_graph.get()};
+        std::vector<signal::DataRecorder *> recorders{recorder.get()};
+        for (auto &replica : replicas)
+        {
+            graphs.push_back(replica.sim_graph.get());
+            recorders.push_back(replica.recorder.get());
+        }
+
+        std::vector<std::vector<graph::ModelExchangeGroup *>> groups;
+        for (auto graph : graphs)
+        {
+            groups.push_back(model_exchange_groups(graph));
+        }
+
+        auto fine_solver_step = groups[0].empty() ? timestep : groups[0].front()->solver_step;
+        auto coarse_step = utils::time::s_to_ns(utils::Config::getOr("simulation.parareal.coarse_step", utils::time::ns_to_s(timestep * 10)));
+
+        auto propagate = [&](std::size_t r, graph::Parareal::State &state, uint64_t start, uint64_t end, uint64_t step, uint64_t solver_step)
+        {
+            std::size_t offset = 0;
+            for (auto group : groups[r])
+            {
+                group->solver_step = solver_step;
+                group->load_state(start, state.values.data() + offset);
+                offset += group->states.size();
+            }
+
+            for (auto t = start; t < end; t += step)
+            {
+                auto h = std::min(step, end - t);
+                graphs[r]->executor->invoke(graph::StepData(t, t + h, h));
+            }
+
+            offset = 0;
+            for (auto group : groups[r])
+            {
+                std::copy(group->states.begin(), group->states.end(), state.values.begin() + offset);
+                offset += group->states.size();
+            }
+        };
+
+        graph::Parareal::Propagator coarse = [&](std::size_t r, graph::Parareal::State &state, uint64_t start, uint64_t end)
+        { propagate(r, state, start, end, coarse_step, std::max(coarse_step, fine_solver_step)); };
+        graph::Parareal::Propagator fine = [&](std::size_t r, graph::Parareal::State &state, uint64_t start, uint64_t end)
+        { propagate(r, state, start, end, timestep, fine_solver_step); };
+
+        graph::Parareal::State initial;
+        auto snapshots = groups[0].empty();
+        if (snapshots)
+        {
+            coarse = graph::Parareal::snapshot_propagator(graphs, coarse_step);
+            fine = graph::Parareal::snapshot_propagator(graphs, timestep);
+            if (!sim_graph->save_snapshot(initial.snapshot))
+            {
+                throw std::runtime_error("[Parareal] Failed to save the initial state of the system");
+            }
+        }
+        else
+        {
+            for (auto group : groups[0])
+            {
+                initial.values.insert(initial.values.end(), group->states.begin(), group->states.end());
+            }
+        }
+
+        graph::Parareal parareal(graphs.size(), coarse, fine);
+        parareal.correction = snapshots ? graph::Parareal::Correction::replacement : graph::Parareal::Correction::arithmetic;
+        parareal.max_iterations = utils::Config::getOr("simulation.parareal.max_iterations", 5);
+        parareal.tolerance = utils::Config::getOr("simulation.parareal.tolerance", utils::Config::getOr("simulation.tolerance", 1e-6));
+
+        // Windows on the timestep grid so the fine solves take the same steps as a serial run
+        auto windows = static_cast<std::size_t>(std::max(1, utils::Config::getOr("simulation.parareal.windows", static_cast<int>(graphs.size()))));
+        auto steps = (end_time - start_time + timestep - 1) / timestep;
+        auto boundaries = graph::Parareal::split(0, steps, std::min<std::size_t>(windows, steps));
+        for (auto &b : boundaries)
+        {
+            b = std::min(start_time + b * timestep, end_time);
+        }
+
+        if (!parareal.run(initial, boundaries))
+        {
+            log(warning)("[{}] Parareal did not converge in {} iterations", __func__, parareal.iterations);
+        }
+
+        // Output pass on the converged boundaries
+        for (auto r : recorders)
+        {
+            if (r)
+            {
+                r->discard_new_data();
+                r->start_recording();
+            }
+        }
+
+        parareal.fine_pass();
+
+        for (auto r : recorders)
+        {
+            if (r)
+            {
+                r->stop_recording();
+            }
+        }
+
+        if (recorder)
+        {
+            merge_parts(result_file, recorders.size());
         }
     }
 
@@ -103,7 +385,7 @@ namespace ssp4sim
      */
     void Simulation::simulate()
     {
-        if (p->recorder)
+        if (p->recorder && !p->parareal)
         {
             p->recorder->start_recording();
         }
@@ -118,7 +400,14 @@ namespace ssp4sim
 
         try
         {
-            p->sim_graph->invoke(ssp4sim::graph::StepData(start_time, end_time, timestep));
+            if (p->parareal)
+            {
+                p->simulate_parareal(start_time, end_time, timestep);
+            }
+            else
+            {
+                p->sim_graph->invoke(ssp4sim::graph::StepData(start_time, end_time, timestep));
+            }
         }
         catch (const std::runtime_error &e)
         {
@@ -129,10 +418,11 @@ namespace ssp4sim
 
         p->log(info)("[{}] Total walltime: {} ", __func__, utils::time::ns_to_s(sim_wall_time));
 
-        if (p->recorder)
+        if (p->recorder && !p->parareal)
         {
             p->recorder->stop_recording();
         }
+        handler::FmuLogSink::instance().flush();
 
         p->log(info)("[{}] Simulation completed\n", __func__);
 
@@ -142,7 +432,16 @@ namespace ssp4sim
             auto model_walltime = node->walltime_ns;
             p->log(info)("[{}] Model {} walltime: {}", __func__, node->name, utils::time::ns_to_s(model_walltime));
             total_model_time += model_walltime;
+
+            auto model = dynamic_cast<graph::FmuModel *>(node);
+            if (model != nullptr && model->activity.enabled)
+            {
+                p->log(info)("[{}] Model {} skipped {} of {} steps, skip ratio {}", __func__, node->name, model->activity.skipped,
+                             model->activity.skipped + model->activity.stepped, model->activity.skip_ratio());
+            }
         }
         p->log(info)("[{}] Model walltime: {}", __func__, utils::time::ns_to_s(total_model_time));
+
+        p->sim_graph->executor->log_metrics();
     }
 }
@@ -0,0 +1,216 @@
+#include "solver/ode_solver.hpp"
+
+#include "utils/linalg.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace ssp4sim::solver
+{
+    OdeSolver::OdeSolver(std::size_t size, OdeFunction f) : size(size), f(std::move(f))
+    {
+    }
+
+    void OdeSolver::eval(double t, const double *x, double *dx)
+    {
+        evaluations += 1;
+        f(t, x, dx);
+    }
+
+    // RungeKutta4 ----------------------------
+
+    RungeKutta4::RungeKutta4(std::size_t size, OdeFunction f)
+        : OdeSolver(size, std::move(f)), k1(size), k2(size), k3(size), k4(size), tmp(size)
+    {
+    }
+
+    void RungeKutta4::step(double t, double h, std::vector<double> &x)
+    {
+        auto half = h / 2;
+
+        eval(t, x.data(), k1.data());
+        for (std::size_t i = 0; i < size; i++)
+            tmp[i] = x[i] + half * k1[i];
+
+        eval(t + half, tmp.data(), k2.data());
+        for (std::size_t i = 0; i < size; i++)
+            tmp[i] = x[i] + half * k2[i];
+
+        eval(t + half, tmp.data(), k3.data());
+        for (std::size_t i = 0; i < size; i++)
+            tmp[i] = x[i] + h * k3[i];
+
+        eval(t + h, tmp.data(), k4.data());
+        for (std::size_t i = 0; i < size; i++)
+            x[i] += h / 6 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+    }
+
+    // Bdf ----------------------------
+
+    Bdf::Bdf(std::size_t size, OdeFunction f, int order, double tolerance, int max_iterations)
+        : OdeSolver(size, std::move(f)),
+          order(order),
+          tolerance(tolerance),
+          max_iterations(max_iterations),
+          x_prev(size), rhs(size), y(size), fy(size), fd(size), g(size),
+          jacobian(size * size), iteration(size * size), pivots(size)
+    {
+        if (order != 1 && order != 2)
+        {
+            throw std::invalid_argument(Logger::format("[{}] Unsupported BDF order {}", __func__, order));
+        }
+    }
+
+    void Bdf::reset()
+    {
+        has_history = false;
+        jacobian_valid = false;
+    }
+
+    void Bdf::update_jacobian(double t, const std::vector<double> &at)
+    {
+        jacobian_evaluations += 1;
+
+        y = at;
+        eval(t, y.data(), fy.data());
+
+        const double sqrt_eps = std::sqrt(std::numeric_limits<double>::epsilon());
+        for (std::size_t j = 0; j < size; j++)
+        {
+            auto original = y[j];
+            auto delta = sqrt_eps * std::max(std::abs(original), 1.0);
+            y[j] = original + delta;
+            eval(t, y.data(), fd.data());
+            y[j] = original;
+
+            for (std::size_t i = 0; i < size; i++)
+            {
+                jacobian[i * size + j] = (fd[i] - fy[i]) / delta;
+            }
+        }
+
+        jacobian_valid = true;
+        factorized_for = 0.0;
+    }
+
+    void Bdf::factorize(double beta_h)
+    {
+        for (std::size_t i = 0; i < size; i++)
+        {
+            for (std::size_t j = 0; j < size; j++)
+            {
+                iteration[i * size + j] = (i == j ? 1.0 : 0.0) - beta_h * jacobian[i * size + j];
+            }
+        }
+
+        if (!utils::linalg::lu_factor(iteration, pivots, size))
+        {
+            throw std::runtime_error(Logger::format("[{}] Singular newton iteration matrix", __func__));
+        }
+        factorized_for = beta_h;
+    }
+
+    // Solve y - rhs - beta_h * f(t, y) = 0, starting from the current y
+    bool Bdf::newton(double t, double beta_h)
+    {
+        for (int it = 0; it < max_iterations; it++)
+        {
+            eval(t, y.data(), fy.data());
+            for (std::size_t i = 0; i < size; i++)
+            {
+                g[i] = -(y[i] - rhs[i] - beta_h * fy[i]);
+            }
+
+            utils::linalg::lu_solve(iteration, pivots, size, g);
+
+            bool converged = true;
+            for (std::size_t i = 0; i < size; i++)
+            {
+                y[i] += g[i];
+                converged = converged && std::abs(g[i]) <= tolerance * (1.0 + std::abs(y[i]));
+            }
+
+            if (converged)
+            {
+                // Slow convergence, refresh the jacobian for the next step
+                if (it > max_iterations / 2)
+                {
+                    jacobian_valid = false;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Bdf::step(double t, double h, std::vector<double> &x)
+    {
+        // BDF2 coefficients assume a constant step, restart with BDF1 if the step changes
+        bool use_second_order = order == 2 && has_history && h == last_h;
+
+        double beta_h = h;
+        if (use_second_order)
+        {
+            beta_h = 2.0 / 3.0 * h;
+            for (std::size_t i = 0; i < size; i++)
+            {
+                rhs[i] = 4.0 / 3.0 * x[i] - 1.0 / 3.0 * x_prev[i];
+            }
+        }
+        else
+        {
+            rhs = x;
+        }
+
+        if (!jacobian_valid)
+        {
+            update_jacobian(t + h, x);
+        }
+        if (factorized_for != beta_h)
+        {
+            factorize(beta_h);
+        }
+
+        y = x;
+        if (!newton(t + h, beta_h))
+        {
+            // Retry once with a fresh jacobian at the original point
+            update_jacobian(t + h, x);
+            factorize(beta_h);
+            y = x;
+            if (!newton(t + h, beta_h))
+            {
+                throw std::runtime_error(Logger::format("[{}] Newton iteration did not converge at t {}, h {}", __func__, t, h));
+            }
+        }
+
+        x_prev = x;
+        x = y;
+        has_history = true;
+        last_h = h;
+    }
+
+    std::unique_ptr<OdeSolver> make_solver(const std::string &method,
+                                           std::size_t size,
+                                           OdeFunction f,
+                                           double tolerance,
+                                           int max_iterations)
+    {
+        if (method == "rk4")
+        {
+            return std::make_unique<RungeKutta4>(size, std::move(f));
+        }
+        else if (method == "bdf1")
+        {
+            return std::make_unique<Bdf>(size, std::move(f), 1, tolerance, max_iterations);
+        }
+        else if (method == "bdf2")
+        {
+            return std::make_unique<Bdf>(size, std::move(f), 2, tolerance, max_iterations);
+        }
+        throw std::invalid_argument(Logger::format("[{}] Unknown solver {}", __func__, method));
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ssp4sim::solver
+{
+
+    // dx = f(t, x), time in seconds
+    using OdeFunction = std::function<void(double t, const double *x, double *dx)>;
+
+    /**
+     * @brief Fixed step integrator over one contiguous state vector
+     * The state of all integrated models is stored back to back so that every
+     * vector operation runs over the combined state in one pass
+     */
+    class OdeSolver
+    {
+    public:
+        std::size_t size = 0;
+        OdeFunction f;
+
+        uint64_t evaluations = 0;
+
+        OdeSolver(std::size_t size, OdeFunction f);
+
+        virtual ~OdeSolver() = default;
+
+        // Advance x from t to t + h in place
+        virtual void step(double t, double h, std::vector<double> &x) = 0;
+
+        // Drop any history or cached jacobian, called after discontinuities
+        virtual void reset() {}
+
+        virtual std::string name() const = 0;
+
+    protected:
+        void eval(double t, const double *x, double *dx);
+    };
+
+    // Classic explicit 4th order Runge-Kutta
+    class RungeKutta4 final : public OdeSolver
+    {
+    public:
+        RungeKutta4(std::size_t size, OdeFunction f);
+
+        void step(double t, double h, std::vector<double> &x) override;
+
+        std::string name() const override { return "rk4"; }
+
+    private:
+        std::vector<double> k1, k2, k3, k4, tmp;
+    };
+
+    /**
+     * @brief Implicit BDF of order 1 (backward Euler) or 2
+     * The nonlinear system is solved with a modified Newton iteration, the jacobian
+     * is estimated with finite differences and reused between steps until
+     * convergence slows down or the step changes
+     */
+    class Bdf final : public OdeSolver
+    {
+    public:
+        Logger log = Logger("ssp4sim.solver.Bdf", LogLevel::info);
+
+        int order = 1;
+        double tolerance = 1e-8;
+        int max_iterations = 10;
+
+        uint64_t jacobian_evaluations = 0;
+
+        Bdf(std::size_t size, OdeFunction f, int order, double tolerance, int max_iterations);
+
+        void step(double t, double h, std::vector<double> &x) override;
+
+        void reset() override;
+
+        std::string name() const override { return order == 1 ? "bdf1" : "bdf2"; }
+
+    private:
+        std::vector<double> x_prev; // x_{n-1}, for order 2
+        std::vector<double> rhs;    // history part of the bdf formula
+        std::vector<double> y;      // newton iterate
+        std::vector<double> fy;
+        std::vector<double> fd;
+        std::vector<double> g;
+
+        std::vector<double> jacobian;  // df/dx, row major
+        std::vector<double> iteration; // I - beta h df/dx, lu factorized
+        std::vector<std::size_t> pivots;
+
+        bool has_history = false;
+        bool jacobian_valid = false;
+        double factorized_for = 0.0; // beta * h of the current factorization
+        double last_h = 0.0;
+
+        void update_jacobian(double t, const std::vector<double> &at);
+
+        void factorize(double beta_h);
+
+        bool newton(double t, double beta_h);
+    };
+
+    // "rk4", "bdf1" or "bdf2"
+    std::unique_ptr<OdeSolver> make_solver(const std::string &method,
+                                           std::size_t size,
+                                           OdeFunction f,
+                                           double tolerance = 1e-8,
+                                           int max_iterations = 10);
+}
@@ -0,0 +1,162 @@
+#include "utils/linalg.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ssp4sim::utils::linalg
+{
+
+    bool lu_factor(std::vector<double> &a, std::vector<std::size_t> &pivots, std::size_t n)
+    {
+        for (std::size_t k = 0; k < n; k++)
+        {
+            auto pivot = k;
+            auto max = std::abs(a[k * n + k]);
+            for (std::size_t i = k + 1; i < n; i++)
+            {
+                auto v = std::abs(a[i * n + k]);
+                if (v > max)
+                {
+                    max = v;
+                    pivot = i;
+                }
+            }
+
+            pivots[k] = pivot;
+            if (max == 0.0)
+            {
+                return false;
+            }
+
+            if (pivot != k)
+            {
+                std::swap_ranges(a.begin() + k * n, a.begin() + (k + 1) * n, a.begin() + pivot * n);
+            }
+
+            auto inv = 1.0 / a[k * n + k];
+            for (std::size_t i = k + 1; i < n; i++)
+            {
+                auto factor = a[i * n + k] * inv;
+                a[i * n + k] = factor;
+                for (std::size_t j = k + 1; j < n; j++)
+                {
+                    a[i * n + j] -= factor * a[k * n + j];
+                }
+            }
+        }
+        return true;
+    }
+
+    void lu_solve(const std::vector<double> &a, const std::vector<std::size_t> &pivots, std::size_t n, std::vector<double> &b)
+    {
+        // The factorization swaps complete rows, so all swaps apply before the forward substitution
+        for (std::size_t k = 0; k < n; k++)
+        {
+            std::swap(b[k], b[pivots[k]]);
+        }
+
+        for (std::size_t k = 0; k < n; k++)
+        {
+            for (std::size_t i = k + 1; i < n; i++)
+            {
+                b[i] -= a[i * n + k] * b[k];
+            }
+        }
+
+        for (std::size_t k = n; k-- > 0;)
+        {
+            for (std::size_t j = k + 1; j < n; j++)
+            {
+                b[k] -= a[k * n + j] * b[j];
+            }
+            b[k] /= a[k * n + k];
+        }
+    }
+
+    std::size_t least_squares(std::vector<double> &a, std::size_t m, std::size_t n,
+                              const std::vector<double> &b, std::vector<double> &x, double rcond)
+    {
+        // r is upper triangular n x n, row major, only the kept columns are filled
+        std::vector<double> r(n * n, 0.0);
+        std::vector<std::size_t> kept;
+        kept.reserve(n);
+
+        for (std::size_t j = 0; j < n; j++)
+        {
+            auto column = a.begin() + j * m;
+
+            double norm = 0.0;
+            for (std::size_t i = 0; i < m; i++)
+            {
+                norm += column[i] * column[i];
+            }
+            norm = std::sqrt(norm);
+
+            // Orthogonalize twice against the kept columns, once is not enough for nearly dependent columns
+            for (int pass = 0; pass < 2; pass++)
+            {
+                for (auto k : kept)
+                {
+                    auto q = a.begin() + k * m;
+                    double dot = 0.0;
+                    for (std::size_t i = 0; i < m; i++)
+                    {
+                        dot += q[i] * column[i];
+                    }
+                    for (std::size_t i = 0; i < m; i++)
+                    {
+                        column[i] -= dot * q[i];
+                    }
+                    r[k * n + j] += dot;
+                }
+            }
+
+            double remaining = 0.0;
+            for (std::size_t i = 0; i < m; i++)
+            {
+                remaining += column[i] * column[i];
+            }
+            remaining = std::sqrt(remaining);
+
+            if (remaining <= rcond * norm || remaining == 0.0)
+            {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < m; i++)
+            {
+                column[i] /= remaining;
+            }
+            r[j * n + j] = remaining;
+            kept.push_back(j);
+        }
+
+        // x = R^-1 Q^T b over the kept columns
+        x.assign(n, 0.0);
+        std::vector<double> qtb(n, 0.0);
+        for (auto k : kept)
+        {
+            auto q = a.begin() + k * m;
+            for (std::size_t i = 0; i < m; i++)
+            {
+                qtb[k] += q[i] * b[i];
+            }
+        }
+
+        for (auto it = kept.rbegin(); it != kept.rend(); ++it)
+        {
+            auto k = *it;
+            auto value = qtb[k];
+            for (auto j : kept)
+            {
+                if (j > k)
+                {
+                    value -= r[k * n + j] * x[j];
+                }
+            }
+            x[k] = value / r[k * n + k];
+        }
+        return kept.size();
+    }
+}
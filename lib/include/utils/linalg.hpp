@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ssp4sim::utils::linalg
+{
+    /**
+     * @brief In place LU factorization with partial pivoting of a row major n x n matrix
+     * Returns false if the matrix is singular
+     */
+    bool lu_factor(std::vector<double> &a, std::vector<std::size_t> &pivots, std::size_t n);
+
+    // Solve a x = b in place with a factorization from lu_factor
+    void lu_solve(const std::vector<double> &a, const std::vector<std::size_t> &pivots, std::size_t n, std::vector<double> &b);
+
+    /**
+     * @brief Least squares solution of min |a x - b| with a modified Gram-Schmidt QR
+     * a is column major m x n and is overwritten with Q, x gets n values.
+     * Columns that are linearly dependent on the previous ones, relative to rcond,
+     * are dropped and get x = 0. Returns the number of columns used
+     */
+    std::size_t least_squares(std::vector<double> &a, std::size_t m, std::size_t n,
+                              const std::vector<double> &b, std::vector<double> &x, double rcond = 1e-10);
+}
@@ -9,7 +9,7 @@ namespace ssp4sim::utils
 {
 
     void read_from_model_(types::DataType t,
-                          handler::CoSimulationModel &model,
+                          handler::FmiModel &model,
                           uint64_t value_reference,
                           void *out)
     {
@@ -55,7 +55,7 @@ namespace ssp4sim::utils
     }
 
     void write_to_model_(types::DataType t,
-                         handler::CoSimulationModel &model,
+                         handler::FmiModel &model,
                          uint64_t &value_reference,
                          void *data)
     {
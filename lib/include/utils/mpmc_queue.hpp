@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+namespace ssp4sim::utils
+{
+
+    /**
+     * @brief Bounded lock-free multi producer / multi consumer ring (Vyukov)
+     *
+     * Each slot carries a sequence number that tells producers and consumers whether
+     * the slot is free or published for the current lap. Slots are written in place,
+     * a full ring makes try_emplace fail instead of blocking or allocating.
+     * Capacity is rounded up to a power of two.
+     */
+    template <typename T>
+    class MpmcQueue
+    {
+        struct Slot
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        static constexpr std::size_t cache_line = 64;
+
+        std::unique_ptr<Slot[]> slots;
+        std::size_t mask = 0;
+
+        alignas(cache_line) std::atomic<std::size_t> enqueue_pos{0};
+        alignas(cache_line) std::atomic<std::size_t> dequeue_pos{0};
+
+    public:
+        explicit MpmcQueue(std::size_t capacity)
+        {
+            if (capacity < 2)
+            {
+                throw std::runtime_error("[MpmcQueue] capacity must be at least 2");
+            }
+
+            std::size_t size = 1;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+
+            slots = std::make_unique<Slot[]>(size);
+            mask = size - 1;
+            for (std::size_t i = 0; i < size; i++)
+            {
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpmcQueue(const MpmcQueue &) = delete;
+        MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+        std::size_t capacity() const
+        {
+            return mask + 1;
+        }
+
+        // Claim a slot and let fill write the value in place, false if the ring is full
+        template <typename F>
+        bool try_emplace(F &&fill)
+        {
+            Slot *slot;
+            auto pos = enqueue_pos.load(std::memory_order_relaxed);
+            while (true)
+            {
+                slot = &slots[pos & mask];
+                auto seq = slot->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0)
+                {
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            fill(slot->value);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(const T &value)
+        {
+            return try_emplace([&](T &slot)
+                               { slot = value; });
+        }
+
+        // Let consume read the oldest value in place, false if the ring is empty
+        template <typename F>
+        bool try_consume(F &&consume)
+        {
+            Slot *slot;
+            auto pos = dequeue_pos.load(std::memory_order_relaxed);
+            while (true)
+            {
+                slot = &slots[pos & mask];
+                auto seq = slot->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            consume(slot->value);
+            slot->sequence.store(pos + mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(T &out)
+        {
+            return try_consume([&](T &slot)
+                               { out = slot; });
+        }
+    };
+}
@@ -108,6 +108,25 @@ namespace ssp4sim::utils
         return false;
     }
 
+    bool RingBuffer::find_bracketing_indices(uint64_t time, std::size_t &before, std::size_t &after)
+    {
+        for (std::size_t i = 0; i < nr_inserts && i < capacity; ++i)
+        {
+            auto pos = get_index_from_pos_rev(i);
+            if (timestamps[pos] <= time)
+            {
+                if (i == 0 || timestamps[pos] == time)
+                {
+                    return false;
+                }
+                before = pos;
+                after = get_index_from_pos_rev(i - 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
     std::size_t RingBuffer::get_index_from_pos_rev(std::size_t position)
     {
         return (nr_inserts - position) % capacity;
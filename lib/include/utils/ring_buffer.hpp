@@ -56,6 +56,9 @@ namespace ssp4sim::utils
 
         bool find_latest_valid_index(uint64_t time, std::size_t &index_found);
 
+        // Indices of the samples around time, before <= time < after. False if time is stored exactly or has no later sample
+        bool find_bracketing_indices(uint64_t time, std::size_t &before, std::size_t &after);
+
         /*
         Return element at logical position `index` counting backwards from
         the head: index 0 == head, 1 == just before head, 2 == next-newest, …
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace ssp4sim::utils
+{
+
+    // Hint to the cpu that the thread is spinning
+    inline void cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    struct SpinPolicy
+    {
+        // Iterations with cpu_relax before yielding
+        uint32_t spins = 4000;
+        // Yields before parking on atomic::wait
+        uint32_t yields = 16;
+    };
+
+    /**
+     * @brief Wait until value != old, spinning first, then yielding and finally parking
+     * Short waits stay on the cpu, long waits release it. Wakers must call notify_all on value
+     */
+    template <typename T>
+    T spin_wait(const std::atomic<T> &value, T old, SpinPolicy policy = {}) noexcept
+    {
+        for (uint32_t i = 0; i < policy.spins; i++)
+        {
+            auto current = value.load(std::memory_order_acquire);
+            if (current != old)
+            {
+                return current;
+            }
+            cpu_relax();
+        }
+
+        for (uint32_t i = 0; i < policy.yields; i++)
+        {
+            auto current = value.load(std::memory_order_acquire);
+            if (current != old)
+            {
+                return current;
+            }
+            std::this_thread::yield();
+        }
+
+        auto current = value.load(std::memory_order_acquire);
+        while (current == old)
+        {
+            value.wait(old, std::memory_order_acquire);
+            current = value.load(std::memory_order_acquire);
+        }
+        return current;
+    }
+
+    /**
+     * @brief Reusable barrier for a fixed number of participants
+     * Arrivals spin, yield and then park on the phase counter. The last arrival
+     * opens the next phase and only notifies when a participant has parked.
+     */
+    class SpinBarrier
+    {
+        static constexpr std::size_t cache_line = 64;
+
+        std::size_t participants;
+        SpinPolicy policy;
+
+        alignas(cache_line) std::atomic<std::size_t> arrived{0};
+        alignas(cache_line) std::atomic<uint64_t> phase{0};
+        std::atomic<uint32_t> parked{0};
+
+    public:
+        explicit SpinBarrier(std::size_t participants, SpinPolicy policy = {})
+            : participants(participants), policy(policy)
+        {
+        }
+
+        SpinBarrier(const SpinBarrier &) = delete;
+        SpinBarrier &operator=(const SpinBarrier &) = delete;
+
+        // Blocks until all participants have arrived, returns true for the last one
+        bool arrive_and_wait() noexcept
+        {
+            auto current = phase.load(std::memory_order_acquire);
+            if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == participants)
+            {
+                arrived.store(0, std::memory_order_relaxed);
+                // seq_cst pairs with the parking side, either it sees the new phase or we see it parked
+                phase.fetch_add(1);
+                if (parked.load() != 0)
+                {
+                    phase.notify_all();
+                }
+                return true;
+            }
+
+            for (uint32_t i = 0; i < policy.spins; i++)
+            {
+                if (phase.load(std::memory_order_acquire) != current)
+                {
+                    return false;
+                }
+                cpu_relax();
+            }
+            for (uint32_t i = 0; i < policy.yields; i++)
+            {
+                if (phase.load(std::memory_order_acquire) != current)
+                {
+                    return false;
+                }
+                std::this_thread::yield();
+            }
+
+            parked.fetch_add(1);
+            while (phase.load() == current)
+            {
+                phase.wait(current);
+            }
+            parked.fetch_sub(1, std::memory_order_acq_rel);
+            return false;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return participants;
+        }
+    };
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+namespace ssp4sim::utils
+{
+
+    /**
+     * @brief Bounded lock-free single producer / single consumer ring
+     *
+     * The producer only writes the tail and the consumer only writes the head, each keeps
+     * a cached copy of the other index so the shared cache line is only read when the
+     * ring looks full or empty. A full ring makes try_push fail instead of blocking.
+     * Capacity is rounded up to a power of two.
+     */
+    template <typename T>
+    class SpscQueue
+    {
+        static constexpr std::size_t cache_line = 64;
+
+        std::unique_ptr<T[]> slots;
+        std::size_t mask = 0;
+
+        alignas(cache_line) std::atomic<std::size_t> tail{0};
+        std::size_t cached_head = 0; // producer only
+
+        alignas(cache_line) std::atomic<std::size_t> head{0};
+        std::size_t cached_tail = 0; // consumer only
+
+    public:
+        explicit SpscQueue(std::size_t capacity)
+        {
+            if (capacity < 1)
+            {
+                throw std::runtime_error("[SpscQueue] capacity must be at least 1");
+            }
+
+            std::size_t size = 1;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+
+            slots = std::make_unique<T[]>(size);
+            mask = size - 1;
+        }
+
+        SpscQueue(const SpscQueue &) = delete;
+        SpscQueue &operator=(const SpscQueue &) = delete;
+
+        std::size_t capacity() const
+        {
+            return mask + 1;
+        }
+
+        // Producer only, false if the ring is full
+        bool try_push(const T &value)
+        {
+            auto t = tail.load(std::memory_order_relaxed);
+            if (t - cached_head > mask)
+            {
+                cached_head = head.load(std::memory_order_acquire);
+                if (t - cached_head > mask)
+                {
+                    return false;
+                }
+            }
+
+            slots[t & mask] = value;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only, false if the ring is empty
+        bool try_pop(T &out)
+        {
+            auto h = head.load(std::memory_order_relaxed);
+            if (h == cached_tail)
+            {
+                cached_tail = tail.load(std::memory_order_acquire);
+                if (h == cached_tail)
+                {
+                    return false;
+                }
+            }
+
+            out = slots[h & mask];
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Either side, a snapshot that may be outdated as soon as it is returned
+        bool empty() const
+        {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+
+        // Either side, a snapshot that may be outdated as soon as it is returned
+        std::size_t size() const
+        {
+            auto h = head.load(std::memory_order_acquire);
+            return tail.load(std::memory_order_acquire) - h;
+        }
+    };
+}
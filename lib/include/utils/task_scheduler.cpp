@@ -0,0 +1,338 @@
+#include "utils/task_scheduler.hpp"
+
+#include "config.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace ssp4sim::utils
+{
+    namespace
+    {
+        constexpr std::size_t deque_capacity = 1024;
+        constexpr std::size_t injection_capacity = 4096;
+
+        // Scheduler and worker of the calling thread
+        thread_local const void *tls_scheduler = nullptr;
+        thread_local void *tls_worker = nullptr;
+    }
+
+    WorkStealingDeque::WorkStealingDeque(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        slots = std::make_unique<Slot[]>(size);
+        mask = static_cast<int64_t>(size - 1);
+    }
+
+    void WorkStealingDeque::store(int64_t pos, const Task &task) noexcept
+    {
+        auto &slot = slots[pos & mask];
+        slot.fn.store(task.fn, std::memory_order_relaxed);
+        slot.context.store(task.context, std::memory_order_relaxed);
+        slot.index.store(task.index, std::memory_order_relaxed);
+        slot.group.store(task.group, std::memory_order_relaxed);
+    }
+
+    Task WorkStealingDeque::load(int64_t pos) const noexcept
+    {
+        auto &slot = slots[pos & mask];
+        return Task{slot.fn.load(std::memory_order_relaxed),
+                    slot.context.load(std::memory_order_relaxed),
+                    slot.index.load(std::memory_order_relaxed),
+                    slot.group.load(std::memory_order_relaxed)};
+    }
+
+    bool WorkStealingDeque::push(const Task &task) noexcept
+    {
+        auto b = bottom.load(std::memory_order_relaxed);
+        auto t = top.load(std::memory_order_acquire);
+        if (b - t > mask)
+        {
+            return false;
+        }
+
+        store(b, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool WorkStealingDeque::pop(Task &task) noexcept
+    {
+        auto b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        task = load(b);
+        if (t == b)
+        {
+            // Last task, race the thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    bool WorkStealingDeque::steal(Task &task) noexcept
+    {
+        auto t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+        {
+            return false;
+        }
+
+        auto stolen = load(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return false;
+        }
+        task = stolen;
+        return true;
+    }
+
+    bool WorkStealingDeque::empty() const noexcept
+    {
+        return top.load(std::memory_order_acquire) >= bottom.load(std::memory_order_acquire);
+    }
+
+    TaskScheduler::TaskScheduler(std::size_t threads, SpinPolicy policy)
+        : policy(policy), injection(injection_capacity)
+    {
+        threads = std::max<std::size_t>(threads, 1);
+
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; i++)
+        {
+            workers.push_back(std::make_unique<Worker>(i, deque_capacity));
+        }
+
+        this->threads.reserve(threads);
+        for (std::size_t i = 0; i < threads; i++)
+        {
+            this->threads.emplace_back([this, i]()
+                                       { worker_thread(i); });
+        }
+
+        log(debug)("[{}] Started {} workers", __func__, threads);
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        terminate.store(true, std::memory_order_release);
+        epoch.fetch_add(1);
+        epoch.notify_all();
+
+        for (auto &thread : threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+    }
+
+    TaskScheduler &TaskScheduler::instance()
+    {
+        static TaskScheduler scheduler([]()
+                                       {
+            auto threads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+            // Without a loaded configuration the default is used
+            if (!Config::data_.is_null())
+            {
+                threads = Config::getOr("simulation.scheduler.threads", threads);
+            }
+            return static_cast<std::size_t>(std::max(1, threads)); }());
+        return scheduler;
+    }
+
+    TaskScheduler::Worker *TaskScheduler::current_worker() const noexcept
+    {
+        return tls_scheduler == this ? static_cast<Worker *>(tls_worker) : nullptr;
+    }
+
+    void TaskScheduler::wake() noexcept
+    {
+        // seq_cst pairs with the parking side, either it sees the new epoch or we see it asleep
+        epoch.fetch_add(1);
+        if (sleepers.load() != 0)
+        {
+            epoch.notify_all();
+        }
+    }
+
+    void TaskScheduler::spawn(TaskGroup &group, void (*fn)(void *, std::size_t), void *context, std::size_t index)
+    {
+        Task task{fn, context, index, &group};
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+
+        bool queued = false;
+        if (auto self = current_worker())
+        {
+            queued = self->deque.push(task);
+        }
+        else
+        {
+            queued = injection.try_push(task);
+        }
+
+        if (!queued)
+        {
+            // Queues are full, the spawner runs the task itself
+            execute(task, true);
+            return;
+        }
+
+        wake();
+    }
+
+    bool TaskScheduler::find(Worker *self, std::size_t start, Task &task) noexcept
+    {
+        if (self != nullptr && self->deque.pop(task))
+        {
+            return true;
+        }
+
+        if (injection.try_pop(task))
+        {
+            return true;
+        }
+
+        for (std::size_t i = 0; i < workers.size(); i++)
+        {
+            auto victim = workers[(start + i) % workers.size()].get();
+            if (victim != self && victim->deque.steal(task))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void TaskScheduler::execute(const Task &task, bool counted) noexcept
+    {
+        auto group = task.group;
+        try
+        {
+            task.fn(task.context, task.index);
+        }
+        catch (...)
+        {
+            std::scoped_lock lock(group->exception_mutex);
+            if (!group->exception)
+            {
+                group->exception = std::current_exception();
+            }
+        }
+
+        if (counted && group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            group->pending.notify_all();
+        }
+    }
+
+    void TaskScheduler::wait(TaskGroup &group)
+    {
+        auto self = current_worker();
+        std::size_t start = self != nullptr ? self->index + 1 : 0;
+        uint32_t idle = 0;
+
+        for (auto left = group.pending.load(std::memory_order_acquire); left != 0; left = group.pending.load(std::memory_order_acquire))
+        {
+            Task task;
+            if (find(self, start, task))
+            {
+                execute(task, true);
+                idle = 0;
+                continue;
+            }
+
+            if (idle < policy.spins)
+            {
+                cpu_relax();
+                idle += 1;
+            }
+            else if (self != nullptr)
+            {
+                // A waiting worker must keep looking, it may be the only one awake for new tasks
+                std::this_thread::yield();
+            }
+            else
+            {
+                // Other threads leave new tasks to the workers and park until the group changes
+                group.pending.wait(left, std::memory_order_acquire);
+            }
+        }
+
+        if (group.exception)
+        {
+            auto e = group.exception;
+            group.exception = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    void TaskScheduler::worker_thread(std::size_t index)
+    {
+        auto self = workers[index].get();
+        tls_scheduler = this;
+        tls_worker = self;
+
+        while (!terminate.load(std::memory_order_acquire))
+        {
+            Task task;
+            if (find(self, index + 1, task))
+            {
+                execute(task, true);
+                continue;
+            }
+
+            auto seen = epoch.load();
+            bool found = false;
+            for (uint32_t i = 0; i < policy.spins + policy.yields && !found; i++)
+            {
+                found = find(self, index + 1, task);
+                if (!found)
+                {
+                    i < policy.spins ? cpu_relax() : std::this_thread::yield();
+                }
+            }
+
+            if (!found)
+            {
+                sleepers.fetch_add(1);
+                // Re-check after announcing, a spawn in between is seen here or wakes us
+                found = find(self, index + 1, task);
+                if (!found && !terminate.load())
+                {
+                    epoch.wait(seen);
+                }
+                sleepers.fetch_sub(1);
+            }
+
+            if (found)
+            {
+                execute(task, true);
+            }
+        }
+
+        tls_scheduler = nullptr;
+        tls_worker = nullptr;
+    }
+}
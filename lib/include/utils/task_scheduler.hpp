@@ -0,0 +1,200 @@
+#pragma once
+
+#include "cutecpp/log.hpp"
+
+#include "utils/mpmc_queue.hpp"
+#include "utils/spin_wait.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ssp4sim::utils
+{
+    class TaskGroup;
+
+    /**
+     * @brief Allocation free task descriptor
+     * The context is owned by the spawner and must outlive the wait on the group
+     */
+    struct Task
+    {
+        void (*fn)(void *context, std::size_t index) = nullptr;
+        void *context = nullptr;
+        std::size_t index = 0;
+        TaskGroup *group = nullptr;
+    };
+
+    /**
+     * @brief Set of spawned tasks that can be waited for as a whole
+     * Holds the first exception thrown by one of its tasks
+     */
+    class TaskGroup
+    {
+        friend class TaskScheduler;
+
+        std::atomic<std::size_t> pending{0};
+        std::exception_ptr exception;
+        std::mutex exception_mutex;
+
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        bool done() const noexcept
+        {
+            return pending.load(std::memory_order_acquire) == 0;
+        }
+    };
+
+    /**
+     * @brief Fixed capacity Chase-Lev deque of task descriptors
+     * The owner pushes and pops at the bottom, thieves steal from the top.
+     * Slot fields are atomics so that a racing steal reads a stale but well defined
+     * descriptor, which is then discarded by the failing compare exchange.
+     */
+    class WorkStealingDeque
+    {
+        static constexpr std::size_t cache_line = 64;
+
+        struct Slot
+        {
+            std::atomic<void (*)(void *, std::size_t)> fn{nullptr};
+            std::atomic<void *> context{nullptr};
+            std::atomic<std::size_t> index{0};
+            std::atomic<TaskGroup *> group{nullptr};
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        int64_t mask = 0;
+
+        alignas(cache_line) std::atomic<int64_t> top{0};
+        alignas(cache_line) std::atomic<int64_t> bottom{0};
+
+        void store(int64_t pos, const Task &task) noexcept;
+        Task load(int64_t pos) const noexcept;
+
+    public:
+        // Capacity is rounded up to a power of two
+        explicit WorkStealingDeque(std::size_t capacity);
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+        // Owner only, false if the deque is full
+        bool push(const Task &task) noexcept;
+
+        // Owner only, newest task first
+        bool pop(Task &task) noexcept;
+
+        // Any thread, oldest task first
+        bool steal(Task &task) noexcept;
+
+        bool empty() const noexcept;
+    };
+
+    /**
+     * @brief Work-stealing scheduler shared by the executors and the recorder
+     *
+     * Each worker owns a deque, tasks spawned on a worker go to its own deque and other
+     * threads spawn through a shared injection queue. Idle workers steal, then spin,
+     * yield and finally park until new work is spawned. A thread waiting for a group
+     * runs queued tasks until the group is done.
+     *
+     * The shared instance is sized by "simulation.scheduler.threads"
+     * (default: hardware threads - 1, at least 1), created on first use.
+     */
+    class TaskScheduler
+    {
+    public:
+        Logger log = Logger("ssp4sim.utils.TaskScheduler", LogLevel::info);
+
+        explicit TaskScheduler(std::size_t threads, SpinPolicy policy = {});
+
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler &) = delete;
+        TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+        static TaskScheduler &instance();
+
+        // Worker threads, the waiting thread comes on top
+        std::size_t size() const noexcept
+        {
+            return threads.size();
+        }
+
+        void spawn(TaskGroup &group, void (*fn)(void *, std::size_t), void *context, std::size_t index = 0);
+
+        /**
+         * @brief Run tasks until the group is done, rethrows the first exception of the group
+         */
+        void wait(TaskGroup &group);
+
+        /**
+         * @brief Invoke body(i) for i in [0, count) and wait for all of them
+         * The calling thread runs the first index itself
+         */
+        template <typename F>
+        void parallel_for(std::size_t count, F &body)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            TaskGroup group;
+            auto trampoline = [](void *context, std::size_t index)
+            { (*static_cast<F *>(context))(index); };
+
+            for (std::size_t i = 1; i < count; i++)
+            {
+                spawn(group, trampoline, &body, i);
+            }
+
+            execute(Task{trampoline, &body, 0, &group}, false);
+            wait(group);
+        }
+
+    private:
+        struct Worker
+        {
+            Worker(std::size_t index, std::size_t capacity) : index(index), deque(capacity) {}
+
+            std::size_t index;
+            WorkStealingDeque deque;
+        };
+
+        static constexpr std::size_t cache_line = 64;
+
+        SpinPolicy policy;
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+
+        MpmcQueue<Task> injection;
+
+        alignas(cache_line) std::atomic<uint64_t> epoch{0};
+        alignas(cache_line) std::atomic<uint32_t> sleepers{0};
+        std::atomic<bool> terminate{false};
+
+        // Worker of the calling thread in this scheduler, nullptr for other threads
+        Worker *current_worker() const noexcept;
+
+        // Take a task from the own deque, the injection queue or another worker
+        bool find(Worker *self, std::size_t start, Task &task) noexcept;
+
+        // Run a task and complete it in its group
+        void execute(const Task &task, bool counted) noexcept;
+
+        void wake() noexcept;
+
+        void worker_thread(std::size_t index);
+    };
+}
@@ -1,22 +1,21 @@
 #include "utils/task_thread_pool2.hpp"
 
+#include <algorithm>
 #include <atomic>
-#include <condition_variable>
 #include <cstddef>
 #include <mutex>
-#include <optional>
 #include <utility>
 
 namespace ssp4sim::utils
 {
 
-    ThreadPool2::ThreadPool2(size_t num_threads) : dones(num_threads)
+    ThreadPool2::ThreadPool2(size_t num_threads, size_t capacity, SpinPolicy policy)
+        : tasks(std::max<size_t>(capacity, 2)), policy(policy)
     {
         workers.reserve(num_threads);
         for (size_t i = 0; i < num_threads; ++i)
         {
-            dones[i] = false;
-            workers.emplace_back(&ThreadPool2::worker_thread, this, static_cast<int>(i), std::ref(dones[i]));
+            workers.emplace_back(&ThreadPool2::worker_thread, this);
         }
         log(debug)("[{}] Threads started", __func__);
     }
@@ -24,13 +23,9 @@ namespace ssp4sim::utils
     ThreadPool2::~ThreadPool2()
     {
         log(debug)("[{}] Destroying threadpool", __func__);
-        terminate.store(true);
-
-        {
-            std::lock_guard<std::mutex> lk(mtx);
-            ++epoch;
-        }
-        cv.notify_all();
+        terminate.store(true, std::memory_order_release);
+        generation.fetch_add(1, std::memory_order_acq_rel);
+        generation.notify_all();
 
         log(debug)("[{}] Waiting for all tasks to complete", __func__);
         for (std::thread &worker : workers)
@@ -43,97 +38,103 @@ namespace ssp4sim::utils
         log(debug)("[{}] Threadpool successfully destroyed", __func__);
     }
 
-    void ThreadPool2::ready(int nodes)
+    void ThreadPool2::ready(std::size_t nodes)
     {
         IF_LOG({
-            log(debug)("[{}] Ready", __func__);
+            log(debug)("[{}] Ready, {} tasks", __func__, nodes);
         });
 
-        for (std::size_t i = 0; i < workers.size(); ++i)
-        {
-            dones[i] = false;
-        }
-
-        {
-            std::lock_guard<std::mutex> lock(mtx);
-            que = static_cast<size_t>(nodes);
-            ++epoch;
-        }
-        cv.notify_all();
+        pending.store(nodes, std::memory_order_release);
     }
 
-    void ThreadPool2::enqueue(task_info &task)
+    void ThreadPool2::enqueue(const task_info &task)
     {
         IF_LOG({
             log(debug)("[{}] Enqueueing task: {}", __func__, task.node->name);
         });
 
+        // Only full when a batch is larger than the capacity, run tasks until there is room
+        while (!tasks.try_push(task))
+        {
+            if (!run_one())
+            {
+                cpu_relax();
+            }
+        }
+    }
+
+    bool ThreadPool2::run_one()
+    {
+        task_info task;
+        if (!tasks.try_pop(task))
         {
-            std::scoped_lock lock(queue_mutex);
-            tasks.emplace(std::move(task));
+            return false;
         }
+
         IF_LOG({
-            log(debug)("[{}] Task queued: {}", __func__, task.node->name);
+            log(debug)("[{}] Invoking {} {}", __func__, task.node->name, task.step.to_string());
         });
+
+        try
+        {
+            task.node->invoke(task.step);
+        }
+        catch (...)
+        {
+            std::scoped_lock lock(exception_mutex);
+            if (!exception)
+            {
+                exception = std::current_exception();
+            }
+        }
+
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            pending.notify_all();
+        }
+        return true;
     }
 
-    void ThreadPool2::worker_thread(int id, std::atomic<bool> &done)
+    void ThreadPool2::wait()
     {
-        std::size_t my_epoch = 0;
+        generation.fetch_add(1, std::memory_order_acq_rel);
+        generation.notify_all();
 
-        (void)id;
+        while (run_one())
+        {
+        }
+
+        // Only the last task notifies, earlier decrements leave a parked caller asleep
+        for (auto left = pending.load(std::memory_order_acquire); left != 0;)
+        {
+            left = spin_wait(pending, left, policy);
+        }
+
+        if (exception)
+        {
+            auto e = exception;
+            exception = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    void ThreadPool2::worker_thread()
+    {
+        uint64_t seen = 0;
 
         while (true)
         {
-            {
-                std::unique_lock<std::mutex> lock(mtx);
-                cv.wait(lock, [&]
-                        { return epoch != my_epoch; });
-                my_epoch = epoch;
-            }
+            seen = spin_wait(generation, seen, policy);
 
-            if (terminate.load())
+            if (terminate.load(std::memory_order_acquire))
             {
                 break;
             }
 
-            while (true)
+            // The batch is fully queued before the workers are woken
+            while (run_one())
             {
-                std::optional<task_info> task;
-
-                {
-                    std::unique_lock<std::mutex> lock(queue_mutex);
-                    if (que == 0)
-                    {
-                        break;
-                    }
-
-                    if (!tasks.empty())
-                    {
-                        IF_LOG({
-                            log(debug)("[{}] Found new task, que {}", __func__, que);
-                        });
-
-                        task = std::move(tasks.top());
-                        tasks.pop();
-                        --que;
-                    }
-                }
-
-                if (task)
-                {
-                    auto &t = task.value();
-                    IF_LOG({
-                        log(debug)("[{}] Invoking {} {}", __func__, t.node->name, t.step.to_string());
-                    });
-
-                    t.node->invoke(t.step);
-                    IF_LOG({
-                        log(debug)("[{}] Task completed {}", __func__, t.node->name);
-                    });
-                }
             }
-            done = true;
         }
 
         log(debug)("[{}] Thread finished", __func__);
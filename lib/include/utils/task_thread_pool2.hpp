@@ -1,14 +1,16 @@
-
 #pragma once
 
 #include "ssp4sim_definitions.hpp"
 #include "invocable.hpp"
 
+#include "utils/mpmc_queue.hpp"
+#include "utils/spin_wait.hpp"
+
 #include <atomic>
 #include <cstddef>
-#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <mutex>
-#include <stack>
 #include <thread>
 #include <vector>
 
@@ -21,52 +23,72 @@ namespace ssp4sim::utils
         ssp4sim::graph::Invocable *node;
         ssp4sim::graph::StepData step;
     };
+
     /**
-     * @brief Simple thread pool for executing queued tasks.
+     * @brief Thread pool for short, step sized batches of tasks
+     *
+     * Tasks are handed over through a lock-free ring. Workers wait for a new batch on a
+     * generation counter, spinning with a pause, then yielding and finally parking on
+     * atomic::wait, and go back to waiting once the ring is empty. The caller helps with
+     * the batch and waits for the pending counter the same way.
      */
     class ThreadPool2
     {
     private:
-        Logger log = Logger("ssp4sim.utils.ThreadPool2", LogLevel::info);
+        static constexpr std::size_t cache_line = 64;
 
-        std::mutex mtx;
-        std::condition_variable cv;
+        Logger log = Logger("ssp4sim.utils.ThreadPool2", LogLevel::info);
 
-        std::mutex queue_mutex;
         std::vector<std::thread> workers;
 
-        std::stack<task_info> tasks;
+        MpmcQueue<task_info> tasks;
+        SpinPolicy policy;
 
-        size_t que = 0;
-        std::size_t epoch = 0; //  gate flag shared by all threads
+        alignas(cache_line) std::atomic<uint64_t> generation{0};
+        alignas(cache_line) std::atomic<std::size_t> pending{0};
 
         std::atomic<bool> terminate{false};
 
-    public:
-        std::vector<std::atomic<bool>> dones;
+        std::exception_ptr exception;
+        std::mutex exception_mutex;
 
-        explicit ThreadPool2(size_t num_threads);
+    public:
+        /**
+         * @param num_threads worker threads
+         * @param capacity largest number of tasks in one batch
+         * @param policy how long waiting threads spin and yield before parking
+         */
+        ThreadPool2(size_t num_threads, size_t capacity, SpinPolicy policy = {});
 
         /**
          * @brief terminate all worker threads and wait for completion.
          */
         ~ThreadPool2();
 
-        void ready(int nodes);
+        /**
+         * @brief Open a batch of tasks
+         */
+        void ready(std::size_t nodes);
 
         /**
-         * @brief Queue a new task for execution.
-         *
+         * @brief Queue a task of the open batch
+         */
+        void enqueue(const task_info &task);
 
-         * @return Future representing the result of the task.
+        /**
+         * @brief Wake the workers and help with the batch until it is done
+         * Rethrows the first exception raised by a task
          */
-        void enqueue(task_info &task);
+        void wait();
 
     private:
+        // Run one queued task, false if the queue was empty
+        bool run_one();
+
         /**
          * @brief Function executed by each worker thread to process tasks.
          */
-        void worker_thread(int id, std::atomic<bool> &done);
+        void worker_thread();
     };
 
 } // namespace ssp4sim::utils
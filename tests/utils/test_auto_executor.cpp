@@ -0,0 +1,202 @@
+#include "execution/auto_executor.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+using ssp4sim::graph::AutoExecutor;
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::connect;
+using ssp4sim::test::load_simulation;
+
+namespace
+{
+    AutoExecutor::Trial trial(uint64_t steps, uint64_t walltime_ns, double residual)
+    {
+        AutoExecutor::Trial t;
+        t.steps = steps;
+        t.walltime_ns = walltime_ns;
+        t.residual = residual * static_cast<double>(steps);
+        return t;
+    }
+
+    // Output rises with slope per second, the outputs of each step are kept
+    struct RampNode final : Invocable
+    {
+        double slope;
+        std::map<uint64_t, double> outputs{{0, 0.0}};
+
+        RampNode(std::string name, double slope) : slope(slope)
+        {
+            this->name = std::move(name);
+        }
+
+        // Latest output at or before time
+        double output(uint64_t time) const
+        {
+            return std::prev(outputs.upper_bound(time))->second;
+        }
+
+        uint64_t invoke(StepData step_data) override
+        {
+            current_time = step_data.end_time;
+            outputs[current_time] = slope * static_cast<double>(current_time) / 1e9;
+            return current_time;
+        }
+    };
+
+    // Reads the output of source at the input time of each step
+    struct FollowerNode final : Invocable
+    {
+        RampNode *source;
+        double used = 0.0;
+
+        FollowerNode(std::string name, RampNode *source) : source(source)
+        {
+            this->name = std::move(name);
+        }
+
+        uint64_t invoke(StepData step_data) override
+        {
+            used = source->output(step_data.input_time);
+            current_time = step_data.end_time;
+            return current_time;
+        }
+
+        double coupling_residual(uint64_t time) const override
+        {
+            auto actual = source->output(time);
+            return std::abs(used - actual) / (1.0 + std::abs(actual));
+        }
+    };
+}
+
+TEST_CASE("AutoExecutor selects the fastest candidate within the residual", "[AutoExecutor]")
+{
+    std::vector<AutoExecutor::Trial> trials{
+        trial(10, 1'000'000, 0.010), // most accurate
+        trial(10, 200'000, 0.100),   // fastest, too inaccurate
+        trial(10, 500'000, 0.014),   // within 50 % of the lowest residual
+        trial(0, 0, 0.0),            // never measured
+    };
+
+    REQUIRE(AutoExecutor::select(trials, 0.0, 0.5) == 2);
+    REQUIRE(AutoExecutor::select(trials, 0.0, 0.0) == 0);
+    REQUIRE(AutoExecutor::select(trials, 0.2, 0.0) == 1);
+
+    REQUIRE(AutoExecutor::hash("ssp") == AutoExecutor::hash("ssp"));
+    REQUIRE(AutoExecutor::hash("ssp") != AutoExecutor::hash("ssd"));
+}
+
+TEST_CASE("AutoExecutor tunes on the first steps and caches the decision", "[AutoExecutor]")
+{
+    auto cache = (std::filesystem::temp_directory_path() / "ssp4sim_test_tuning.json").string();
+    std::filesystem::remove(cache);
+
+    load_simulation(R"({
+        "timestep": 0.001,
+        "executor": {
+            "method": "auto",
+            "auto": {
+                "steps": 4,
+                "warmup": 1,
+                "cache": ")" + cache + R"(",
+                "candidates": [
+                    { "method": "jacobi", "jacobi": { "parallel": false } },
+                    { "method": "seidel", "seidel": { "parallel": false } }
+                ]
+            }
+        }
+    })");
+
+    TestNode a("a");
+    TestNode b("b");
+
+    constexpr uint64_t h = 1'000'000;
+    uint64_t t = 0;
+    {
+        AutoExecutor executor({&a, &b});
+        REQUIRE(executor.chosen() == executor.trials.size());
+
+        for (int i = 0; i < 12; i++, t += h)
+        {
+            executor.invoke(StepData(t, t + h, h));
+        }
+
+        REQUIRE(executor.chosen() < executor.trials.size());
+        for (auto &trial : executor.trials)
+        {
+            REQUIRE(trial.steps == 4);
+        }
+    }
+
+    REQUIRE(a.invocations == 12);
+    REQUIRE_FALSE(a.gap);
+    REQUIRE_FALSE(b.gap);
+    REQUIRE(std::filesystem::exists(cache));
+
+    // The same system and candidates start from the cached decision
+    AutoExecutor cached({&a, &b});
+    REQUIRE(cached.chosen() < cached.trials.size());
+    cached.invoke(StepData(t, t + h, h));
+    REQUIRE(a.invocations == 13);
+
+    std::filesystem::remove(cache);
+}
+
+TEST_CASE("AutoExecutor accepts a small residual when another candidate has none", "[AutoExecutor]")
+{
+    load_simulation(R"({
+        "timestep": 0.001,
+        "tolerance": 0.001,
+        "executor": {
+            "method": "auto",
+            "auto": {
+                "steps": 4,
+                "warmup": 1,
+                "cache": "",
+                "candidates": [
+                    { "method": "jacobi", "jacobi": { "parallel": false } },
+                    { "method": "seidel", "seidel": { "parallel": false } }
+                ]
+            }
+        }
+    })");
+
+    RampNode ramp("ramp", 0.1);
+    FollowerNode follower("follower", &ramp);
+    connect(ramp, follower);
+
+    AutoExecutor executor({&ramp, &follower});
+    REQUIRE(executor.residual_tolerance == 0.001);
+
+    constexpr uint64_t h = 1'000'000;
+    uint64_t t = 0;
+    for (int i = 0; i < 10; i++, t += h)
+    {
+        executor.invoke(StepData(t, t + h, h));
+    }
+    REQUIRE(executor.chosen() < executor.trials.size());
+
+    // Jacobi lags the ramp by one step, seidel follows it exactly
+    auto &jacobi = executor.trials[0];
+    auto &seidel = executor.trials[1];
+    REQUIRE(jacobi.mean_residual() > 0.0);
+    REQUIRE(jacobi.mean_residual() < executor.residual_tolerance);
+    REQUIRE(seidel.mean_residual() == 0.0);
+
+    // The faster jacobi is within the tolerance although seidel has no residual
+    jacobi.walltime_ns = 1'000;
+    seidel.walltime_ns = 1'000'000;
+    REQUIRE(AutoExecutor::select(executor.trials, executor.residual_tolerance, executor.residual_slack) == 0);
+    REQUIRE(AutoExecutor::select(executor.trials, 0.0, executor.residual_slack) == 1);
+}
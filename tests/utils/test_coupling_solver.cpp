@@ -0,0 +1,110 @@
+#include "execution/coupling_solver.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using ssp4sim::graph::CouplingSolver;
+using ssp4sim::graph::IqnIlsSolver;
+using ssp4sim::graph::NewtonSolver;
+
+namespace
+{
+    // Two strongly coupled models, the jacobi fixed point iteration contracts slowly
+    std::vector<double> loop(const std::vector<double> &u, double load)
+    {
+        return {load - 0.9 * u[1], 0.95 * u[0] + 0.1 * std::sin(u[0])};
+    }
+
+    double residual(const std::vector<double> &u, const std::vector<double> &g)
+    {
+        double r = 0.0;
+        for (std::size_t i = 0; i < u.size(); i++)
+        {
+            r = std::max(r, std::abs(g[i] - u[i]) / (1.0 + std::abs(g[i])));
+        }
+        return r;
+    }
+
+    // Iterations until the loop is consistent, the first evaluation counts as one
+    int solve(CouplingSolver *solver, std::vector<double> &u, double load, int max_iterations)
+    {
+        if (solver)
+        {
+            solver->start_step();
+        }
+        for (int i = 1; i <= max_iterations; i++)
+        {
+            auto g = loop(u, load);
+            if (residual(u, g) <= 1e-10)
+            {
+                return i;
+            }
+
+            if (solver)
+            {
+                solver->update(u, g);
+            }
+            else
+            {
+                u = g;
+            }
+        }
+        return max_iterations + 1;
+    }
+}
+
+TEST_CASE("Coupling solvers converge on a stiff loop", "[CouplingSolver]")
+{
+    std::vector<double> u = {0.0, 0.0};
+
+    SECTION("Fixed point iteration needs many iterations")
+    {
+        REQUIRE(solve(nullptr, u, 1.0, 1000) > 100);
+    }
+
+    SECTION("Newton with a finite difference jacobian")
+    {
+        double load = 1.0;
+        NewtonSolver solver(2, [&](std::vector<double> &jacobian)
+                            {
+                                auto g = loop(u, load);
+                                for (std::size_t j = 0; j < 2; j++)
+                                {
+                                    auto perturbed = u;
+                                    perturbed[j] += 1e-7;
+                                    auto gp = loop(perturbed, load);
+                                    for (std::size_t i = 0; i < 2; i++)
+                                    {
+                                        jacobian[i * 2 + j] = (gp[i] - g[i]) / 1e-7;
+                                    }
+                                } });
+
+        REQUIRE(solve(&solver, u, load, 50) <= 8);
+
+        // The next step reuses the factorized jacobian
+        auto evaluations = solver.jacobian_evaluations;
+        load = 1.01;
+        REQUIRE(solve(&solver, u, load, 50) <= 8);
+        REQUIRE(solver.jacobian_evaluations <= evaluations + 1);
+    }
+
+    SECTION("IQN-ILS reuses secant information between steps")
+    {
+        IqnIlsSolver solver(2);
+        solver.initial_factor = 0.5;
+
+        auto first = solve(&solver, u, 1.0, 100);
+        REQUIRE(first <= 15);
+        REQUIRE(solver.columns() > 0);
+
+        auto second = solve(&solver, u, 1.01, 100);
+        REQUIRE(second <= first);
+
+        solver.reuse_steps = 0;
+        solver.start_step();
+        REQUIRE(solver.columns() == 0);
+    }
+}
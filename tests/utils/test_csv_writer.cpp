@@ -0,0 +1,80 @@
+#include "signal/csv_writer.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using ssp4sim::signal::CsvWriter;
+using ssp4sim::types::DataType;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::string read_file(const fs::path &path)
+    {
+        std::ifstream file(path);
+        std::ostringstream oss;
+        oss << file.rdbuf();
+        return oss.str();
+    }
+}
+
+TEST_CASE("CsvWriter formats values as shortest round-trip text", "[CsvWriter]")
+{
+    auto path = fs::temp_directory_path() / "ssp4sim_test_csv_writer.csv";
+
+    const double third = 1.0 / 3.0;
+    const int mode = -7;
+    const bool on = true;
+    const std::string label = "idle";
+    {
+        CsvWriter writer(path.string());
+        REQUIRE(writer.is_open());
+
+        writer << "time" << ',' << std::string("x") << '[' << std::size_t{2} << ']' << '\n';
+        writer << 0.25 << ", ";
+        writer.write(DataType::real, &third);
+        writer << ", ";
+        writer.write(DataType::integer, &mode);
+        writer << ", ";
+        writer.write(DataType::boolean, &on);
+        writer << ", ";
+        writer.write(DataType::string, &label);
+        writer << '\n';
+    }
+
+    auto content = read_file(path);
+    REQUIRE(content == "time,x[2]\n0.25, 0.3333333333333333, -7, 1, idle\n");
+    REQUIRE(std::stod("0.3333333333333333") == third);
+
+    fs::remove(path);
+}
+
+TEST_CASE("CsvWriter writes everything through a small buffer", "[CsvWriter]")
+{
+    auto path = fs::temp_directory_path() / "ssp4sim_test_csv_writer_small.csv";
+
+    std::string expected;
+    {
+        CsvWriter writer(path.string(), 40);
+        for (int64_t i = 0; i < 1000; i++)
+        {
+            writer << i << ", " << static_cast<double>(i) + 0.5 << '\n';
+            expected += std::to_string(i) + ", " + std::to_string(i) + ".5\n";
+        }
+
+        std::string long_text(100, 'a');
+        writer << long_text;
+        expected += long_text;
+
+        writer.flush();
+        REQUIRE(read_file(path) == expected);
+    }
+
+    fs::remove(path);
+}
@@ -0,0 +1,74 @@
+#include "execution/jacobi/jacobi_parallel_spin.hpp"
+#include "execution/jacobi/jacobi_parallel_tbb.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using ssp4sim::graph::ExecutionBase;
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::JacobiParallelSpin;
+using ssp4sim::graph::JacobiParallelTBB;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::load_simulation;
+
+namespace
+{
+    // Median and 99th percentile step time in ns
+    std::pair<int64_t, int64_t> measure(ExecutionBase &executor, int steps)
+    {
+        std::vector<int64_t> samples;
+        samples.reserve(steps);
+        for (int t = 0; t < steps; t++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            executor.invoke(StepData(t * 1'000'000ULL, (t + 1) * 1'000'000ULL, 1'000'000));
+            samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(samples.begin(), samples.end());
+        return {samples[samples.size() / 2], samples[samples.size() * 99 / 100]};
+    }
+}
+
+// Hidden, run explicitly with "[benchmark]"
+TEST_CASE("Per-step dispatch latency, spin pool against TBB", "[.][benchmark]")
+{
+    load_simulation(R"({ "timestep": 0.001 })");
+
+    constexpr int steps = 20'000;
+    for (std::size_t count : {2, 4, 8, 16})
+    {
+        // The nodes do no work, the measured time is the dispatch and completion overhead
+        std::vector<std::unique_ptr<TestNode>> owned;
+        std::vector<Invocable *> nodes;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            owned.push_back(std::make_unique<TestNode>());
+            nodes.push_back(owned.back().get());
+        }
+
+        JacobiParallelSpin spin(nodes, static_cast<int>(std::min<std::size_t>(count, 4)));
+        JacobiParallelTBB tbb(nodes);
+
+        // Warm up threads and caches
+        measure(spin, 1'000);
+        measure(tbb, 1'000);
+
+        auto [spin_median, spin_p99] = measure(spin, steps);
+        auto [tbb_median, tbb_p99] = measure(tbb, steps);
+
+        // Reported through the Catch2 reporter
+        WARN("nodes " << count
+                      << " spin median " << spin_median << "ns p99 " << spin_p99 << "ns"
+                      << " | tbb median " << tbb_median << "ns p99 " << tbb_p99 << "ns");
+
+        REQUIRE(owned.back()->current_time == steps * 1'000'000ULL);
+    }
+}
@@ -0,0 +1,28 @@
+#include "handler/fmu_log_sink.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+
+using ssp4sim::handler::FmuLogSink;
+
+TEST_CASE("FmuLogSink restarts after shutdown", "[FmuLogSink]")
+{
+    auto &sink = FmuLogSink::instance();
+
+    sink.push("first", 0, "logAll", "before the first shutdown");
+    sink.shutdown();
+
+    // A second simulation in the same process logs again, the final drain of the next
+    // shutdown only forwards the message if the log thread was started again
+    sink.push("second", 0, "logAll", "after the first shutdown");
+    sink.shutdown();
+
+    // The queue holds 1024 messages, a message left behind would make one of these drop
+    for (std::size_t i = 0; i < 1024; i++)
+    {
+        sink.push("third", 0, "logAll", "fill");
+    }
+    REQUIRE(sink.dropped() == 0);
+    sink.shutdown();
+}
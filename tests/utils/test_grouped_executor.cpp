@@ -0,0 +1,74 @@
+#include "execution/grouped_executor.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using ssp4sim::graph::GroupedExecutor;
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::load_simulation;
+
+TEST_CASE("GroupedExecutor interleaves groups by window and offset", "[GroupedExecutor]")
+{
+    load_simulation(R"({
+        "timestep": 0.004,
+        "executor": {
+            "sub_step": 0.004,
+            "grouped": {
+                "parallel": false,
+                "groups": [
+                    { "name": "a", "order": "seidel", "window": 0.002, "nodes": ["A1", "A2"] },
+                    { "name": "b", "order": "jacobi", "window": 0.004, "offset": 0.001, "nodes": ["B"] }
+                ]
+            }
+        }
+    })");
+
+    std::vector<std::string> trace;
+    TestNode a1("A1");
+    TestNode a2("A2");
+    TestNode b("B");
+    TestNode c("C");
+    for (auto node : {&a1, &a2, &b, &c})
+    {
+        node->trace = &trace;
+    }
+
+    GroupedExecutor executor({&a1, &a2, &b, &c});
+    REQUIRE(executor.groups.size() == 3);
+    REQUIRE(executor.groups[2].name == "ungrouped");
+    REQUIRE(executor.window == 2'000'000);
+
+    b.current_time = 1'000'000;
+    executor.invoke(StepData(0, 4'000'000, 4'000'000));
+
+    std::vector<std::string> expected = {
+        "A1@0-2", "A2@0-2",
+        "A1@2-4", "A2@2-4", "B@1-5", "C@0-4"};
+    REQUIRE(trace == expected);
+}
+
+TEST_CASE("GroupedExecutor rejects invalid groups", "[GroupedExecutor]")
+{
+    TestNode a("A");
+
+    SECTION("Unknown node")
+    {
+        load_simulation(R"({ "timestep": 0.004,
+            "executor": { "grouped": { "groups": [ { "nodes": ["X"] } ] } } })");
+        REQUIRE_THROWS_AS(GroupedExecutor({&a}), std::runtime_error);
+    }
+
+    SECTION("Window does not divide the timestep")
+    {
+        load_simulation(R"({ "timestep": 0.004,
+            "executor": { "grouped": { "groups": [ { "window": 0.003, "nodes": ["A"] } ] } } })");
+        REQUIRE_THROWS_AS(GroupedExecutor({&a}), std::runtime_error);
+    }
+}
@@ -0,0 +1,76 @@
+#include "execution/jacobi/jacobi_parallel_balanced.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::JacobiParallelBalanced;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::load_simulation;
+
+TEST_CASE("JacobiParallelBalanced assigns longest processing time first", "[JacobiParallelBalanced]")
+{
+    // One model 50x heavier than the rest
+    std::vector<double> costs = {1, 1, 1, 50, 1, 1, 1, 1, 1, 1, 1};
+
+    auto assignment = JacobiParallelBalanced::assign(costs, 3, {});
+    REQUIRE(assignment.size() == costs.size());
+
+    std::vector<double> load(3, 0.0);
+    std::vector<int> count(3, 0);
+    for (std::size_t i = 0; i < costs.size(); i++)
+    {
+        load[assignment[i]] += costs[i];
+        count[assignment[i]] += 1;
+    }
+
+    // The heavy model is alone, the light ones are split evenly over the other workers
+    REQUIRE(count[assignment[3]] == 1);
+    for (std::size_t w = 0; w < 3; w++)
+    {
+        if (w != assignment[3])
+        {
+            REQUIRE(load[w] == 5.0);
+        }
+    }
+
+    // The heavy model keeps its worker when the assignment is redone
+    std::vector<std::size_t> previous(costs.size(), 0);
+    previous[3] = 2;
+    REQUIRE(JacobiParallelBalanced::assign(costs, 3, previous)[3] == 2);
+}
+
+TEST_CASE("JacobiParallelBalanced invokes every node once per step", "[JacobiParallelBalanced]")
+{
+    load_simulation(R"({ "timestep": 0.001,
+        "executor": { "jacobi": { "balanced": { "check_interval": 2 } } } })");
+
+    std::vector<std::unique_ptr<TestNode>> storage;
+    std::vector<Invocable *> nodes;
+    for (int i = 0; i < 7; i++)
+    {
+        storage.push_back(std::make_unique<TestNode>("n" + std::to_string(i)));
+        nodes.push_back(storage.back().get());
+    }
+
+    JacobiParallelBalanced executor(nodes, 3);
+    REQUIRE(executor.buckets.size() == 3);
+
+    for (uint64_t t = 0; t < 10; t++)
+    {
+        executor.invoke(StepData(t * 1'000'000, (t + 1) * 1'000'000, 1'000'000));
+    }
+
+    for (auto &n : storage)
+    {
+        REQUIRE(n->invocations == 10);
+        REQUIRE(n->current_time == 10'000'000);
+    }
+}
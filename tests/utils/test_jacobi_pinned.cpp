@@ -0,0 +1,97 @@
+#include "execution/jacobi/jacobi_parallel_pinned.hpp"
+#include "utils/spin_wait.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::JacobiParallelPinned;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::load_simulation;
+using ssp4sim::utils::SpinBarrier;
+
+TEST_CASE("SpinBarrier releases all participants per phase", "[SpinBarrier]")
+{
+    constexpr int participants = 4;
+    constexpr int phases = 200;
+
+    // Short spins so that the parking path is exercised as well
+    SpinBarrier barrier(participants, {16, 1});
+    std::atomic<int> counter{0};
+    std::atomic<int> errors{0};
+    std::atomic<int> last{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < participants; t++)
+    {
+        threads.emplace_back([&]()
+                             {
+                                 for (int p = 0; p < phases; p++)
+                                 {
+                                     counter.fetch_add(1);
+                                     if (barrier.arrive_and_wait())
+                                     {
+                                         last.fetch_add(1);
+                                     }
+                                     // Everyone has arrived for this phase
+                                     if (counter.load() < (p + 1) * participants)
+                                     {
+                                         errors.fetch_add(1);
+                                     }
+                                     barrier.arrive_and_wait();
+                                 } });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    REQUIRE(errors == 0);
+    REQUIRE(last == phases);
+    REQUIRE(counter == participants * phases);
+}
+
+TEST_CASE("JacobiParallelPinned keeps nodes on their worker", "[JacobiParallelPinned]")
+{
+    load_simulation(R"({ "timestep": 0.001,
+        "executor": { "jacobi": { "pinned": { "workers": [ { "nodes": ["a", "b"] } ] } } } })");
+
+    TestNode a("a");
+    TestNode b("b");
+    TestNode c("c");
+    for (auto node : {&a, &b, &c})
+    {
+        node->record = true;
+    }
+
+    JacobiParallelPinned executor({&a, &b, &c});
+    REQUIRE(executor.workers.size() == 2);
+    REQUIRE(executor.workers[0].nodes.size() == 2);
+
+    executor.init();
+    for (uint64_t t = 0; t < 50; t++)
+    {
+        executor.invoke(StepData(t * 1'000'000, (t + 1) * 1'000'000, 1'000'000));
+    }
+
+    for (auto node : {&a, &b, &c})
+    {
+        REQUIRE(node->threads.size() == 51);
+        REQUIRE(node->current_time == 50'000'000);
+        for (auto id : node->threads)
+        {
+            REQUIRE(id == node->threads.front());
+        }
+        REQUIRE(node->threads.front() != std::this_thread::get_id());
+    }
+    REQUIRE(a.threads.front() == b.threads.front());
+    REQUIRE(a.threads.front() != c.threads.front());
+}
@@ -0,0 +1,45 @@
+#include "utils/linalg.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <vector>
+
+using namespace ssp4sim::utils::linalg;
+
+TEST_CASE("LU factorization solves with pivoting", "[linalg]")
+{
+    // Zero on the first diagonal element requires a row swap
+    std::vector<double> a = {0.0, 2.0, 1.0,
+                             1.0, 1.0, 0.0,
+                             2.0, 0.0, 3.0};
+    std::vector<std::size_t> pivots(3);
+    REQUIRE(lu_factor(a, pivots, 3));
+
+    // x = {1, 2, 3}
+    std::vector<double> b = {7.0, 3.0, 11.0};
+    lu_solve(a, pivots, 3, b);
+    REQUIRE(b[0] == Catch::Approx(1.0));
+    REQUIRE(b[1] == Catch::Approx(2.0));
+    REQUIRE(b[2] == Catch::Approx(3.0));
+
+    std::vector<double> singular = {1.0, 2.0,
+                                    2.0, 4.0};
+    std::vector<std::size_t> singular_pivots(2);
+    REQUIRE_FALSE(lu_factor(singular, singular_pivots, 2));
+}
+
+TEST_CASE("Least squares drops dependent columns", "[linalg]")
+{
+    // Column major 3 x 3, the last column is twice the first
+    std::vector<double> a = {1.0, 0.0, 1.0,
+                             0.0, 1.0, 1.0,
+                             2.0, 0.0, 2.0};
+    std::vector<double> b = {1.0, 2.0, 3.0};
+    std::vector<double> x;
+
+    REQUIRE(least_squares(a, 3, 3, b, x) == 2);
+    REQUIRE(x[0] == Catch::Approx(1.0));
+    REQUIRE(x[1] == Catch::Approx(2.0));
+    REQUIRE(x[2] == 0.0);
+}
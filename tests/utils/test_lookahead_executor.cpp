@@ -0,0 +1,72 @@
+#include "execution/lookahead_executor.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::LookaheadExecutor;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::connect;
+using ssp4sim::test::load_simulation;
+
+TEST_CASE("LookaheadExecutor only starts steps with final inputs", "[LookaheadExecutor]")
+{
+    load_simulation(R"({ "timestep": 0.001, "stop_time": 0.02,
+        "executor": { "lookahead": { "max_lead": 4 } } })");
+
+    TestNode a("a");
+    TestNode b("b");
+    TestNode c("c");
+    for (auto node : {&a, &b, &c})
+    {
+        node->record = true;
+    }
+
+    // a -> b -> c, a <- c closes a loop, all without delay
+    connect(a, b);
+    connect(b, c);
+    connect(c, a);
+
+    LookaheadExecutor executor({&a, &b, &c});
+    REQUIRE(executor.producers[1].size() == 1);
+    REQUIRE(executor.producers[1][0].node == 0);
+    REQUIRE(executor.consumers[0] == std::vector<std::size_t>{1});
+
+    // Progress of a at the start of each step of b
+    std::vector<uint64_t> producer_progress;
+    b.on_invoke = [&](const StepData &)
+    {
+        producer_progress.push_back(executor.progress_of(0));
+    };
+
+    uint64_t timestep = 1'000'000;
+    for (uint64_t t = 0; t < 20 * timestep; t += timestep)
+    {
+        executor.invoke(StepData(t, t + timestep, timestep));
+        REQUIRE(executor.progress_of(0) >= t + timestep);
+        REQUIRE(executor.progress_of(2) >= t + timestep);
+    }
+
+    // Every node stepped once per macro step, in order
+    for (auto node : {&a, &b, &c})
+    {
+        REQUIRE(node->starts.size() == 20);
+        for (std::size_t i = 0; i < node->starts.size(); i++)
+        {
+            REQUIRE(node->starts[i] == i * timestep);
+        }
+    }
+
+    // Without delay b never starts a step before a has completed up to its start
+    for (std::size_t i = 0; i < b.starts.size(); i++)
+    {
+        REQUIRE(producer_progress[i] >= b.starts[i]);
+    }
+
+    REQUIRE_THROWS_AS(executor.invoke(StepData(20 * timestep, 22 * timestep, 2 * timestep)), std::runtime_error);
+}
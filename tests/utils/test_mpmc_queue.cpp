@@ -0,0 +1,88 @@
+#include "utils/mpmc_queue.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace ssp4sim::utils;
+
+TEST_CASE("MpmcQueue rounds capacity and rejects when full", "[MpmcQueue]")
+{
+    MpmcQueue<int> queue(5);
+    REQUIRE(queue.capacity() == 8);
+
+    for (int i = 0; i < 8; i++)
+    {
+        REQUIRE(queue.try_push(i));
+    }
+    REQUIRE_FALSE(queue.try_push(8));
+
+    int value = -1;
+    REQUIRE(queue.try_pop(value));
+    REQUIRE(value == 0);
+    REQUIRE(queue.try_push(8));
+
+    for (int i = 1; i <= 8; i++)
+    {
+        REQUIRE(queue.try_pop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE_FALSE(queue.try_pop(value));
+}
+
+TEST_CASE("MpmcQueue delivers every item once with several producers and consumers", "[MpmcQueue]")
+{
+    constexpr int producers = 4;
+    constexpr int consumers = 3;
+    constexpr int per_producer = 20000;
+
+    MpmcQueue<uint64_t> queue(64);
+    std::atomic<int> received{0};
+    std::atomic<uint64_t> sum{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&, p]()
+                             {
+            for (int i = 1; i <= per_producer; i++)
+            {
+                uint64_t value = static_cast<uint64_t>(p) * per_producer + i;
+                while (!queue.try_push(value))
+                {
+                    std::this_thread::yield();
+                }
+            } });
+    }
+
+    for (int c = 0; c < consumers; c++)
+    {
+        threads.emplace_back([&]()
+                             {
+            uint64_t value = 0;
+            while (received.load() < producers * per_producer)
+            {
+                if (queue.try_pop(value))
+                {
+                    sum.fetch_add(value);
+                    received.fetch_add(1);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            } });
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    uint64_t n = static_cast<uint64_t>(producers) * per_producer;
+    REQUIRE(received.load() == producers * per_producer);
+    REQUIRE(sum.load() == n * (n + 1) / 2);
+}
@@ -0,0 +1,77 @@
+#include "graph/graph.hpp"
+#include "utils/config.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+
+using ssp4sim::graph::Graph;
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::load_simulation;
+using ssp4sim::utils::Config;
+
+TEST_CASE("Nested systems step with their own executor and timestep", "[Graph]")
+{
+    load_simulation(R"({
+        "timestep": 0.004,
+        "executor": {
+            "method": "jacobi",
+            "jacobi": { "parallel": true, "method": 3 },
+            "parallel_init": true
+        }
+    })");
+
+    TestNode a("a");
+    TestNode b("b");
+    TestNode c("c");
+    TestNode outside("outside");
+
+    a.add_child(&b);
+
+    // inner contains a and b, cluster contains inner and c
+    Graph inner(std::map<std::string, Invocable *>{{"a", &a}, {"b", &b}}, nullptr);
+    inner.name = "inner";
+    inner.nested = true;
+    inner.step_size = 1'000'000;
+    inner.executor_config = {{"method", "seidel"}, {"seidel", {{"parallel", false}}}, {"sub_step", 0.001}};
+
+    Graph cluster(std::map<std::string, Invocable *>{{"inner", &inner}, {"c", &c}}, nullptr);
+    cluster.name = "cluster";
+    cluster.nested = true;
+    cluster.step_size = 2'000'000;
+    cluster.executor_config = {{"sub_step", 0.002}};
+    inner.add_child(&c);
+
+    Graph top(std::map<std::string, Invocable *>{{"cluster", &cluster}, {"outside", &outside}}, nullptr);
+    top.init();
+
+    // Nested executors are built before the nodes initialize in parallel
+    REQUIRE(inner.executor);
+    REQUIRE(cluster.executor);
+    REQUIRE(a.initialized == 1);
+    REQUIRE(c.initialized == 1);
+    REQUIRE(outside.initialized == 1);
+
+    constexpr uint64_t macro = 4'000'000;
+    REQUIRE(top.invoke(StepData(0, 3 * macro, macro)) == 3 * macro);
+
+    REQUIRE(outside.invocations == 3);
+    REQUIRE(c.invocations == 6);
+    REQUIRE(c.largest_step == 2'000'000);
+    REQUIRE(a.invocations == 12);
+    REQUIRE(a.largest_step == 1'000'000);
+    REQUIRE(b.current_time == 3 * macro);
+    REQUIRE(inner.current_time == 3 * macro);
+    REQUIRE_FALSE(a.gap);
+    REQUIRE_FALSE(b.gap);
+    REQUIRE_FALSE(c.gap);
+
+    // Config patches of the nested executors are not left behind
+    REQUIRE(Config::getOr("simulation.executor.method", std::string()) == "jacobi");
+}
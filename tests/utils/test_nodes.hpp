@@ -0,0 +1,105 @@
+#pragma once
+
+#include "execution/invocable.hpp"
+#include "utils/config.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ssp4sim::test
+{
+    /**
+     * @brief Fake node for the executor tests
+     *
+     * Steps to the end of each step and keeps count of what it was asked to do. Invocation
+     * order is taken from a shared clock, a shared trace collects "name@start-end" in ms and
+     * with record the start time and thread of each invocation are kept.
+     */
+    class TestNode final : public ssp4sim::graph::Invocable
+    {
+    public:
+        // Shared between nodes, the value at the last invocation is kept in invoked_at
+        std::atomic<int> *clock = nullptr;
+        std::vector<std::string> *trace = nullptr;
+
+        // Keep starts and threads, off for the benchmarks
+        bool record = false;
+
+        // Called before each step
+        std::function<void(const ssp4sim::graph::StepData &)> on_invoke;
+
+        std::atomic<int> invocations{0};
+        int invoked_at = -1;
+        int initialized = 0;
+
+        // A step did not start where the previous one ended
+        bool gap = false;
+        uint64_t largest_step = 0;
+
+        std::vector<uint64_t> starts;
+        // Threads of enter_init and each step
+        std::vector<std::thread::id> threads;
+
+        TestNode(std::string name = "node", std::atomic<int> *clock = nullptr) : clock(clock)
+        {
+            this->name = std::move(name);
+        }
+
+        void enter_init() override
+        {
+            if (record)
+            {
+                threads.push_back(std::this_thread::get_id());
+            }
+        }
+
+        void exit_init() override
+        {
+            initialized += 1;
+        }
+
+        uint64_t invoke(ssp4sim::graph::StepData step_data) override
+        {
+            if (on_invoke)
+            {
+                on_invoke(step_data);
+            }
+            if (clock != nullptr)
+            {
+                invoked_at = clock->fetch_add(1);
+            }
+            if (trace != nullptr)
+            {
+                trace->push_back(name + "@" + std::to_string(step_data.start_time / 1'000'000) + "-" + std::to_string(step_data.end_time / 1'000'000));
+            }
+            if (record)
+            {
+                starts.push_back(step_data.start_time);
+                threads.push_back(std::this_thread::get_id());
+            }
+
+            invocations += 1;
+            gap = gap || step_data.start_time != current_time;
+            largest_step = std::max(largest_step, step_data.end_time - step_data.start_time);
+            current_time = step_data.end_time;
+            return current_time;
+        }
+    };
+
+    inline void connect(ssp4sim::graph::Invocable &from, ssp4sim::graph::Invocable &to)
+    {
+        from.add_child(&to);
+        to.add_parent(&from);
+    }
+
+    // Load a configuration with only the "simulation" object
+    inline void load_simulation(const std::string &simulation)
+    {
+        ssp4sim::utils::Config::loadFromString(R"({ "simulation": )" + simulation + " }");
+    }
+}
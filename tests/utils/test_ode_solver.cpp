@@ -0,0 +1,116 @@
+#include "solver/ode_solver.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace ssp4sim::solver;
+
+namespace
+{
+    // Two decoupled decays stacked in one state vector
+    void decay(double, const double *x, double *dx)
+    {
+        dx[0] = -x[0];
+        dx[1] = -2.0 * x[1];
+    }
+
+    std::vector<double> integrate(OdeSolver &solver, std::vector<double> x, double h, int steps)
+    {
+        double t = 0.0;
+        for (int i = 0; i < steps; i++)
+        {
+            solver.step(t, h, x);
+            t += h;
+        }
+        return x;
+    }
+}
+
+TEST_CASE("RungeKutta4 integrates the combined state", "[OdeSolver]")
+{
+    auto solver = make_solver("rk4", 2, decay);
+    auto x = integrate(*solver, {1.0, 1.0}, 0.01, 100);
+
+    REQUIRE(std::abs(x[0] - std::exp(-1.0)) < 1e-9);
+    REQUIRE(std::abs(x[1] - std::exp(-2.0)) < 1e-9);
+    REQUIRE(solver->evaluations == 400);
+}
+
+TEST_CASE("Bdf converges with step size", "[OdeSolver]")
+{
+    auto bdf1 = make_solver("bdf1", 2, decay);
+    auto bdf2 = make_solver("bdf2", 2, decay);
+
+    auto x1 = integrate(*bdf1, {1.0, 1.0}, 0.001, 1000);
+    auto x2 = integrate(*bdf2, {1.0, 1.0}, 0.001, 1000);
+
+    auto e1 = std::abs(x1[0] - std::exp(-1.0));
+    auto e2 = std::abs(x2[0] - std::exp(-1.0));
+
+    REQUIRE(e1 < 1e-3);
+    REQUIRE(e2 < 1e-5);
+    REQUIRE(e2 < e1);
+}
+
+TEST_CASE("Bdf stays stable on stiff problems", "[OdeSolver]")
+{
+    auto stiff = [](double t, const double *x, double *dx)
+    {
+        dx[0] = -1000.0 * (x[0] - std::cos(t));
+    };
+
+    auto bdf = make_solver("bdf2", 1, stiff);
+    auto x = integrate(*bdf, {0.0}, 0.1, 10);
+    REQUIRE(std::abs(x[0] - std::cos(1.0)) < 1e-2);
+
+    auto rk = make_solver("rk4", 1, stiff);
+    auto y = integrate(*rk, {0.0}, 0.1, 10);
+    REQUIRE_FALSE(std::abs(y[0] - std::cos(1.0)) < 1e-2);
+}
+
+TEST_CASE("Bdf solves newton systems that need row pivoting", "[OdeSolver]")
+{
+    // The iteration matrix I - h * A is m, its factorization swaps rows in the second column
+    constexpr double h = 0.1;
+    static const double m[3][3] = {{1.0, 0.0, 0.0},
+                                   {0.5, 0.01, 1.0},
+                                   {0.2, 1.0, 0.0}};
+    auto linear = [](double, const double *x, double *dx)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            dx[i] = 0.0;
+            for (int j = 0; j < 3; j++)
+            {
+                dx[i] += ((i == j ? 1.0 : 0.0) - m[i][j]) / h * x[j];
+            }
+        }
+    };
+
+    // Implicit Euler of a linear system solves m x1 = x0, pick x1 and derive x0
+    const std::vector<double> expected{1.0, 2.0, 3.0};
+    std::vector<double> x(3, 0.0);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            x[i] += m[i][j] * expected[j];
+        }
+    }
+
+    auto bdf = make_solver("bdf1", 3, linear);
+    bdf->step(0.0, h, x);
+
+    for (int i = 0; i < 3; i++)
+    {
+        REQUIRE(std::abs(x[i] - expected[i]) < 1e-6);
+    }
+}
+
+TEST_CASE("Unknown solver is rejected", "[OdeSolver]")
+{
+    REQUIRE_THROWS_AS(make_solver("euler", 1, decay), std::invalid_argument);
+}
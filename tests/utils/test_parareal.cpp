@@ -0,0 +1,246 @@
+#include "execution/parareal.hpp"
+#include "graph/graph.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using ssp4sim::graph::Graph;
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::Parareal;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::connect;
+using ssp4sim::test::load_simulation;
+using Catch::Matchers::WithinAbs;
+
+namespace
+{
+    constexpr double lambda = -1.5;
+
+    // Explicit Euler on y' = lambda * y with steps of at most step ns
+    void euler(std::vector<double> &state, uint64_t start, uint64_t end, uint64_t step)
+    {
+        for (auto t = start; t < end; t += step)
+        {
+            auto h = static_cast<double>(std::min(step, end - t)) * 1e-9;
+            state[0] += h * lambda * state[0];
+        }
+    }
+
+    /**
+     * Co-simulation like model x' = u - x, u is the output of source or 0. The state is only
+     * reachable through snapshots, like a serialized fmu state
+     */
+    struct LagNode final : Invocable
+    {
+        double x;
+        LagNode *source = nullptr;
+        std::map<uint64_t, double> outputs;
+
+        LagNode(std::string name, double x) : x(x)
+        {
+            this->name = std::move(name);
+            outputs[0] = x;
+        }
+
+        // Latest output at or before time
+        double output(uint64_t time) const
+        {
+            return std::prev(outputs.upper_bound(time))->second;
+        }
+
+        uint64_t invoke(StepData step_data) override
+        {
+            auto u = source != nullptr ? source->output(step_data.input_time) : 0.0;
+            x += static_cast<double>(step_data.end_time - step_data.start_time) * 1e-9 * (u - x);
+            current_time = step_data.end_time;
+            outputs[current_time] = x;
+            return current_time;
+        }
+
+        bool save_snapshot(std::vector<std::byte> &snapshot) override
+        {
+            snapshot.resize(sizeof(current_time) + sizeof(x));
+            std::memcpy(snapshot.data(), &current_time, sizeof(current_time));
+            std::memcpy(snapshot.data() + sizeof(current_time), &x, sizeof(x));
+            return true;
+        }
+
+        bool load_snapshot(const std::vector<std::byte> &snapshot) override
+        {
+            std::memcpy(&current_time, snapshot.data(), sizeof(current_time));
+            std::memcpy(&x, snapshot.data() + sizeof(current_time), sizeof(x));
+            outputs[current_time] = x;
+            return true;
+        }
+
+        std::size_t input_values() const override
+        {
+            return source != nullptr ? 1 : 0;
+        }
+
+        bool fetch_input_values(uint64_t input_time, double *values) override
+        {
+            if (source != nullptr)
+            {
+                values[0] = source->output(input_time);
+            }
+            return true;
+        }
+    };
+
+    // A source feeding a consumer, stepped by the configured executor
+    struct LagSystem
+    {
+        LagNode source{"source", 1.0};
+        LagNode consumer{"consumer", 0.0};
+        Graph graph;
+
+        LagSystem() : graph(std::map<std::string, Invocable *>{{"source", &source}, {"consumer", &consumer}}, nullptr)
+        {
+            consumer.source = &source;
+            connect(source, consumer);
+            graph.init();
+        }
+    };
+}
+
+TEST_CASE("Parareal splits the horizon into windows", "[Parareal]")
+{
+    REQUIRE(Parareal::split(0, 10, 3) == std::vector<uint64_t>{0, 4, 8, 10});
+    REQUIRE(Parareal::split(5, 9, 4) == std::vector<uint64_t>{5, 6, 7, 8, 9});
+    REQUIRE_THROWS_AS(Parareal::split(0, 10, 0), std::runtime_error);
+}
+
+TEST_CASE("Parareal converges to the serial fine solution", "[Parareal]")
+{
+    constexpr uint64_t end = 2'000'000'000;
+    constexpr uint64_t fine_step = 1'000'000;
+    constexpr std::size_t windows = 8;
+
+    auto coarse = [](std::size_t, Parareal::State &state, uint64_t start, uint64_t stop)
+    { euler(state.values, start, stop, stop - start); };
+    auto fine = [](std::size_t, Parareal::State &state, uint64_t start, uint64_t stop)
+    { euler(state.values, start, stop, fine_step); };
+
+    auto boundaries = Parareal::split(0, end, windows);
+
+    std::vector<double> serial{1.0};
+    Parareal::State reference{{1.0}, {}};
+    for (std::size_t n = 0; n < windows; n++)
+    {
+        euler(serial, boundaries[n], boundaries[n + 1], fine_step);
+    }
+
+    SECTION("Within the tolerance in fewer iterations than windows")
+    {
+        Parareal parareal(3, coarse, fine);
+        parareal.tolerance = 1e-6;
+
+        REQUIRE(parareal.run(reference, boundaries));
+        REQUIRE(parareal.iterations < static_cast<int>(windows));
+        REQUIRE(parareal.residuals.back() <= 1e-6);
+        REQUIRE_THAT(parareal.states.back().values[0], WithinAbs(serial[0], 1e-5));
+
+        // The residual shrinks from one iteration to the next
+        for (std::size_t k = 1; k < parareal.residuals.size(); k++)
+        {
+            REQUIRE(parareal.residuals[k] < parareal.residuals[k - 1]);
+        }
+    }
+
+    SECTION("Exact after one iteration per window")
+    {
+        Parareal parareal(4, coarse, fine);
+        parareal.tolerance = 0.0;
+        parareal.max_iterations = 100;
+
+        REQUIRE(parareal.run(reference, boundaries));
+        REQUIRE(parareal.iterations == static_cast<int>(windows));
+        REQUIRE(parareal.states.back().values[0] == serial[0]);
+    }
+
+    SECTION("Windows are never solved concurrently on one replica")
+    {
+        std::vector<std::atomic<int>> busy(2);
+        std::atomic<bool> overlap{false};
+        auto guarded = [&](std::size_t replica, Parareal::State &state, uint64_t start, uint64_t stop)
+        {
+            if (busy[replica]++ != 0)
+            {
+                overlap = true;
+            }
+            euler(state.values, start, stop, fine_step);
+            busy[replica]--;
+        };
+
+        Parareal parareal(2, coarse, guarded);
+        parareal.run(reference, boundaries);
+        parareal.fine_pass();
+        REQUIRE_FALSE(overlap);
+    }
+}
+
+TEST_CASE("Parareal moves snapshots of a co-simulation system between replicas", "[Parareal]")
+{
+    load_simulation(R"({
+        "timestep": 0.01,
+        "executor": { "method": "jacobi", "jacobi": { "parallel": false } }
+    })");
+
+    constexpr uint64_t end = 2'000'000'000;
+    constexpr uint64_t step = 10'000'000;
+    constexpr std::size_t windows = 4;
+
+    LagSystem serial;
+    for (uint64_t t = 0; t < end; t += step)
+    {
+        serial.graph.executor->invoke(StepData(t, t + step, step));
+    }
+
+    std::vector<std::unique_ptr<LagSystem>> systems;
+    std::vector<Graph *> graphs;
+    for (int r = 0; r < 2; r++)
+    {
+        graphs.push_back(&systems.emplace_back(std::make_unique<LagSystem>())->graph);
+    }
+
+    Parareal parareal(graphs.size(), Parareal::snapshot_propagator(graphs, 10 * step), Parareal::snapshot_propagator(graphs, step));
+    parareal.correction = Parareal::Correction::replacement;
+    parareal.tolerance = 0.0;
+    parareal.max_iterations = 100;
+
+    Parareal::State initial;
+    REQUIRE(graphs[0]->save_snapshot(initial.snapshot));
+    REQUIRE(parareal.run(initial, Parareal::split(0, end, windows)));
+
+    // The coarse prediction is corrected once per window and ends on the serial solution
+    REQUIRE(parareal.iterations == static_cast<int>(windows));
+    REQUIRE(parareal.residuals.front() > 0.0);
+    REQUIRE(parareal.states.back().values == std::vector<double>{serial.source.x});
+
+    LagSystem loaded;
+    REQUIRE(loaded.graph.load_snapshot(parareal.states.back().snapshot));
+    REQUIRE(loaded.graph.current_time == end);
+    REQUIRE(loaded.source.x == serial.source.x);
+    REQUIRE(loaded.consumer.x == serial.consumer.x);
+
+    // Nodes without snapshots can not take part
+    TestNode plain("plain");
+    Graph unsupported(std::map<std::string, Invocable *>{{"plain", &plain}}, nullptr);
+    std::vector<std::byte> snapshot;
+    REQUIRE_FALSE(unsupported.save_snapshot(snapshot));
+}
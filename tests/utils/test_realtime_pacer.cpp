@@ -0,0 +1,75 @@
+#include "execution/realtime_pacer.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::RealTimePacer;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::load_simulation;
+
+TEST_CASE("RealTimePacer holds steps to the wall clock", "[RealTimePacer]")
+{
+    load_simulation(R"({
+        "real_time": { "enable": true, "factor": 2.0, "min_slack": 0.0005 }
+    })");
+
+    TestNode node;
+    RealTimePacer pacer({&node});
+    REQUIRE(pacer.enabled);
+
+    constexpr uint64_t step = 4'000'000;
+    constexpr int steps = 10;
+
+    int idle_calls = 0;
+    auto begin = std::chrono::steady_clock::now();
+    pacer.start(0);
+    for (int i = 0; i < steps; i++)
+    {
+        REQUIRE(pacer.pace(i * step, (i + 1) * step, [&]()
+                           { idle_calls += 1; }));
+    }
+    auto wall = std::chrono::steady_clock::now() - begin;
+
+    // 40 ms simulated at twice real time
+    REQUIRE(wall >= std::chrono::milliseconds(20));
+    REQUIRE(pacer.overruns == 0);
+    REQUIRE(idle_calls == steps);
+    REQUIRE(std::accumulate(pacer.jitter.begin(), pacer.jitter.end(), uint64_t{0}) == steps);
+    REQUIRE_FALSE(pacer.under_pressure());
+}
+
+TEST_CASE("RealTimePacer reports deadline and model overruns", "[RealTimePacer]")
+{
+    load_simulation(R"({
+        "real_time": { "enable": true }
+    })");
+
+    TestNode node;
+    RealTimePacer pacer({&node});
+
+    constexpr uint64_t step = 1'000'000;
+    pacer.start(0);
+
+    // The model spends three budgets and the step finishes late
+    node.walltime_ns += 3 * step;
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    REQUIRE_FALSE(pacer.pace(0, step));
+    REQUIRE(pacer.under_pressure());
+    REQUIRE(pacer.overruns == 1);
+    REQUIRE(pacer.max_lateness_ns >= step);
+    REQUIRE(pacer.models[0].overruns == 1);
+    REQUIRE(pacer.models[0].max_step_walltime == 3 * step);
+
+    // Far ahead of the schedule again
+    REQUIRE(pacer.pace(step, 10 * step));
+    REQUIRE_FALSE(pacer.under_pressure());
+    REQUIRE(pacer.models[0].overruns == 1);
+    REQUIRE(pacer.real_time_factor() > 0.0);
+}
@@ -0,0 +1,69 @@
+#include "execution/relaxation.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <stdexcept>
+
+using ssp4sim::graph::Relaxation;
+
+namespace
+{
+    // Iterates the stiff coupling u = 1 - 1.5 * u, returns the number of iterations
+    // until the residual is below the tolerance
+    int iterate(Relaxation &relaxation, double &u, int max_iterations)
+    {
+        relaxation.resize(1);
+        relaxation.reset();
+        for (int i = 1; i <= max_iterations; i++)
+        {
+            double g = 1.0 - 1.5 * u;
+            relaxation.evaluate(0, &g, &u, 1);
+            if (relaxation.finish() <= 1e-10)
+            {
+                return i;
+            }
+            relaxation.apply(0, &u, 1);
+        }
+        return max_iterations + 1;
+    }
+}
+
+TEST_CASE("Relaxation methods", "[Relaxation]")
+{
+    SECTION("Unrelaxed iteration diverges")
+    {
+        Relaxation relaxation;
+        double u = 0.0;
+        REQUIRE(iterate(relaxation, u, 50) > 50);
+    }
+
+    SECTION("Aitken relaxation converges")
+    {
+        Relaxation relaxation;
+        relaxation.method = Relaxation::Method::aitken;
+        relaxation.initial_factor = 0.5;
+
+        // The secant factor of a linear coupling is exact after the second residual
+        double u = 0.0;
+        REQUIRE(iterate(relaxation, u, 50) <= 4);
+        REQUIRE(u == Catch::Approx(0.4));
+    }
+
+    SECTION("Constant relaxation keeps the factor")
+    {
+        Relaxation relaxation;
+        relaxation.method = Relaxation::Method::constant;
+        relaxation.initial_factor = 0.5;
+
+        double u = 0.0;
+        iterate(relaxation, u, 3);
+        REQUIRE(relaxation.factor == 0.5);
+    }
+
+    SECTION("Unknown method")
+    {
+        REQUIRE(Relaxation::parse("aitken") == Relaxation::Method::aitken);
+        REQUIRE_THROWS_AS(Relaxation::parse("newton"), std::runtime_error);
+    }
+}
@@ -160,3 +160,22 @@ TEST_CASE("RingBuffer tracks timestamps and finds valid indices", "[RingBuffer]"
     REQUIRE(buffer.find_latest_valid_index(300, index) == true);
     REQUIRE(buffer.find_latest_valid_index(301, index) == true);
 }
+
+TEST_CASE("RingBuffer finds the samples around a time", "[RingBuffer]")
+{
+    RingBuffer buffer(4, sizeof(double));
+    buffer.push(0);
+    auto i10 = buffer.push(10);
+    auto i20 = buffer.push(20);
+
+    std::size_t before = 0;
+    std::size_t after = 0;
+
+    REQUIRE(buffer.find_bracketing_indices(15, before, after));
+    REQUIRE(before == i10);
+    REQUIRE(after == i20);
+
+    // Exact hits and times after the newest sample are held, not interpolated
+    REQUIRE_FALSE(buffer.find_bracketing_indices(10, before, after));
+    REQUIRE_FALSE(buffer.find_bracketing_indices(25, before, after));
+}
@@ -0,0 +1,78 @@
+#include "execution/seidel/seidel_parallel.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::ParallelSeidel;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::connect;
+using ssp4sim::test::load_simulation;
+
+TEST_CASE("ParallelSeidel invokes each node after its parents", "[ParallelSeidel]")
+{
+    load_simulation(R"({ "timestep": 0.1 })");
+
+    std::atomic<int> clock{0};
+    std::vector<std::unique_ptr<TestNode>> owned;
+    for (int i = 0; i < 7; i++)
+    {
+        owned.push_back(std::make_unique<TestNode>("n" + std::to_string(i), &clock));
+    }
+
+    // Tree with a join: 0 -> {1, 2}, 1 -> {3, 4}, 2 -> 5, {4, 5} -> 6
+    connect(*owned[0], *owned[1]);
+    connect(*owned[0], *owned[2]);
+    connect(*owned[1], *owned[3]);
+    connect(*owned[1], *owned[4]);
+    connect(*owned[2], *owned[5]);
+    connect(*owned[4], *owned[6]);
+    connect(*owned[5], *owned[6]);
+
+    std::vector<Invocable *> nodes;
+    for (auto &n : owned)
+    {
+        nodes.push_back(n.get());
+    }
+
+    ParallelSeidel executor(nodes);
+
+    for (int step = 0; step < 3; step++)
+    {
+        executor.invoke(StepData(step * 100'000'000ULL, (step + 1) * 100'000'000ULL, 100'000'000ULL));
+    }
+
+    for (auto &n : owned)
+    {
+        REQUIRE(n->invocations == 3);
+        REQUIRE(n->current_time == 300'000'000ULL);
+        for (auto p : n->parents)
+        {
+            // Last step ordering, parents always finish before the child starts
+            REQUIRE(static_cast<TestNode *>(p)->invoked_at < n->invoked_at);
+        }
+    }
+}
+
+TEST_CASE("ParallelSeidel rejects algebraic loops", "[ParallelSeidel]")
+{
+    load_simulation(R"({ "timestep": 0.1 })");
+
+    std::atomic<int> clock{0};
+    TestNode a("a", &clock);
+    TestNode b("b", &clock);
+    TestNode c("c", &clock);
+    connect(a, b);
+    connect(b, c);
+    connect(c, b);
+
+    REQUIRE_THROWS_AS(ParallelSeidel(std::vector<Invocable *>{&a, &b, &c}), std::runtime_error);
+}
@@ -0,0 +1,231 @@
+#include "execution/seidel/seidel_speculative.hpp"
+#include "utils/time.hpp"
+#include "test_nodes.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using Catch::Approx;
+using ssp4sim::graph::Invocable;
+using ssp4sim::graph::SpeculativeSeidel;
+using ssp4sim::graph::StepData;
+using ssp4sim::test::TestNode;
+using ssp4sim::test::connect;
+using ssp4sim::test::load_simulation;
+
+namespace
+{
+    // Output on a line through offset with slope per second
+    class RampNode final : public Invocable
+    {
+    public:
+        double slope = 1.0;
+        double offset = 0.0;
+        double output = 0.0;
+
+        RampNode(std::string name)
+        {
+            this->name = std::move(name);
+        }
+
+        uint64_t invoke(StepData step_data) override
+        {
+            output = offset + slope * ssp4sim::utils::time::ns_to_s(step_data.end_time);
+            current_time = step_data.end_time;
+            return current_time;
+        }
+    };
+
+    // Integrates the output of its parent in sub-steps, speculates through the Invocable interface
+    class IntegratorNode final : public Invocable
+    {
+    public:
+        RampNode *parent;
+        bool can_save = true;
+
+        double state = 0.0;
+        double saved = 0.0;
+        uint64_t saved_time = 0;
+        int restores = 0;
+
+        uint64_t timestep = 0;
+        int sub_steps = 0;
+
+        IntegratorNode(std::string name, RampNode *parent) : parent(parent)
+        {
+            this->name = std::move(name);
+        }
+
+        std::size_t input_values() const override
+        {
+            return 1;
+        }
+
+        bool fetch_input_values(uint64_t, double *values) override
+        {
+            values[0] = parent->output;
+            return true;
+        }
+
+        uint64_t step_with_inputs(StepData step_data, const double *values) override
+        {
+            timestep = step_data.timestep;
+            sub_steps = 0;
+            for (auto t = step_data.start_time; t < step_data.end_time; t += step_data.timestep)
+            {
+                auto end = std::min(t + step_data.timestep, step_data.end_time);
+                state += values[0] * ssp4sim::utils::time::ns_to_s(end - t);
+                sub_steps += 1;
+            }
+            current_time = step_data.end_time;
+            return current_time;
+        }
+
+        uint64_t invoke(StepData step_data) override
+        {
+            double input = parent->output;
+            return step_with_inputs(step_data, &input);
+        }
+
+        bool save_state() override
+        {
+            saved = state;
+            saved_time = current_time;
+            return can_save;
+        }
+
+        bool restore_state() override
+        {
+            state = saved;
+            current_time = saved_time;
+            restores += 1;
+            return true;
+        }
+    };
+}
+
+TEST_CASE("SpeculativeSeidel extrapolates and measures deviation", "[SpeculativeSeidel]")
+{
+    REQUIRE(SpeculativeSeidel::extrapolate(0, 1.0, 10, 2.0, 20) == Approx(3.0));
+    REQUIRE(SpeculativeSeidel::extrapolate(10, 4.0, 20, 2.0, 25) == Approx(1.0));
+
+    REQUIRE(SpeculativeSeidel::deviation({1.0, 2.0}, {1.0, 2.0}) == 0.0);
+    // Relative to 1 + |actual|
+    REQUIRE(SpeculativeSeidel::deviation({1.0, 2.0}, {1.0, 5.0}) == Approx(0.5));
+}
+
+TEST_CASE("SpeculativeSeidel runs models that can not speculate in dependency order", "[SpeculativeSeidel]")
+{
+    load_simulation(R"({ "timestep": 0.1 })");
+
+    std::atomic<int> clock{0};
+    TestNode source("source", &clock);
+    TestNode controller("controller", &clock);
+    TestNode plant("plant", &clock);
+    connect(source, controller);
+    connect(controller, plant);
+
+    SpeculativeSeidel executor({&plant, &controller, &source});
+
+    for (int step = 0; step < 3; step++)
+    {
+        clock = 0;
+        executor.invoke(StepData(step * 100'000'000ULL, (step + 1) * 100'000'000ULL, 100'000'000ULL));
+        REQUIRE(source.invoked_at < controller.invoked_at);
+        REQUIRE(controller.invoked_at < plant.invoked_at);
+    }
+
+    REQUIRE(plant.invocations == 3);
+    REQUIRE(plant.current_time == 300'000'000ULL);
+    REQUIRE(executor.hit_rate() == 0.0);
+}
+
+TEST_CASE("SpeculativeSeidel rejects algebraic loops", "[SpeculativeSeidel]")
+{
+    load_simulation(R"({ "timestep": 0.1 })");
+
+    std::atomic<int> clock{0};
+    TestNode a("a", &clock);
+    TestNode b("b", &clock);
+    connect(a, b);
+    connect(b, a);
+
+    REQUIRE_THROWS(SpeculativeSeidel({&a, &b}));
+}
+
+TEST_CASE("SpeculativeSeidel keeps hits and rolls back misses", "[SpeculativeSeidel]")
+{
+    load_simulation(R"({ "timestep": 0.1, "executor": { "sub_step": 0.05 } })");
+
+    RampNode source("source");
+    IntegratorNode plant("plant", &source);
+    connect(source, plant);
+
+    SpeculativeSeidel executor({&source, &plant});
+
+    // Integral of the input at the end of each macro step
+    double expected = 0.0;
+    auto step = [&](int i)
+    {
+        executor.invoke(StepData(i * 100'000'000ULL, (i + 1) * 100'000'000ULL, 100'000'000ULL));
+        expected += source.output * 0.1;
+    };
+
+    // No history, then held inputs miss on the ramp
+    step(0);
+    step(1);
+    REQUIRE(executor.statistics(plant.id).skipped == 1);
+    REQUIRE(executor.statistics(plant.id).misses == 1);
+
+    // The ramp is extrapolated exactly
+    step(2);
+    step(3);
+    REQUIRE(executor.statistics(plant.id).hits == 2);
+    REQUIRE(plant.restores == 1);
+    REQUIRE(plant.state == Approx(expected));
+
+    // A jump is not predicted, the step is redone on the real input
+    source.offset = 5.0;
+    step(4);
+    REQUIRE(executor.statistics(plant.id).misses == 2);
+    REQUIRE(plant.restores == 2);
+    REQUIRE(plant.state == Approx(expected));
+    REQUIRE(plant.current_time == 500'000'000ULL);
+
+    // Steps are sub-stepped like SerialSeidel
+    REQUIRE(plant.timestep == 50'000'000ULL);
+    REQUIRE(plant.sub_steps == 2);
+
+    REQUIRE(executor.hit_rate() == Approx(0.5));
+}
+
+TEST_CASE("SpeculativeSeidel runs models that can not save their state after their parents", "[SpeculativeSeidel]")
+{
+    load_simulation(R"({ "timestep": 0.1 })");
+
+    RampNode source("source");
+    IntegratorNode plant("plant", &source);
+    plant.can_save = false;
+    connect(source, plant);
+
+    SpeculativeSeidel executor({&source, &plant});
+
+    double expected = 0.0;
+    for (int i = 0; i < 4; i++)
+    {
+        executor.invoke(StepData(i * 100'000'000ULL, (i + 1) * 100'000'000ULL, 100'000'000ULL));
+        expected += source.output * 0.1;
+    }
+
+    REQUIRE(plant.state == Approx(expected));
+    REQUIRE(plant.restores == 0);
+    REQUIRE(executor.statistics(plant.id).hits == 0);
+    REQUIRE(executor.statistics(plant.id).misses == 0);
+}
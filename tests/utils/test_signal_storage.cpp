@@ -4,7 +4,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
+using ssp4sim::signal::DataEvent;
 using ssp4sim::signal::SignalStorage;
 using ssp4sim::types::DataType;
 
@@ -81,4 +83,196 @@ TEST_CASE("SignalStorage flags new data per area", "[SignalStorage]")
     storage.flag_new_data(area);
 
     REQUIRE(storage.new_data_flags[area]);
+
+    // Flagging again before the recorder took the area queues no second event
+    storage.flag_new_data(area);
+    DataEvent taken;
+    REQUIRE(storage.take_new_data(taken));
+    REQUIRE(taken.area == area);
+    REQUIRE(taken.time == 123);
+    REQUIRE_FALSE(taken.interpolated());
+    REQUIRE_FALSE(storage.new_data_flags[area]);
+    REQUIRE_FALSE(storage.take_new_data(taken));
+
+    storage.flag_new_data(area);
+    REQUIRE(storage.take_new_data(taken));
+}
+
+TEST_CASE("SignalStorage requests a drain when half of the areas wait", "[SignalStorage]")
+{
+    SignalStorage storage(10, "signals");
+    storage.add("signals.value", DataType::integer, 0);
+    storage.allocate();
+
+    int requests = 0;
+    storage.on_backlog = [&]()
+    { requests += 1; };
+
+    for (uint64_t t = 0; t < 4; t++)
+    {
+        storage.flag_new_data(storage.push(t));
+    }
+    REQUIRE(requests == 0);
+
+    storage.flag_new_data(storage.push(4));
+    REQUIRE(requests == 1);
+
+    DataEvent event;
+    while (storage.take_new_data(event))
+    {
+    }
+    storage.flag_new_data(storage.push(5));
+    REQUIRE(requests == 1);
+}
+
+TEST_CASE("SignalStorage counts the events dropped while the recorder falls behind", "[SignalStorage]")
+{
+    SignalStorage storage(2, "signals");
+    storage.add("signals.value", DataType::integer, 0);
+    storage.allocate();
+
+    // Each push reuses an area for a new time, nothing drains the queue
+    for (uint64_t t = 0; t < 100; t++)
+    {
+        storage.flag_new_data(storage.push(t));
+    }
+
+    uint64_t taken = 0;
+    DataEvent event;
+    while (storage.take_new_data(event))
+    {
+        taken += 1;
+    }
+    REQUIRE(taken > 0);
+    REQUIRE(taken + storage.dropped_events == 100);
+}
+
+TEST_CASE("SignalStorage only flags areas on the recording grid", "[SignalStorage]")
+{
+    SignalStorage storage(20, "signals");
+    storage.add("signals.value", DataType::integer, 0);
+    storage.allocate();
+
+    auto post = [&](uint64_t time)
+    {
+        auto area = storage.push(time);
+        storage.flag_new_data(area);
+        return area;
+    };
+
+    DataEvent event;
+    std::vector<uint64_t> recorded;
+
+    storage.set_recording_grid(25, false);
+    for (uint64_t t = 0; t <= 100; t += 10)
+    {
+        post(t);
+    }
+    while (storage.take_new_data(event))
+    {
+        recorded.push_back(event.time);
+    }
+    // 25 and 75 are stepped over, the next area is recorded instead
+    REQUIRE(recorded == std::vector<uint64_t>{0, 30, 50, 80, 100});
+
+    storage.set_recording_grid(25, true);
+    recorded.clear();
+    for (uint64_t t = 110; t <= 160; t += 10)
+    {
+        post(t);
+    }
+    std::vector<bool> interpolated;
+    while (storage.take_new_data(event))
+    {
+        recorded.push_back(event.time);
+        interpolated.push_back(event.interpolated());
+    }
+    REQUIRE(recorded == std::vector<uint64_t>{110, 125, 150});
+    REQUIRE(interpolated == std::vector<bool>{false, true, false});
+}
+
+TEST_CASE("SignalStorage hands rewritten areas to the recorder again", "[SignalStorage]")
+{
+    SignalStorage storage(2, "signals");
+    storage.add("signals.value", DataType::integer, 0);
+    storage.allocate();
+    storage.set_recording_grid(10, false);
+
+    DataEvent event;
+    auto first = storage.push(0);
+    storage.flag_new_data(first);
+    REQUIRE(storage.take_new_data(event));
+
+    // A loop iteration writes the area again at the same time
+    storage.flag_new_data(first);
+    REQUIRE(storage.take_new_data(event));
+    REQUIRE(event.area == first);
+    REQUIRE(event.time == 0);
+    REQUIRE_FALSE(storage.take_new_data(event));
+
+    // Not on the grid, so a rewrite is not recorded either
+    auto second = storage.push(5);
+    storage.flag_new_data(second);
+    storage.flag_new_data(second);
+    REQUIRE_FALSE(storage.take_new_data(event));
+
+    // The ring wraps before the recorder drains, the stale event is followed by the new one
+    auto third = storage.push(10);
+    storage.flag_new_data(third);
+    storage.push(15);
+    auto reused = storage.push(20);
+    storage.flag_new_data(reused);
+    REQUIRE(reused == third);
+
+    REQUIRE(storage.take_new_data(event));
+    REQUIRE(event.area_time == 10);
+    REQUIRE(storage.get_time(event.area) != event.area_time);
+    REQUIRE(storage.take_new_data(event));
+    REQUIRE(event.area_time == 20);
+    REQUIRE(storage.get_time(event.area) == event.area_time);
+}
+
+TEST_CASE("SignalStorage stores array signals contiguously", "[SignalStorage]")
+{
+    SignalStorage storage(2, "signals");
+    const auto array_index = storage.add("signals.array", DataType::real, 0, 4);
+    const auto scalar_index = storage.add("signals.scalar", DataType::real, 1);
+    storage.allocate();
+
+    REQUIRE(storage.variables[array_index].count == 4);
+    REQUIRE(storage.mem_size == 4 * sizeof(double) + 2 * sizeof(double));
+
+    auto area = storage.push(100);
+    auto *array = reinterpret_cast<double *>(storage.get_item(area, array_index));
+    auto *scalar = storage.get_item(area, scalar_index);
+    REQUIRE(scalar - reinterpret_cast<std::byte *>(array) == static_cast<std::ptrdiff_t>(4 * sizeof(double)));
+
+    REQUIRE_THROWS(storage.add("signals.strings", DataType::string, 0, 2));
+}
+
+TEST_CASE("SignalStorage compares and copies area values", "[SignalStorage]")
+{
+    SignalStorage storage(3, "signals");
+    const auto real_index = storage.add("signals.real", DataType::real, 1);
+    const auto mode_index = storage.add("signals.mode", DataType::integer, 0);
+    storage.allocate();
+
+    auto first = storage.push(100);
+    auto second = storage.push(200);
+
+    *reinterpret_cast<double *>(storage.get_item(first, real_index)) = 1.5;
+    *reinterpret_cast<double *>(storage.get_derivative(first, real_index, 1)) = 3.0;
+    *reinterpret_cast<int32_t *>(storage.get_item(first, mode_index)) = 2;
+
+    REQUIRE_FALSE(storage.equal_values(first, second));
+
+    *reinterpret_cast<double *>(storage.get_derivative(second, real_index, 1)) = 7.0;
+    storage.copy_values(first, second);
+    REQUIRE(storage.equal_values(first, second));
+    REQUIRE(*reinterpret_cast<double *>(storage.get_item(second, real_index)) == 1.5);
+    REQUIRE(*reinterpret_cast<int32_t *>(storage.get_item(second, mode_index)) == 2);
+    REQUIRE(*reinterpret_cast<double *>(storage.get_derivative(second, real_index, 1)) == 0.0);
+
+    *reinterpret_cast<int32_t *>(storage.get_item(second, mode_index)) = 3;
+    REQUIRE_FALSE(storage.equal_values(first, second));
 }
@@ -0,0 +1,71 @@
+#include "utils/spsc_queue.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <thread>
+
+using namespace ssp4sim::utils;
+
+TEST_CASE("SpscQueue rounds capacity and rejects when full", "[SpscQueue]")
+{
+    SpscQueue<int> queue(3);
+    REQUIRE(queue.capacity() == 4);
+    REQUIRE(queue.empty());
+
+    for (int i = 0; i < 4; i++)
+    {
+        REQUIRE(queue.try_push(i));
+    }
+    REQUIRE_FALSE(queue.try_push(4));
+
+    int value = -1;
+    REQUIRE(queue.try_pop(value));
+    REQUIRE(value == 0);
+    REQUIRE(queue.try_push(4));
+
+    for (int i = 1; i <= 4; i++)
+    {
+        REQUIRE(queue.try_pop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE_FALSE(queue.try_pop(value));
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("SpscQueue delivers every item in order across threads", "[SpscQueue]")
+{
+    constexpr uint64_t items = 200000;
+
+    SpscQueue<uint64_t> queue(16);
+
+    std::thread producer([&]()
+                         {
+        for (uint64_t i = 1; i <= items; i++)
+        {
+            while (!queue.try_push(i))
+            {
+                std::this_thread::yield();
+            }
+        } });
+
+    uint64_t expected = 1;
+    bool ordered = true;
+    uint64_t value = 0;
+    while (expected <= items)
+    {
+        if (queue.try_pop(value))
+        {
+            ordered = ordered && value == expected;
+            expected += 1;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    REQUIRE(ordered);
+    REQUIRE(queue.empty());
+}
@@ -0,0 +1,99 @@
+#include "execution/step_controller.hpp"
+#include "signal/storage.hpp"
+#include "utils/config.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+
+using ssp4sim::graph::StepController;
+using ssp4sim::signal::SignalStorage;
+using ssp4sim::types::DataType;
+using ssp4sim::utils::Config;
+
+namespace
+{
+    void write_sample(SignalStorage &storage, uint64_t time, double value)
+    {
+        auto area = storage.push(time);
+        *reinterpret_cast<double *>(storage.get_item(area, 0)) = value;
+    }
+}
+
+TEST_CASE("StepController adapts step to extrapolation residual", "[StepController]")
+{
+    Config::loadFromString(R"({
+        "simulation": {
+            "timestep": 0.01,
+            "adaptive_step": {
+                "enable": true,
+                "min_step": 0.001,
+                "max_step": 0.1,
+                "rel_tolerance": 1e-3,
+                "abs_tolerance": 1e-6
+            }
+        }
+    })");
+
+    SignalStorage storage(20, "signals");
+    storage.add("signals.real", DataType::real, 0);
+    storage.add("signals.int", DataType::integer, 0);
+    storage.allocate();
+
+    StepController controller(10'000'000);
+    controller.add_storage(&storage);
+
+    REQUIRE(controller.enabled);
+    REQUIRE(controller.signals.size() == 1);
+    REQUIRE(controller.step == 10'000'000);
+
+    SECTION("Linear signal grows the step to max_step")
+    {
+        uint64_t t = 0;
+        for (int i = 0; i < 10; i++)
+        {
+            t += controller.next_step(t, 10'000'000'000);
+            write_sample(storage, t, 2.0 * static_cast<double>(t) * 1e-9);
+            controller.update(t);
+        }
+        REQUIRE(controller.step == controller.max_step);
+        REQUIRE(controller.violations == 0);
+    }
+
+    SECTION("Transient shrinks the step")
+    {
+        uint64_t t = 0;
+        for (int i = 0; i < 3; i++)
+        {
+            t += controller.next_step(t, 10'000'000'000);
+            write_sample(storage, t, 1.0);
+            controller.update(t);
+        }
+
+        t += controller.next_step(t, 10'000'000'000);
+        write_sample(storage, t, 100.0);
+        controller.update(t);
+
+        REQUIRE(controller.step < 10'000'000);
+        REQUIRE(controller.step >= controller.min_step);
+        REQUIRE(controller.violations == 1);
+    }
+
+    SECTION("Steps never pass the end time")
+    {
+        REQUIRE(controller.next_step(0, 5'000'000) == 5'000'000);
+        REQUIRE(controller.next_step(5'000'000, 5'000'000) == 0);
+    }
+}
+
+TEST_CASE("StepController rejects invalid bounds", "[StepController]")
+{
+    Config::loadFromString(R"({
+        "simulation": {
+            "timestep": 0.01,
+            "adaptive_step": { "enable": true, "min_step": 0.1, "max_step": 0.01 }
+        }
+    })");
+
+    REQUIRE_THROWS(StepController(10'000'000));
+}
@@ -0,0 +1,168 @@
+#include "utils/task_scheduler.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using ssp4sim::utils::Task;
+using ssp4sim::utils::TaskGroup;
+using ssp4sim::utils::TaskScheduler;
+using ssp4sim::utils::WorkStealingDeque;
+
+namespace
+{
+    void noop(void *, std::size_t) {}
+
+    // Spawns two children per level until depth 0, counts the leaves
+    struct Tree
+    {
+        TaskScheduler *scheduler;
+        std::atomic<int> leaves{0};
+
+        static void run(void *context, std::size_t depth)
+        {
+            auto self = static_cast<Tree *>(context);
+            if (depth == 0)
+            {
+                self->leaves.fetch_add(1);
+                return;
+            }
+
+            TaskGroup group;
+            self->scheduler->spawn(group, &Tree::run, self, depth - 1);
+            self->scheduler->spawn(group, &Tree::run, self, depth - 1);
+            self->scheduler->wait(group);
+        }
+    };
+}
+
+TEST_CASE("WorkStealingDeque pops newest and steals oldest", "[TaskScheduler]")
+{
+    WorkStealingDeque deque(3);
+
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        REQUIRE(deque.push(Task{noop, nullptr, i, nullptr}));
+    }
+    REQUIRE_FALSE(deque.push(Task{noop, nullptr, 4, nullptr}));
+
+    Task task;
+    REQUIRE(deque.pop(task));
+    REQUIRE(task.index == 3);
+    REQUIRE(deque.steal(task));
+    REQUIRE(task.index == 0);
+    REQUIRE(deque.pop(task));
+    REQUIRE(task.index == 2);
+    REQUIRE(deque.steal(task));
+    REQUIRE(task.index == 1);
+    REQUIRE_FALSE(deque.pop(task));
+    REQUIRE_FALSE(deque.steal(task));
+    REQUIRE(deque.empty());
+}
+
+TEST_CASE("WorkStealingDeque hands out every task once under stealing", "[TaskScheduler]")
+{
+    constexpr std::size_t tasks = 20'000;
+    WorkStealingDeque deque(64);
+    std::vector<std::atomic<int>> seen(tasks);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; t++)
+    {
+        thieves.emplace_back([&]()
+                             {
+                                 Task task;
+                                 while (!done.load() || !deque.empty())
+                                 {
+                                     if (deque.steal(task))
+                                     {
+                                         seen[task.index].fetch_add(1);
+                                     }
+                                 } });
+    }
+
+    Task task;
+    for (std::size_t i = 0; i < tasks; i++)
+    {
+        while (!deque.push(Task{noop, nullptr, i, nullptr}))
+        {
+            if (deque.pop(task))
+            {
+                seen[task.index].fetch_add(1);
+            }
+        }
+        if (i % 3 == 0 && deque.pop(task))
+        {
+            seen[task.index].fetch_add(1);
+        }
+    }
+    while (deque.pop(task))
+    {
+        seen[task.index].fetch_add(1);
+    }
+    done = true;
+    for (auto &t : thieves)
+    {
+        t.join();
+    }
+
+    for (auto &s : seen)
+    {
+        REQUIRE(s == 1);
+    }
+}
+
+TEST_CASE("TaskScheduler runs parallel_for and nested groups", "[TaskScheduler]")
+{
+    TaskScheduler scheduler(3, {64, 2});
+
+    std::vector<int> values(1000, 0);
+    auto body = [&](std::size_t i)
+    { values[i] = static_cast<int>(i); };
+
+    for (int round = 0; round < 20; round++)
+    {
+        scheduler.parallel_for(values.size(), body);
+        for (std::size_t i = 0; i < values.size(); i++)
+        {
+            REQUIRE(values[i] == static_cast<int>(i));
+        }
+        values.assign(values.size(), 0);
+    }
+
+    Tree tree{&scheduler};
+    TaskGroup group;
+    scheduler.spawn(group, &Tree::run, &tree, 10);
+    scheduler.wait(group);
+    REQUIRE(tree.leaves == 1024);
+}
+
+TEST_CASE("TaskScheduler rethrows the first exception of a group", "[TaskScheduler]")
+{
+    TaskScheduler scheduler(2);
+
+    std::atomic<int> ran{0};
+    auto body = [&](std::size_t i)
+    {
+        ran.fetch_add(1);
+        if (i == 5)
+        {
+            throw std::runtime_error("task failed");
+        }
+    };
+
+    REQUIRE_THROWS_AS(scheduler.parallel_for(10, body), std::runtime_error);
+    REQUIRE(ran == 10);
+
+    // The scheduler keeps working after an exception has been rethrown
+    ran = 0;
+    auto fine = [&](std::size_t)
+    { ran.fetch_add(1); };
+    scheduler.parallel_for(10, fine);
+    REQUIRE(ran == 10);
+}
@@ -1,14 +1,18 @@
 #include "utils/task_thread_pool.hpp"
+#include "utils/task_thread_pool2.hpp"
+#include "test_nodes.hpp"
 
 #include <atomic>
 #include <chrono>
 #include <future>
 #include <iostream>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
 #include <catch.hpp>
 
+using ssp4sim::test::TestNode;
 using ssp4sim::utils::ThreadPool;
 
 TEST_CASE("ThreadPool executes simple tasks", "[threadpool]")
@@ -72,3 +76,39 @@ TEST_CASE("ThreadPool can handle tasks with delay", "[threadpool]")
     // }
     REQUIRE(f.get() == 7);
 }
+
+TEST_CASE("ThreadPool2 runs every batch to completion", "[threadpool]")
+{
+    using ssp4sim::utils::task_info;
+    using ssp4sim::utils::ThreadPool2;
+
+    // Capacity below the batch size makes the caller run tasks while enqueueing
+    ThreadPool2 pool(3, 4, {16, 1});
+    std::vector<TestNode> nodes(10);
+
+    for (int batch = 0; batch < 200; batch++)
+    {
+        pool.ready(nodes.size());
+        for (auto &node : nodes)
+        {
+            pool.enqueue(task_info{&node, ssp4sim::graph::StepData(0, 1, 1)});
+        }
+        pool.wait();
+
+        for (auto &node : nodes)
+        {
+            REQUIRE(node.invocations == batch + 1);
+        }
+    }
+
+    nodes[3].on_invoke = [](const ssp4sim::graph::StepData &)
+    {
+        throw std::runtime_error("failing node");
+    };
+    pool.ready(nodes.size());
+    for (auto &node : nodes)
+    {
+        pool.enqueue(task_info{&node, ssp4sim::graph::StepData(0, 1, 1)});
+    }
+    REQUIRE_THROWS_AS(pool.wait(), std::runtime_error);
+}